@@ -0,0 +1,76 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include "os/mynewt.h"
+#include "osbench.h"
+
+#ifdef ARCH_sim
+#include <mcu/mcu_sim.h>
+#endif
+
+#define OSBENCH_TASK_PRIO       MYNEWT_VAL(OSBENCH_TASK_PRIO)
+#define OSBENCH_TASK_STACK_SIZE OS_STACK_ALIGN(512)
+
+static struct os_task osbench_task;
+static os_stack_t osbench_stack[OSBENCH_TASK_STACK_SIZE];
+
+static void
+osbench_task_handler(void *arg)
+{
+    /* Give the console a moment to come up before reporting. */
+    os_time_delay(OS_TICKS_PER_SEC);
+
+    osbench_run();
+
+    while (1) {
+        os_time_delay(OS_TIMEOUT_NEVER);
+    }
+}
+
+/**
+ * main
+ *
+ * Starts the benchmark task, then serves the default event queue.  The
+ * results are written to the console as a single line of JSON.
+ *
+ * @return int NOTE: this function should never return!
+ */
+int
+main(int argc, char **argv)
+{
+    int rc;
+
+#ifdef ARCH_sim
+    mcu_sim_parse_args(argc, argv);
+#endif
+
+    sysinit();
+
+    rc = os_task_init(&osbench_task, "osbench", osbench_task_handler, NULL,
+                      OSBENCH_TASK_PRIO, OS_WAIT_FOREVER, osbench_stack,
+                      OSBENCH_TASK_STACK_SIZE);
+    assert(rc == 0);
+
+    while (1) {
+        os_eventq_run(os_eventq_dflt_get());
+    }
+    /* Never exit */
+    return rc;
+}
@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "console/console.h"
+#include "json/json.h"
+#include "osbench.h"
+
+#ifdef ARCH_sim
+#include <time.h>
+
+#define OSBENCH_CLOCK_NAME  "monotonic"
+#define OSBENCH_CLOCK_HZ    1000000000
+#else
+#define OSBENCH_CLOCK_NAME  "cputime"
+#define OSBENCH_CLOCK_HZ    MYNEWT_VAL(OS_CPUTIME_FREQ)
+#endif
+
+/* Clock ticks taken by each operation of the current benchmark */
+static uint32_t osbench_samples[OSBENCH_ITERS];
+static int osbench_num_samples;
+
+static struct json_encoder osbench_encoder;
+
+uint32_t
+osbench_now(void)
+{
+#ifdef ARCH_sim
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+#else
+    return os_cputime_get32();
+#endif
+}
+
+void
+osbench_sample(uint32_t start, uint32_t end)
+{
+    if (osbench_num_samples < OSBENCH_ITERS) {
+        osbench_samples[osbench_num_samples++] = end - start;
+    }
+}
+
+static uint64_t
+osbench_ticks_to_ns(uint64_t ticks)
+{
+    return ticks * 1000000000 / OSBENCH_CLOCK_HZ;
+}
+
+static int
+osbench_sample_cmp(const void *a, const void *b)
+{
+    uint32_t sa;
+    uint32_t sb;
+
+    sa = *(const uint32_t *)a;
+    sb = *(const uint32_t *)b;
+    if (sa < sb) {
+        return -1;
+    }
+    return sa > sb;
+}
+
+/* The sample below which the given percentage of samples fall */
+static uint32_t
+osbench_percentile(int pct)
+{
+    return osbench_samples[(osbench_num_samples - 1) * pct / 100];
+}
+
+static void
+osbench_encode_ns(char *key, uint64_t ticks)
+{
+    struct json_value jv;
+
+    JSON_VALUE_UINT(&jv, osbench_ticks_to_ns(ticks));
+    json_encode_object_entry(&osbench_encoder, key, &jv);
+}
+
+static void
+osbench_report_entry(char *name, int n)
+{
+    struct json_value jv;
+    uint64_t total;
+    int i;
+
+    if (osbench_num_samples == 0) {
+        return;
+    }
+
+    qsort(osbench_samples, osbench_num_samples, sizeof osbench_samples[0],
+          osbench_sample_cmp);
+
+    total = 0;
+    for (i = 0; i < osbench_num_samples; i++) {
+        total += osbench_samples[i];
+    }
+
+    json_encode_object_start(&osbench_encoder);
+    JSON_VALUE_STRING(&jv, name);
+    json_encode_object_entry(&osbench_encoder, "name", &jv);
+    if (n >= 0) {
+        JSON_VALUE_UINT(&jv, n);
+        json_encode_object_entry(&osbench_encoder, "n", &jv);
+    }
+    JSON_VALUE_UINT(&jv, osbench_num_samples);
+    json_encode_object_entry(&osbench_encoder, "ops", &jv);
+    osbench_encode_ns("ns_per_op", total / osbench_num_samples);
+    osbench_encode_ns("min", osbench_samples[0]);
+    osbench_encode_ns("p50", osbench_percentile(50));
+    osbench_encode_ns("p90", osbench_percentile(90));
+    osbench_encode_ns("p99", osbench_percentile(99));
+    osbench_encode_ns("max", osbench_samples[osbench_num_samples - 1]);
+    json_encode_object_finish(&osbench_encoder);
+
+    osbench_num_samples = 0;
+}
+
+void
+osbench_report(char *name)
+{
+    osbench_report_entry(name, -1);
+}
+
+void
+osbench_report_n(char *name, int n)
+{
+    osbench_report_entry(name, n);
+}
+
+static int
+osbench_write(void *arg, char *data, int len)
+{
+    console_write(data, len);
+    return 0;
+}
+
+void
+osbench_report_start(void)
+{
+    struct json_value jv;
+
+    memset(&osbench_encoder, 0, sizeof osbench_encoder);
+    osbench_encoder.je_write = osbench_write;
+
+    json_encode_object_start(&osbench_encoder);
+    JSON_VALUE_STRING(&jv, OSBENCH_CLOCK_NAME);
+    json_encode_object_entry(&osbench_encoder, "clock", &jv);
+    JSON_VALUE_UINT(&jv, OSBENCH_CLOCK_HZ);
+    json_encode_object_entry(&osbench_encoder, "clock_hz", &jv);
+
+    /* Kernel options that change what is being measured */
+    JSON_VALUE_UINT(&jv, MYNEWT_VAL(OS_SCHED_BITMAP));
+    json_encode_object_entry(&osbench_encoder, "os_sched_bitmap", &jv);
+    JSON_VALUE_UINT(&jv, MYNEWT_VAL(OS_CALLOUT_WHEEL));
+    json_encode_object_entry(&osbench_encoder, "os_callout_wheel", &jv);
+    JSON_VALUE_UINT(&jv, MYNEWT_VAL(OS_SCHED_SLEEP_HEAP));
+    json_encode_object_entry(&osbench_encoder, "os_sched_sleep_heap", &jv);
+
+    json_encode_array_name(&osbench_encoder, "results");
+    json_encode_array_start(&osbench_encoder);
+}
+
+void
+osbench_report_finish(void)
+{
+    json_encode_array_finish(&osbench_encoder);
+    json_encode_object_finish(&osbench_encoder);
+    console_write("\n", 1);
+}
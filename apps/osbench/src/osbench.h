@@ -0,0 +1,82 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_OSBENCH_
+#define H_OSBENCH_
+
+#include <inttypes.h>
+#include "os/mynewt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OSBENCH_ITERS   MYNEWT_VAL(OSBENCH_ITERS)
+
+/**
+ * Reads the benchmark clock.  This is os_cputime on hardware and the host's
+ * monotonic clock on sim, where cputime only advances once per OS tick.
+ */
+uint32_t osbench_now(void);
+
+/**
+ * Records one timed operation which started and ended at the given clock
+ * readings.  Samples beyond OSBENCH_ITERS are dropped.
+ */
+void osbench_sample(uint32_t start, uint32_t end);
+
+/**
+ * Writes the distribution of the samples recorded since the last report as
+ * one entry of the results array, then discards the samples.
+ */
+void osbench_report(char *name);
+
+/**
+ * Like osbench_report(), for one point of a benchmark swept over a
+ * parameter; n, e.g. the number of tasks, is written next to the name.
+ */
+void osbench_report_n(char *name, int n);
+
+/** Starts the JSON document which the reports are written into. */
+void osbench_report_start(void);
+
+/** Finishes the JSON document. */
+void osbench_report_finish(void);
+
+/** Runs every benchmark, reporting each one. */
+void osbench_run(void);
+
+#if MYNEWT_VAL(OSBENCH_FCB)
+/** Measures FCB appends to OSBENCH_FCB_FLASH_AREA, erasing it first. */
+void osbench_fcb_append(void);
+
+/** Measures FCB walks over OSBENCH_FCB_FLASH_AREA, erasing it first. */
+void osbench_fcb_walk(void);
+#endif
+
+#if MYNEWT_VAL(OSBENCH_TLSF)
+/** Measures TLSF heap allocations and frees. */
+void osbench_tlsf(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
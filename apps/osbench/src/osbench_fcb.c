@@ -0,0 +1,234 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * FCB append and walk throughput.  The FCB fills a flash area, which on
+ * sim is the native flash simulation.  Each sample is one full pass over
+ * the FCB divided by the number of entries written or read, so
+ * ns_per_op is the cost of one entry.  Appends are measured both one at
+ * a time and through an fcb_batch.  Building with CRC8_FULL_TABLE shows
+ * the effect of the faster CRC8 on the checked walk.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "osbench.h"
+
+#if MYNEWT_VAL(OSBENCH_FCB)
+
+#include "flash_map/flash_map.h"
+#include "fcb/fcb.h"
+
+#define OSBENCH_FCB_MAX_SECTORS 32
+#define OSBENCH_FCB_ENTRY_LEN   MYNEWT_VAL(OSBENCH_FCB_ENTRY_LEN)
+#define OSBENCH_FCB_WALKS       32
+#define OSBENCH_FCB_FILLS       8
+#define OSBENCH_FCB_BATCH_SIZE  512
+
+static struct flash_area osbench_fcb_sectors[OSBENCH_FCB_MAX_SECTORS];
+static struct fcb osbench_fcb;
+static uint8_t osbench_fcb_batch_buf[OSBENCH_FCB_BATCH_SIZE];
+
+/**
+ * Erases the flash area and sets up an empty FCB in it.  Returns the
+ * number of sectors, or -1 if the area is too small for an FCB.
+ */
+static int
+osbench_fcb_setup(void)
+{
+    int sec_id;
+    int cnt;
+    int rc;
+    int i;
+
+    sec_id = -1;
+    cnt = 0;
+    while (cnt < OSBENCH_FCB_MAX_SECTORS &&
+           flash_area_getnext_sector(MYNEWT_VAL(OSBENCH_FCB_FLASH_AREA),
+                                     &sec_id,
+                                     &osbench_fcb_sectors[cnt]) == 0) {
+        cnt++;
+    }
+    if (cnt < 2) {
+        return -1;
+    }
+
+    for (i = 0; i < cnt; i++) {
+        rc = flash_area_erase(&osbench_fcb_sectors[i], 0,
+                              osbench_fcb_sectors[i].fa_size);
+        assert(rc == 0);
+    }
+
+    memset(&osbench_fcb, 0, sizeof osbench_fcb);
+    osbench_fcb.f_magic = 0x0be4c4b0;
+    osbench_fcb.f_sectors = osbench_fcb_sectors;
+    osbench_fcb.f_sector_cnt = cnt;
+    rc = fcb_init(&osbench_fcb);
+    assert(rc == 0);
+
+    return cnt;
+}
+
+/** Appends entries one at a time until the FCB is full. */
+static int
+osbench_fcb_fill(void)
+{
+    struct fcb_entry loc;
+    int cnt;
+    int rc;
+    int i;
+
+    cnt = 0;
+    while (fcb_append(&osbench_fcb, OSBENCH_FCB_ENTRY_LEN, &loc) == 0) {
+        for (i = 0; i < OSBENCH_FCB_ENTRY_LEN; i += sizeof cnt) {
+            flash_area_write(loc.fe_area, loc.fe_data_off + i, &cnt,
+                             min(sizeof cnt, OSBENCH_FCB_ENTRY_LEN - i));
+        }
+        rc = fcb_append_finish(&osbench_fcb, &loc);
+        assert(rc == 0);
+        cnt++;
+    }
+
+    return cnt;
+}
+
+/** Appends entries through a batch until the FCB is full. */
+static int
+osbench_fcb_fill_batch(void)
+{
+    struct fcb_batch fb;
+    uint8_t *data;
+    int cnt;
+    int i;
+
+    fcb_batch_init(&fb, osbench_fcb_batch_buf, sizeof osbench_fcb_batch_buf);
+
+    cnt = 0;
+    while (1) {
+        data = fcb_batch_reserve(&osbench_fcb, &fb, OSBENCH_FCB_ENTRY_LEN);
+        if (data == NULL) {
+            if (fcb_batch_commit(&osbench_fcb, &fb) != 0) {
+                break;
+            }
+            continue;
+        }
+        for (i = 0; i < OSBENCH_FCB_ENTRY_LEN; i += sizeof cnt) {
+            memcpy(data + i, &cnt, min(sizeof cnt, OSBENCH_FCB_ENTRY_LEN - i));
+        }
+        cnt++;
+    }
+
+    /* Entries left in the batch when the FCB filled up were not written. */
+    return cnt - fb.fb_entries;
+}
+
+static void
+osbench_fcb_fill_one(int batch)
+{
+    uint32_t start;
+    int entries;
+
+    if (osbench_fcb_setup() < 0) {
+        return;
+    }
+
+    start = osbench_now();
+    if (batch) {
+        entries = osbench_fcb_fill_batch();
+    } else {
+        entries = osbench_fcb_fill();
+    }
+    assert(entries > 0);
+    osbench_sample(0, (osbench_now() - start) / entries);
+}
+
+void
+osbench_fcb_append(void)
+{
+    int i;
+
+    if (osbench_fcb_setup() < 0) {
+        return;
+    }
+
+    for (i = 0; i < OSBENCH_FCB_FILLS; i++) {
+        osbench_fcb_fill_one(0);
+    }
+    osbench_report("fcb_append_entry");
+
+    for (i = 0; i < OSBENCH_FCB_FILLS; i++) {
+        osbench_fcb_fill_one(1);
+    }
+    osbench_report("fcb_batch_entry");
+}
+
+static int
+osbench_fcb_walk_cb(struct fcb_entry *loc, void *arg)
+{
+    (*(int *)arg)++;
+    return 0;
+}
+
+static void
+osbench_fcb_walk_one(int trusted)
+{
+    uint32_t start;
+    int entries;
+    int rc;
+
+    entries = 0;
+    start = osbench_now();
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    if (trusted) {
+        rc = fcb_walk_trusted(&osbench_fcb, NULL, osbench_fcb_walk_cb,
+                              &entries);
+    } else
+#endif
+    {
+        rc = fcb_walk(&osbench_fcb, NULL, osbench_fcb_walk_cb, &entries);
+    }
+    assert(rc == 0 && entries > 0);
+    osbench_sample(0, (osbench_now() - start) / entries);
+}
+
+void
+osbench_fcb_walk(void)
+{
+    int i;
+
+    if (osbench_fcb_setup() < 0 || osbench_fcb_fill() <= 0) {
+        return;
+    }
+
+    for (i = 0; i < OSBENCH_FCB_WALKS; i++) {
+        osbench_fcb_walk_one(0);
+    }
+    osbench_report("fcb_walk_entry");
+
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    /* Every sector but the active one was verified by the walks above. */
+    for (i = 0; i < OSBENCH_FCB_WALKS; i++) {
+        osbench_fcb_walk_one(1);
+    }
+    osbench_report("fcb_walk_trusted_entry");
+#endif
+}
+
+#endif
@@ -0,0 +1,890 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * The handoff benchmarks time how long it takes a higher priority peer task
+ * to run after the benchmark task unblocks it.  The peer reads the clock as
+ * soon as it resumes; the benchmark task picks that reading up when the peer
+ * blocks again.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "spsc_ring/spsc_ring.h"
+#include "osbench.h"
+
+#define OSBENCH_PEER_PRIO       (MYNEWT_VAL(OSBENCH_TASK_PRIO) - 1)
+#define OSBENCH_PEER_STACK_SIZE OS_STACK_ALIGN(256)
+
+#define OSBENCH_BLOCK_SIZE      32
+#define OSBENCH_BLOCK_COUNT     64
+
+#define OSBENCH_FILLER_PRIO     (MYNEWT_VAL(OSBENCH_TASK_PRIO) + 1)
+#define OSBENCH_FILLER_STACK_SIZE   OS_STACK_ALIGN(64)
+
+#define OSBENCH_MBUF_BUF_SIZE   128
+#define OSBENCH_MBUF_COUNT      16
+#define OSBENCH_MBUF_DATA_LEN   200
+
+#define OSBENCH_RING_SIZE       256
+#define OSBENCH_RING_CHUNK      64
+
+/* Pools of 1, 2 and 4 workers */
+#define OSBENCH_POOLS           3
+#define OSBENCH_WORKERS         7
+#define OSBENCH_WORKER_STACK_SIZE   OS_STACK_ALIGN(256)
+#define OSBENCH_WORK_BATCH      16
+/* Passes over osbench_data made by each work item */
+#define OSBENCH_WORK_ROUNDS     8
+
+static struct os_task osbench_peer_task;
+static os_stack_t osbench_peer_stack[OSBENCH_PEER_STACK_SIZE];
+static struct os_sem osbench_peer_go;
+static void (*osbench_peer_fn)(void);
+static volatile uint32_t osbench_peer_time;
+
+static struct os_task osbench_fillers[MYNEWT_VAL(OSBENCH_SCHED_TASKS)];
+static os_stack_t osbench_filler_stacks[MYNEWT_VAL(OSBENCH_SCHED_TASKS)]
+                                       [OSBENCH_FILLER_STACK_SIZE];
+
+static struct os_sem osbench_sem;
+static struct os_mutex osbench_mutex;
+static struct os_eventq osbench_evq;
+static struct os_event osbench_ev;
+static struct os_callout osbench_callouts[MYNEWT_VAL(OSBENCH_CALLOUTS)];
+
+static struct os_mempool osbench_pool;
+static os_membuf_t osbench_pool_buf[
+    OS_MEMPOOL_SIZE(OSBENCH_BLOCK_COUNT, OSBENCH_BLOCK_SIZE)];
+static void *osbench_blocks[OSBENCH_BLOCK_COUNT];
+
+static struct os_mempool osbench_mbuf_mempool;
+static struct os_mbuf_pool osbench_mbuf_pool;
+static os_membuf_t osbench_mbuf_buf[
+    OS_MEMPOOL_SIZE(OSBENCH_MBUF_COUNT, OSBENCH_MBUF_BUF_SIZE)];
+static uint8_t osbench_data[OSBENCH_MBUF_DATA_LEN];
+static uint8_t osbench_flat[OSBENCH_MBUF_DATA_LEN];
+static volatile uint32_t osbench_sum;
+
+static struct spsc_ring osbench_ring;
+static uint8_t osbench_ring_buf[OSBENCH_RING_SIZE];
+
+static struct os_workq osbench_wqs[OSBENCH_POOLS];
+static struct os_workq_worker osbench_workers[OSBENCH_WORKERS];
+static os_stack_t osbench_worker_stacks[OSBENCH_WORKERS]
+                                       [OSBENCH_WORKER_STACK_SIZE];
+static struct os_eventq osbench_work_evq;
+static struct os_work osbench_work[OSBENCH_WORK_BATCH];
+static int osbench_work_done;
+
+static void
+osbench_peer_handler(void *arg)
+{
+    while (1) {
+        os_sem_pend(&osbench_peer_go, OS_TIMEOUT_NEVER);
+        osbench_peer_fn();
+    }
+}
+
+/**
+ * Runs the peer side of a handoff benchmark.  The peer preempts the caller
+ * straight away, so this returns once the peer first blocks.
+ */
+static void
+osbench_peer_start(void (*fn)(void))
+{
+    osbench_peer_fn = fn;
+    os_sem_release(&osbench_peer_go);
+}
+
+static void
+osbench_clock(void)
+{
+    uint32_t start;
+    int i;
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        osbench_sample(start, osbench_now());
+    }
+    osbench_report("clock_overhead");
+}
+
+static void
+osbench_ctx_sw_peer(void)
+{
+    os_sr_t sr;
+    int i;
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        OS_ENTER_CRITICAL(sr);
+        os_sched_sleep(&osbench_peer_task, OS_TIMEOUT_NEVER);
+        OS_EXIT_CRITICAL(sr);
+        os_sched(NULL);
+        osbench_peer_time = osbench_now();
+    }
+}
+
+/* A bare switch to a higher priority task made ready by the scheduler. */
+static void
+osbench_ctx_sw(void)
+{
+    uint32_t start;
+    os_sr_t sr;
+    int i;
+
+    osbench_peer_start(osbench_ctx_sw_peer);
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        OS_ENTER_CRITICAL(sr);
+        os_sched_wakeup(&osbench_peer_task);
+        OS_EXIT_CRITICAL(sr);
+        os_sched(NULL);
+        osbench_sample(start, osbench_peer_time);
+    }
+    osbench_report("ctx_switch");
+}
+
+static void
+osbench_filler_handler(void *arg)
+{
+    while (1) {
+        os_time_delay(OS_TIMEOUT_NEVER);
+    }
+}
+
+/* Numbers of filler tasks the scheduler benchmarks are run with */
+static const int osbench_sched_counts[] = { 2, 8, 32 };
+#define OSBENCH_NUM_SCHED_COUNTS \
+    (int)(sizeof osbench_sched_counts / sizeof osbench_sched_counts[0])
+
+/* Starts n filler tasks; they are ready, but below the benchmark task. */
+static void
+osbench_fillers_start(int n)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        rc = os_task_init(&osbench_fillers[i], "osbench_filler",
+                          osbench_filler_handler, NULL,
+                          OSBENCH_FILLER_PRIO + i, OS_WAIT_FOREVER,
+                          osbench_filler_stacks[i], OSBENCH_FILLER_STACK_SIZE);
+        assert(rc == 0);
+    }
+}
+
+static void
+osbench_fillers_stop(int n)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        rc = os_task_remove(&osbench_fillers[i]);
+        assert(rc == 0);
+    }
+}
+
+/*
+ * Making the lowest priority of n ready tasks sleep and ready again, then
+ * picking the next task; i.e. what every timed wakeup costs with interrupts
+ * disabled.  The fillers never get to run.
+ */
+static void
+osbench_sched_wakeup_n(int n)
+{
+    struct os_task *t;
+    uint32_t start;
+    os_sr_t sr;
+    int i;
+
+    osbench_fillers_start(n);
+
+    t = &osbench_fillers[n - 1];
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        OS_ENTER_CRITICAL(sr);
+        start = osbench_now();
+        os_sched_sleep(t, OS_TIMEOUT_NEVER);
+        os_sched_wakeup(t);
+        os_sched_next_task();
+        osbench_sample(start, osbench_now());
+        OS_EXIT_CRITICAL(sr);
+    }
+    osbench_report_n("sched_wakeup", n);
+
+    osbench_fillers_stop(n);
+}
+
+static void
+osbench_sched_wakeup(void)
+{
+    int i;
+
+    for (i = 0; i < OSBENCH_NUM_SCHED_COUNTS; i++) {
+        if (osbench_sched_counts[i] <= MYNEWT_VAL(OSBENCH_SCHED_TASKS)) {
+            osbench_sched_wakeup_n(osbench_sched_counts[i]);
+        }
+    }
+}
+
+/* Puts all but the last of n started fillers to sleep for over a minute. */
+static void
+osbench_fillers_sleep(int n)
+{
+    os_sr_t sr;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < n - 1; i++) {
+        os_sched_sleep(&osbench_fillers[i],
+                       OS_TICKS_PER_SEC * 60 + (i * 37) % OS_TICKS_PER_SEC);
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+
+/*
+ * Putting a task to sleep and waking it up again, i.e. what every timed
+ * pend costs, while n - 1 fillers sleep with scattered timeouts.  The probe
+ * sleeps longest, which is the worst case for a sorted sleep list.
+ */
+static void
+osbench_sched_sleep_n(int n)
+{
+    struct os_task *t;
+    uint32_t start;
+    os_sr_t sr;
+    int i;
+
+    osbench_fillers_start(n);
+    osbench_fillers_sleep(n);
+
+    t = &osbench_fillers[n - 1];
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        OS_ENTER_CRITICAL(sr);
+        start = osbench_now();
+        os_sched_sleep(t, OS_TICKS_PER_SEC * 61);
+        os_sched_wakeup(t);
+        osbench_sample(start, osbench_now());
+        OS_EXIT_CRITICAL(sr);
+    }
+    osbench_report_n("sched_sleep", n);
+
+    osbench_fillers_stop(n);
+}
+
+/*
+ * A tick which wakes one task, i.e. os_sched_os_timer_exp() taking the
+ * probe off the sleep queue while n - 1 fillers stay asleep behind it.
+ */
+static void
+osbench_sched_tick_n(int n)
+{
+    struct os_task *t;
+    uint32_t start;
+    os_sr_t sr;
+    int i;
+
+    osbench_fillers_start(n);
+    osbench_fillers_sleep(n);
+
+    t = &osbench_fillers[n - 1];
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        OS_ENTER_CRITICAL(sr);
+        os_sched_sleep(t, 0);
+        start = osbench_now();
+        os_sched_os_timer_exp();
+        osbench_sample(start, osbench_now());
+        assert(t->t_state == OS_TASK_READY);
+        OS_EXIT_CRITICAL(sr);
+    }
+    osbench_report_n("sched_tick", n);
+
+    osbench_fillers_stop(n);
+}
+
+static void
+osbench_sched_sleep(void)
+{
+    int i;
+
+    for (i = 0; i < OSBENCH_NUM_SCHED_COUNTS; i++) {
+        if (osbench_sched_counts[i] <= MYNEWT_VAL(OSBENCH_SCHED_TASKS)) {
+            osbench_sched_sleep_n(osbench_sched_counts[i]);
+            osbench_sched_tick_n(osbench_sched_counts[i]);
+        }
+    }
+}
+
+static void
+osbench_sem_peer(void)
+{
+    int i;
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        os_sem_pend(&osbench_sem, OS_TIMEOUT_NEVER);
+        osbench_peer_time = osbench_now();
+    }
+}
+
+static void
+osbench_sem_handoff(void)
+{
+    uint32_t start;
+    int i;
+
+    os_sem_init(&osbench_sem, 0);
+    osbench_peer_start(osbench_sem_peer);
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        os_sem_release(&osbench_sem);
+        osbench_sample(start, osbench_peer_time);
+    }
+    osbench_report("sem_handoff");
+}
+
+static void
+osbench_mutex_peer(void)
+{
+    int i;
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        os_sem_pend(&osbench_sem, OS_TIMEOUT_NEVER);
+        os_mutex_pend(&osbench_mutex, OS_TIMEOUT_NEVER);
+        osbench_peer_time = osbench_now();
+        os_mutex_release(&osbench_mutex);
+    }
+}
+
+/*
+ * Release of a mutex the peer is waiting on.  The release also undoes the
+ * priority inheritance the waiting peer caused.
+ */
+static void
+osbench_mutex_handoff(void)
+{
+    uint32_t start;
+    int i;
+
+    os_sem_init(&osbench_sem, 0);
+    os_mutex_init(&osbench_mutex);
+    osbench_peer_start(osbench_mutex_peer);
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        os_mutex_pend(&osbench_mutex, OS_TIMEOUT_NEVER);
+        /* Let the peer block on the mutex. */
+        os_sem_release(&osbench_sem);
+
+        start = osbench_now();
+        os_mutex_release(&osbench_mutex);
+        osbench_sample(start, osbench_peer_time);
+    }
+    osbench_report("mutex_handoff");
+}
+
+static void
+osbench_eventq_peer(void)
+{
+    int i;
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        os_eventq_get(&osbench_evq);
+        osbench_peer_time = osbench_now();
+    }
+}
+
+static void
+osbench_eventq(void)
+{
+    uint32_t start;
+    int i;
+
+    os_eventq_init(&osbench_evq);
+    memset(&osbench_ev, 0, sizeof osbench_ev);
+    osbench_peer_start(osbench_eventq_peer);
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        os_eventq_put(&osbench_evq, &osbench_ev);
+        osbench_sample(start, osbench_peer_time);
+    }
+    osbench_report("eventq_put_get");
+}
+
+/* Burst sizes the batch mempool calls are timed with */
+static const int osbench_bursts[] = { 1, 4, 16, 64 };
+#define OSBENCH_NUM_BURSTS \
+    (int)(sizeof osbench_bursts / sizeof osbench_bursts[0])
+
+/*
+ * Getting and putting a burst of n blocks with one os_memblock_get() or
+ * os_memblock_put() call per block, against a single os_memblock_get_n()
+ * or os_memblock_put_n() call.
+ */
+static void
+osbench_mempool_burst(int n)
+{
+    uint32_t start;
+    int rc;
+    int i;
+    int j;
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        for (j = 0; j < n; j++) {
+            osbench_blocks[j] = os_memblock_get(&osbench_pool);
+        }
+        osbench_sample(start, osbench_now());
+        for (j = 0; j < n; j++) {
+            os_memblock_put(&osbench_pool, osbench_blocks[j]);
+        }
+    }
+    osbench_report_n("mempool_get_burst", n);
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        rc = os_memblock_get_n(&osbench_pool, osbench_blocks, n);
+        osbench_sample(start, osbench_now());
+        assert(rc == n);
+        os_memblock_put_n(&osbench_pool, osbench_blocks, n);
+    }
+    osbench_report_n("mempool_get_n", n);
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        for (j = 0; j < n; j++) {
+            osbench_blocks[j] = os_memblock_get(&osbench_pool);
+        }
+        start = osbench_now();
+        for (j = 0; j < n; j++) {
+            os_memblock_put(&osbench_pool, osbench_blocks[j]);
+        }
+        osbench_sample(start, osbench_now());
+    }
+    osbench_report_n("mempool_put_burst", n);
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        rc = os_memblock_get_n(&osbench_pool, osbench_blocks, n);
+        assert(rc == n);
+        start = osbench_now();
+        os_memblock_put_n(&osbench_pool, osbench_blocks, n);
+        osbench_sample(start, osbench_now());
+    }
+    osbench_report_n("mempool_put_n", n);
+}
+
+static void
+osbench_mempool(void)
+{
+    uint32_t start;
+    int rc;
+    int i;
+    int j;
+
+    rc = os_mempool_init(&osbench_pool, OSBENCH_BLOCK_COUNT,
+                         OSBENCH_BLOCK_SIZE, osbench_pool_buf, "osbench");
+    assert(rc == 0);
+
+    for (i = 0; i < OSBENCH_ITERS; i += OSBENCH_BLOCK_COUNT) {
+        for (j = 0; j < OSBENCH_BLOCK_COUNT; j++) {
+            start = osbench_now();
+            osbench_blocks[j] = os_memblock_get(&osbench_pool);
+            osbench_sample(start, osbench_now());
+        }
+        for (j = 0; j < OSBENCH_BLOCK_COUNT; j++) {
+            os_memblock_put(&osbench_pool, osbench_blocks[j]);
+        }
+    }
+    osbench_report("mempool_get");
+
+    for (i = 0; i < OSBENCH_ITERS; i += OSBENCH_BLOCK_COUNT) {
+        for (j = 0; j < OSBENCH_BLOCK_COUNT; j++) {
+            osbench_blocks[j] = os_memblock_get(&osbench_pool);
+        }
+        for (j = 0; j < OSBENCH_BLOCK_COUNT; j++) {
+            start = osbench_now();
+            os_memblock_put(&osbench_pool, osbench_blocks[j]);
+            osbench_sample(start, osbench_now());
+        }
+    }
+    osbench_report("mempool_put");
+
+    for (i = 0; i < OSBENCH_NUM_BURSTS; i++) {
+        osbench_mempool_burst(osbench_bursts[i]);
+    }
+}
+
+/* A packet header mbuf holding OSBENCH_MBUF_DATA_LEN bytes over two mbufs */
+static struct os_mbuf *
+osbench_mbuf_chain(void)
+{
+    struct os_mbuf *om;
+    int rc;
+
+    om = os_mbuf_get_pkthdr(&osbench_mbuf_pool, 0);
+    assert(om != NULL);
+    rc = os_mbuf_append(om, osbench_data, sizeof osbench_data);
+    assert(rc == 0);
+
+    return om;
+}
+
+static uint32_t
+osbench_byte_sum(const uint8_t *data, int len)
+{
+    uint32_t sum;
+    int i;
+
+    sum = 0;
+    for (i = 0; i < len; i++) {
+        sum += data[i];
+    }
+
+    return sum;
+}
+
+static void
+osbench_mbuf(void)
+{
+    struct os_mbuf_iovec seg;
+    struct os_mbuf_iter it;
+    struct os_mbuf *om;
+    struct os_mbuf *om2;
+    uint32_t start;
+    uint32_t sum;
+    int rc;
+    int i;
+
+    rc = os_mempool_init(&osbench_mbuf_mempool, OSBENCH_MBUF_COUNT,
+                         OSBENCH_MBUF_BUF_SIZE, osbench_mbuf_buf,
+                         "osbench_mbuf");
+    assert(rc == 0);
+    rc = os_mbuf_pool_init(&osbench_mbuf_pool, &osbench_mbuf_mempool,
+                           OSBENCH_MBUF_BUF_SIZE, OSBENCH_MBUF_COUNT);
+    assert(rc == 0);
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        om = os_mbuf_get_pkthdr(&osbench_mbuf_pool, 0);
+        assert(om != NULL);
+
+        start = osbench_now();
+        rc = os_mbuf_append(om, osbench_data, sizeof osbench_data);
+        osbench_sample(start, osbench_now());
+        assert(rc == 0);
+
+        os_mbuf_free_chain(om);
+    }
+    osbench_report("mbuf_append");
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        /* 16 bytes in the first mbuf, 64 in the second */
+        om = os_mbuf_get_pkthdr(&osbench_mbuf_pool, 0);
+        om2 = os_mbuf_get(&osbench_mbuf_pool, 0);
+        assert(om != NULL && om2 != NULL);
+        rc = os_mbuf_append(om, osbench_data, 16);
+        assert(rc == 0);
+        rc = os_mbuf_append(om2, osbench_data, 64);
+        assert(rc == 0);
+        os_mbuf_concat(om, om2);
+
+        start = osbench_now();
+        om = os_mbuf_pullup(om, 64);
+        osbench_sample(start, osbench_now());
+        assert(om != NULL);
+
+        os_mbuf_free_chain(om);
+    }
+    osbench_report("mbuf_pullup");
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        om = osbench_mbuf_chain();
+
+        start = osbench_now();
+        om2 = os_mbuf_dup(om);
+        osbench_sample(start, osbench_now());
+        assert(om2 != NULL);
+
+        os_mbuf_free_chain(om2);
+        os_mbuf_free_chain(om);
+    }
+    osbench_report("mbuf_dup");
+
+    /*
+     * Reading a packet through a flat os_mbuf_copydata() copy, against
+     * reading it in place through the mbuf iterator.
+     */
+    om = osbench_mbuf_chain();
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        os_mbuf_copydata(om, 0, OSBENCH_MBUF_DATA_LEN, osbench_flat);
+        osbench_sum = osbench_byte_sum(osbench_flat, OSBENCH_MBUF_DATA_LEN);
+        osbench_sample(start, osbench_now());
+    }
+    osbench_report("mbuf_read_copydata");
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        sum = 0;
+        os_mbuf_iter_init(&it, om, 0, OSBENCH_MBUF_DATA_LEN);
+        while (os_mbuf_iter_next(&it, &seg)) {
+            sum += osbench_byte_sum(seg.omi_base, seg.omi_len);
+        }
+        osbench_sum = sum;
+        osbench_sample(start, osbench_now());
+    }
+    osbench_report("mbuf_read_iter");
+    os_mbuf_free_chain(om);
+}
+
+/*
+ * Moving OSBENCH_RING_CHUNK bytes through an SPSC ring one byte at a time,
+ * against filling and consuming them in place.
+ */
+static void
+osbench_spsc_ring(void)
+{
+    uint8_t *data;
+    uint32_t start;
+    uint32_t sum;
+    uint32_t len;
+    uint32_t j;
+    int rc;
+    int b;
+    int i;
+
+    rc = spsc_ring_init(&osbench_ring, osbench_ring_buf,
+                        sizeof osbench_ring_buf);
+    assert(rc == 0);
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        for (j = 0; j < OSBENCH_RING_CHUNK; j++) {
+            spsc_ring_put(&osbench_ring, j);
+        }
+        sum = 0;
+        while ((b = spsc_ring_get(&osbench_ring)) >= 0) {
+            sum += b;
+        }
+        osbench_sum = sum;
+        osbench_sample(start, osbench_now());
+    }
+    osbench_report("spsc_ring_put_get");
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        start = osbench_now();
+        len = spsc_ring_write_reserve(&osbench_ring, (void **)&data);
+        if (len > OSBENCH_RING_CHUNK) {
+            len = OSBENCH_RING_CHUNK;
+        }
+        for (j = 0; j < len; j++) {
+            data[j] = j;
+        }
+        spsc_ring_write_commit(&osbench_ring, len);
+        sum = 0;
+        while ((len = spsc_ring_read_reserve(&osbench_ring,
+                                             (void **)&data)) > 0) {
+            sum += osbench_byte_sum(data, len);
+            spsc_ring_read_commit(&osbench_ring, len);
+        }
+        osbench_sum = sum;
+        osbench_sample(start, osbench_now());
+    }
+    osbench_report("spsc_ring_zero_copy");
+}
+
+static void
+osbench_callout_cb(struct os_event *ev)
+{
+}
+
+/* Numbers of armed callouts callout re-arming is timed with */
+static const int osbench_callout_counts[] = { 10, 100, 1000 };
+#define OSBENCH_NUM_CALLOUT_COUNTS \
+    (int)(sizeof osbench_callout_counts / sizeof osbench_callout_counts[0])
+
+/*
+ * Re-arming a pending callout, which takes it off the list and back on,
+ * while n callouts with spread out expiry times are armed.
+ */
+static void
+osbench_callout_reset_n(int n)
+{
+    struct os_callout *c;
+    uint32_t start;
+    int i;
+
+    os_eventq_init(&osbench_evq);
+    for (i = 0; i < n; i++) {
+        c = &osbench_callouts[i];
+        os_callout_init(c, &osbench_evq, osbench_callout_cb, NULL);
+        os_callout_reset(c, OS_TICKS_PER_SEC + (i * 37) % 1000);
+    }
+
+    for (i = 0; i < OSBENCH_ITERS; i++) {
+        c = &osbench_callouts[i % n];
+        start = osbench_now();
+        os_callout_reset(c, OS_TICKS_PER_SEC + (i * 53) % 1000);
+        osbench_sample(start, osbench_now());
+    }
+
+    for (i = 0; i < n; i++) {
+        os_callout_stop(&osbench_callouts[i]);
+    }
+    osbench_report_n("callout_reset", n);
+}
+
+static void
+osbench_callout_reset(void)
+{
+    int i;
+
+    for (i = 0; i < OSBENCH_NUM_CALLOUT_COUNTS; i++) {
+        if (osbench_callout_counts[i] <= MYNEWT_VAL(OSBENCH_CALLOUTS)) {
+            osbench_callout_reset_n(osbench_callout_counts[i]);
+        }
+    }
+}
+
+/* Numbers of workers in each of the pools in osbench_wqs */
+static const int osbench_worker_counts[OSBENCH_POOLS] = { 1, 2, 4 };
+
+static void
+osbench_work_fn(struct os_work *work)
+{
+    uint32_t sum;
+    int i;
+
+    sum = 0;
+    for (i = 0; i < OSBENCH_WORK_ROUNDS; i++) {
+        sum += osbench_byte_sum(osbench_data, sizeof osbench_data);
+    }
+    osbench_sum = sum;
+}
+
+static void
+osbench_work_done_cb(struct os_event *ev)
+{
+    osbench_work_done++;
+}
+
+/* Submits n work items and waits for all of their completions. */
+static void
+osbench_workq_run(struct os_workq *wq, int n)
+{
+    int rc;
+    int i;
+
+    osbench_work_done = 0;
+    for (i = 0; i < n; i++) {
+        rc = os_workq_submit(wq, &osbench_work[i], &osbench_work_evq);
+        assert(rc == 0);
+    }
+    while (osbench_work_done < n) {
+        os_eventq_run(&osbench_work_evq);
+    }
+}
+
+/*
+ * Running work items, each summing osbench_data OSBENCH_WORK_ROUNDS times,
+ * from submission until the completion callback has run on the submitter's
+ * event queue; one item at a time, and OSBENCH_WORK_BATCH at once.  This is
+ * repeated on pools of 1, 2 and 4 workers.  The workers take the filler
+ * priorities, so this runs after the scheduler benchmarks have removed the
+ * fillers.
+ */
+static void
+osbench_workq(void)
+{
+    struct os_workq *wq;
+    uint32_t start;
+    int prio;
+    int rc;
+    int w;
+    int k;
+    int i;
+
+    os_eventq_init(&osbench_work_evq);
+    for (i = 0; i < OSBENCH_WORK_BATCH; i++) {
+        os_work_init(&osbench_work[i], osbench_work_fn, osbench_work_done_cb,
+                     NULL);
+    }
+
+    /* Earlier pools stay idle, waiting on their own semaphores. */
+    w = 0;
+    prio = OSBENCH_FILLER_PRIO;
+    for (k = 0; k < OSBENCH_POOLS; k++) {
+        wq = &osbench_wqs[k];
+        rc = os_workq_init(wq, "osbench_worker", &osbench_workers[w],
+                           osbench_worker_counts[k], prio,
+                           osbench_worker_stacks[w],
+                           OSBENCH_WORKER_STACK_SIZE);
+        assert(rc == 0);
+        w += osbench_worker_counts[k];
+        prio += osbench_worker_counts[k];
+
+        for (i = 0; i < OSBENCH_ITERS; i++) {
+            start = osbench_now();
+            osbench_workq_run(wq, 1);
+            osbench_sample(start, osbench_now());
+        }
+        osbench_report_n("workq_round_trip", osbench_worker_counts[k]);
+
+        for (i = 0; i < OSBENCH_ITERS; i++) {
+            start = osbench_now();
+            osbench_workq_run(wq, OSBENCH_WORK_BATCH);
+            osbench_sample(start, osbench_now());
+        }
+        osbench_report_n("workq_batch", osbench_worker_counts[k]);
+    }
+}
+
+void
+osbench_run(void)
+{
+    int rc;
+
+    os_sem_init(&osbench_peer_go, 0);
+    rc = os_task_init(&osbench_peer_task, "osbench_peer",
+                      osbench_peer_handler, NULL, OSBENCH_PEER_PRIO,
+                      OS_WAIT_FOREVER, osbench_peer_stack,
+                      OSBENCH_PEER_STACK_SIZE);
+    assert(rc == 0);
+
+    memset(osbench_data, 0xa5, sizeof osbench_data);
+
+    osbench_report_start();
+    osbench_clock();
+    osbench_ctx_sw();
+    osbench_sched_wakeup();
+    osbench_sched_sleep();
+    osbench_sem_handoff();
+    osbench_mutex_handoff();
+    osbench_eventq();
+    osbench_mempool();
+    osbench_mbuf();
+    osbench_spsc_ring();
+    osbench_callout_reset();
+    osbench_workq();
+#if MYNEWT_VAL(OSBENCH_FCB)
+    osbench_fcb_append();
+    osbench_fcb_walk();
+#endif
+#if MYNEWT_VAL(OSBENCH_TLSF)
+    osbench_tlsf();
+#endif
+    osbench_report_finish();
+}
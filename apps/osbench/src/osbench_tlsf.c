@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * TLSF heap latency.  A fixed pseudo-random sequence allocates into, and
+ * frees out of, OSBENCH_TLSF_SLOTS slots with sizes from 8 to 1024 bytes,
+ * keeping the heap partly full and fragmented.  The same sequence is run
+ * twice, timing the allocations the first time and the frees the second.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "osbench.h"
+
+#if MYNEWT_VAL(OSBENCH_TLSF)
+
+#include "tlsf/tlsf.h"
+
+#define OSBENCH_TLSF_ARENA_SIZE (16 * 1024)
+#define OSBENCH_TLSF_SLOTS      32
+
+static uint8_t osbench_tlsf_arena[OSBENCH_TLSF_ARENA_SIZE]
+    __attribute__((aligned(16)));
+static struct tlsf osbench_tlsf_heap;
+static void *osbench_tlsf_slots[OSBENCH_TLSF_SLOTS];
+
+static void
+osbench_tlsf_run(int time_free)
+{
+    uint32_t start;
+    uint32_t seed;
+    size_t size;
+    int slot;
+    int i;
+
+    tlsf_init(&osbench_tlsf_heap);
+    tlsf_add_pool(&osbench_tlsf_heap, osbench_tlsf_arena,
+                  sizeof osbench_tlsf_arena);
+    memset(osbench_tlsf_slots, 0, sizeof osbench_tlsf_slots);
+
+    seed = 1;
+    for (i = 0; i < OSBENCH_ITERS * 2; i++) {
+        seed = seed * 1664525 + 1013904223;
+        slot = (seed >> 8) % OSBENCH_TLSF_SLOTS;
+
+        if (osbench_tlsf_slots[slot] == NULL) {
+            size = 8 << ((seed >> 16) % 8);
+            start = osbench_now();
+            osbench_tlsf_slots[slot] = tlsf_malloc(&osbench_tlsf_heap, size);
+            if (!time_free) {
+                osbench_sample(start, osbench_now());
+            }
+        } else {
+            start = osbench_now();
+            tlsf_free(&osbench_tlsf_heap, osbench_tlsf_slots[slot]);
+            if (time_free) {
+                osbench_sample(start, osbench_now());
+            }
+            osbench_tlsf_slots[slot] = NULL;
+        }
+    }
+}
+
+void
+osbench_tlsf(void)
+{
+    osbench_tlsf_run(0);
+    osbench_report("tlsf_malloc");
+
+    osbench_tlsf_run(1);
+    osbench_report("tlsf_free");
+}
+
+#endif
@@ -17,18 +17,70 @@
  * under the License.
  */
 
+#include <string.h>
 #include "os/mynewt.h"
 #include <tinycbor/cbor_mbuf_reader.h>
 #include <tinycbor/compilersupport_p.h>
 
+/*
+ * Positions an iterator at the given message offset.  The decoder reads
+ * mostly forward, so the search starts from the mbuf that satisfied the
+ * previous read instead of the head of the chain.
+ */
+static int
+cbor_mbuf_reader_seek(struct cbor_mbuf_reader *cb, int offset, int len,
+                      struct os_mbuf_iter *it)
+{
+    offset += cb->init_off;
+
+    if (cb->cur == NULL || offset < cb->cur_off) {
+        cb->cur = cb->m;
+        cb->cur_off = 0;
+    }
+
+    while (offset - cb->cur_off >= cb->cur->om_len &&
+           SLIST_NEXT(cb->cur, om_next) != NULL) {
+        cb->cur_off += cb->cur->om_len;
+        cb->cur = SLIST_NEXT(cb->cur, om_next);
+    }
+
+    return os_mbuf_iter_init(it, cb->cur, offset - cb->cur_off, len);
+}
+
+static int
+cbor_mbuf_reader_read(struct cbor_mbuf_reader *cb, int offset, void *dst,
+                      int len)
+{
+    struct os_mbuf_iovec iov;
+    struct os_mbuf_iter it;
+    uint8_t *udst;
+
+    if (cbor_mbuf_reader_seek(cb, offset, len, &it) != 0) {
+        return -1;
+    }
+
+    udst = dst;
+    while (os_mbuf_iter_next(&it, &iov)) {
+        memcpy(udst, iov.omi_base, iov.omi_len);
+        udst += iov.omi_len;
+        len -= iov.omi_len;
+    }
+
+    return len > 0 ? -1 : 0;
+}
+
 static uint8_t
 cbor_mbuf_reader_get8(struct cbor_decoder_reader *d, int offset)
 {
-    uint8_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
+    struct os_mbuf_iovec iov;
+    struct os_mbuf_iter it;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
-    return val;
+    if (cbor_mbuf_reader_seek(cb, offset, 1, &it) != 0 ||
+        !os_mbuf_iter_next(&it, &iov)) {
+        return 0;
+    }
+    return *(uint8_t *)iov.omi_base;
 }
 
 static uint16_t
@@ -37,7 +89,7 @@ cbor_mbuf_reader_get16(struct cbor_decoder_reader *d, int offset)
     uint16_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
+    cbor_mbuf_reader_read(cb, offset, &val, sizeof(val));
     return cbor_ntohs(val);
 }
 
@@ -47,7 +99,7 @@ cbor_mbuf_reader_get32(struct cbor_decoder_reader *d, int offset)
     uint32_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
+    cbor_mbuf_reader_read(cb, offset, &val, sizeof(val));
     return cbor_ntohl(val);
 }
 
@@ -57,7 +109,7 @@ cbor_mbuf_reader_get64(struct cbor_decoder_reader *d, int offset)
     uint64_t val;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    os_mbuf_copydata(cb->m, offset + cb->init_off, sizeof(val), &val);
+    cbor_mbuf_reader_read(cb, offset, &val, sizeof(val));
     return cbor_ntohll(val);
 }
 
@@ -66,7 +118,22 @@ cbor_mbuf_reader_cmp(struct cbor_decoder_reader *d, char *buf, int offset,
                      size_t len)
 {
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
-    return os_mbuf_cmpf(cb->m, offset + cb->init_off, buf, len) == 0;
+    struct os_mbuf_iovec iov;
+    struct os_mbuf_iter it;
+
+    if (cbor_mbuf_reader_seek(cb, offset, len, &it) != 0) {
+        return false;
+    }
+
+    while (os_mbuf_iter_next(&it, &iov)) {
+        if (memcmp(iov.omi_base, buf, iov.omi_len) != 0) {
+            return false;
+        }
+        buf += iov.omi_len;
+        len -= iov.omi_len;
+    }
+
+    return len == 0;
 }
 
 static uintptr_t
@@ -76,7 +143,7 @@ cbor_mbuf_reader_cpy(struct cbor_decoder_reader *d, char *dst, int offset,
     int rc;
     struct cbor_mbuf_reader *cb = (struct cbor_mbuf_reader *) d;
 
-    rc = os_mbuf_copydata(cb->m, offset + cb->init_off, len, dst);
+    rc = cbor_mbuf_reader_read(cb, offset, dst, len);
     if (rc == 0) {
         return true;
     }
@@ -100,5 +167,7 @@ cbor_mbuf_reader_init(struct cbor_mbuf_reader *cb, struct os_mbuf *m,
     hdr = OS_MBUF_PKTHDR(m);
     cb->m = m;
     cb->init_off = initial_offset;
+    cb->cur = NULL;
+    cb->cur_off = 0;
     cb->r.message_size = hdr->omp_len - initial_offset;
 }
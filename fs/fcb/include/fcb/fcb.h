@@ -47,6 +47,28 @@ struct fcb_entry {
     uint16_t fe_data_len;	/* size of data area */
 };
 
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+#define FCB_INDEX_KEYS  2       /* Number of keys kept per sector */
+
+/**
+ * RAM summary of one sector, kept when fcb->f_index is set.
+ */
+struct fcb_sector_index {
+    uint64_t fsi_key[FCB_INDEX_KEYS]; /* keys of first entry in sector */
+    uint16_t fsi_entries;	/* number of entries in sector */
+};
+
+struct fcb;
+
+/**
+ * Fills in the index keys of an entry, e.g. sequence number and
+ * timestamp. Keys must not decrease from one entry to the next.
+ */
+typedef int (*fcb_index_key_fn)(struct fcb *fcb, struct fcb_entry *loc,
+                                uint64_t *keys);
+#endif
+
+
 struct fcb {
     /* Caller of fcb_init fills this in */
     uint32_t f_magic;		/* As placed on the disk */
@@ -54,6 +76,10 @@ struct fcb {
     uint8_t f_sector_cnt;	/* Number of elements in sector array */
     uint8_t f_scratch_cnt;	/* How many sectors should be kept empty */
     struct flash_area *f_sectors; /* Array of sectors, must be contiguous */
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+    struct fcb_sector_index *f_index; /* f_sector_cnt elements, or NULL */
+    fcb_index_key_fn f_index_key; /* Fills in keys for f_index, or NULL */
+#endif
 
     /* Flash circular buffer internal state */
     struct os_mutex f_mtx;	/* Locking for accessing the FCB data */
@@ -61,6 +87,10 @@ struct fcb {
     struct fcb_entry f_active;
     uint16_t f_active_id;
     uint8_t f_align;		/* writes to flash have to aligned to this */
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    uint8_t f_trusted;		/* skip CRC check in verified sectors */
+    uint32_t f_verified;	/* bit per sector, all entries CRC checked */
+#endif
 };
 
 /**
@@ -78,6 +108,17 @@ struct fcb {
 
 int fcb_init(struct fcb *fcb);
 
+/**
+ * Batch of entries which are laid out in a RAM buffer exactly as they go
+ * to flash, and are then written with a single flash_area_write().
+ */
+struct fcb_batch {
+    uint8_t *fb_buf;		/* entries, as they are written to flash */
+    uint16_t fb_size;		/* size of fb_buf */
+    uint16_t fb_len;		/* bytes of fb_buf in use */
+    uint16_t fb_entries;	/* number of entries in fb_buf */
+};
+
 /**
  * fcb_log is needed as the number of entries in a log
  */
@@ -89,6 +130,14 @@ struct fcb_log {
     /* Internal - tracking storage use */
     uint32_t fl_watermark_off;
 #endif
+
+#if MYNEWT_VAL(LOG_FCB_BATCH)
+    /* Internal - entries not yet written to flash */
+    struct fcb_batch fl_batch;
+    struct os_mutex fl_batch_mtx;
+    struct os_callout fl_batch_timer;
+    uint8_t fl_batch_buf[MYNEWT_VAL(LOG_FCB_BATCH_SIZE)];
+#endif
 };
 
 /**
@@ -100,6 +149,23 @@ struct fcb_log {
 int fcb_append(struct fcb *, uint16_t len, struct fcb_entry *loc);
 int fcb_append_finish(struct fcb *, struct fcb_entry *append_loc);
 
+/**
+ * fcb_batch_init() sets up an empty batch using buf. A batch must fit in
+ * one sector, so buf should not be larger than a sector.
+ *
+ * fcb_batch_reserve() adds an entry of len bytes to the batch, and returns
+ * where its data should be copied to. Returns NULL if the batch is full.
+ *
+ * fcb_batch_commit() appends all entries in the batch to the FCB, and
+ * empties the batch. Each entry has its own CRC, so after a reset in the
+ * middle of the write every entry is either complete or skipped by
+ * readers, as with fcb_append(). On failure the entries stay in the
+ * batch.
+ */
+void fcb_batch_init(struct fcb_batch *fb, void *buf, uint16_t size);
+void *fcb_batch_reserve(struct fcb *, struct fcb_batch *fb, uint16_t len);
+int fcb_batch_commit(struct fcb *, struct fcb_batch *fb);
+
 /**
  * Walk over all log entries in FCB, or entries in a given flash_area.
  * cb gets called for every entry. If cb wants to stop the walk, it should
@@ -110,6 +176,17 @@ int fcb_append_finish(struct fcb *, struct fcb_entry *append_loc);
  */
 typedef int (*fcb_walk_cb)(struct fcb_entry *loc, void *arg);
 int fcb_walk(struct fcb *, struct flash_area *, fcb_walk_cb cb, void *cb_arg);
+
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+/**
+ * Like fcb_walk(), but CRCs are not checked in sectors which an earlier
+ * walk has read through with every entry passing its check. Sectors are
+ * forgotten when they are erased. For callers which trust that flash
+ * contents do not change underneath them.
+ */
+int fcb_walk_trusted(struct fcb *, struct flash_area *, fcb_walk_cb cb,
+                     void *cb_arg);
+#endif
 int fcb_getnext(struct fcb *, struct fcb_entry *loc);
 
 /**
@@ -139,6 +216,17 @@ int
 fcb_offset_last_n(struct fcb *fcb, uint8_t entries,
         struct fcb_entry *last_n_entry);
 
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+/**
+ * Finds where to start reading to reach the first entry whose index key
+ * number *key* is >= value. Sets loc so that the following fcb_getnext()
+ * returns the first entry of the sector that can hold such an entry;
+ * entries before it are skipped without being read. Needs f_index and
+ * f_index_key.
+ */
+int fcb_seek(struct fcb *fcb, int key, uint64_t value, struct fcb_entry *loc);
+#endif
+
 /**
  * Clears FCB passed to it
  */
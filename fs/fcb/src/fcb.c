@@ -82,6 +82,10 @@ fcb_init(struct fcb *fcb)
     fcb->f_active.fe_area = newest_fap;
     fcb->f_active.fe_elem_off = sizeof(struct fcb_disk_area);
     fcb->f_active_id = newest;
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    fcb->f_trusted = 0;
+    fcb->f_verified = 0;
+#endif
 
     /* Require alignment to be a power of two.  Some code depends on this
      * assumption.
@@ -98,6 +102,9 @@ fcb_init(struct fcb *fcb)
             break;
         }
     }
+    if (rc == FCB_OK) {
+        fcb_index_rebuild(fcb);
+    }
     os_mutex_init(&fcb->f_mtx);
     return rc;
 }
@@ -231,6 +238,12 @@ fcb_offset_last_n(struct fcb *fcb, uint8_t entries,
         entries = 1;
     }
 
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+    if (fcb->f_index) {
+        return fcb_index_last_n(fcb, entries, last_n_entry);
+    }
+#endif
+
     i = 0;
     memset(&loc, 0, sizeof(loc));
     while (!fcb_getnext(fcb, &loc)) {
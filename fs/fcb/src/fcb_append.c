@@ -60,17 +60,46 @@ fcb_append_to_scratch(struct fcb *fcb)
     if (rc) {
         return rc;
     }
+    fcb_sector_forget(fcb, fa);
     fcb->f_active.fe_area = fa;
     fcb->f_active.fe_elem_off = sizeof(struct fcb_disk_area);
     fcb->f_active_id++;
     return FCB_OK;
 }
 
+/*
+ * Make sure there are len bytes free in the active sector, moving on to a
+ * new sector if needed. Caller holds f_mtx.
+ */
 int
-fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *append_loc)
+fcb_append_space(struct fcb *fcb, uint32_t len)
 {
     struct fcb_entry *active;
     struct flash_area *fa;
+    int rc;
+
+    active = &fcb->f_active;
+    if (active->fe_elem_off + len > active->fe_area->fa_size) {
+        fa = fcb_new_area(fcb, fcb->f_scratch_cnt);
+        if (!fa || (fa->fa_size < sizeof(struct fcb_disk_area) + len)) {
+            return FCB_ERR_NOSPACE;
+        }
+        rc = fcb_sector_hdr_init(fcb, fa, fcb->f_active_id + 1);
+        if (rc) {
+            return rc;
+        }
+        fcb_sector_forget(fcb, fa);
+        fcb->f_active.fe_area = fa;
+        fcb->f_active.fe_elem_off = sizeof(struct fcb_disk_area);
+        fcb->f_active_id++;
+    }
+    return FCB_OK;
+}
+
+int
+fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *append_loc)
+{
+    struct fcb_entry *active;
     uint8_t tmp_str[2];
     int cnt;
     int rc;
@@ -87,20 +116,9 @@ fcb_append(struct fcb *fcb, uint16_t len, struct fcb_entry *append_loc)
         return FCB_ERR_ARGS;
     }
     active = &fcb->f_active;
-    if (active->fe_elem_off + len + cnt > active->fe_area->fa_size) {
-        fa = fcb_new_area(fcb, fcb->f_scratch_cnt);
-        if (!fa || (fa->fa_size <
-            sizeof(struct fcb_disk_area) + len + cnt)) {
-            rc = FCB_ERR_NOSPACE;
-            goto err;
-        }
-        rc = fcb_sector_hdr_init(fcb, fa, fcb->f_active_id + 1);
-        if (rc) {
-            goto err;
-        }
-        fcb->f_active.fe_area = fa;
-        fcb->f_active.fe_elem_off = sizeof(struct fcb_disk_area);
-        fcb->f_active_id++;
+    rc = fcb_append_space(fcb, len + cnt);
+    if (rc) {
+        goto err;
     }
 
     rc = flash_area_write(active->fe_area, active->fe_elem_off, tmp_str, cnt);
@@ -139,5 +157,16 @@ fcb_append_finish(struct fcb *fcb, struct fcb_entry *loc)
     if (rc) {
         return FCB_ERR_FLASH;
     }
+
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+    if (fcb->f_index) {
+        rc = os_mutex_pend(&fcb->f_mtx, OS_WAIT_FOREVER);
+        if (rc && rc != OS_NOT_STARTED) {
+            return FCB_ERR_ARGS;
+        }
+        fcb_index_add(fcb, loc);
+        os_mutex_release(&fcb->f_mtx);
+    }
+#endif
     return 0;
 }
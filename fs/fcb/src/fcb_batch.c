@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <string.h>
+
+#include <crc/crc8.h>
+
+#include "fcb/fcb.h"
+#include "fcb_priv.h"
+
+void
+fcb_batch_init(struct fcb_batch *fb, void *buf, uint16_t size)
+{
+    fb->fb_buf = buf;
+    fb->fb_size = size;
+    fb->fb_len = 0;
+    fb->fb_entries = 0;
+}
+
+void *
+fcb_batch_reserve(struct fcb *fcb, struct fcb_batch *fb, uint16_t len)
+{
+    uint8_t tmp_str[2];
+    uint8_t *elem;
+    int cnt;
+    int need;
+
+    cnt = fcb_put_len(tmp_str, len);
+    if (cnt < 0) {
+        return NULL;
+    }
+    need = fcb_len_in_flash(fcb, cnt) + fcb_len_in_flash(fcb, len) +
+      fcb_len_in_flash(fcb, FCB_CRC_SZ);
+    if (fb->fb_len + need > fb->fb_size) {
+        return NULL;
+    }
+
+    /*
+     * Padding is left as it would be in erased flash.
+     */
+    elem = fb->fb_buf + fb->fb_len;
+    memset(elem, 0xff, need);
+    memcpy(elem, tmp_str, cnt);
+
+    fb->fb_len += need;
+    fb->fb_entries++;
+
+    return elem + fcb_len_in_flash(fcb, cnt);
+}
+
+/*
+ * Decode the entry at offset off within the batch. Returns the offset of
+ * the entry following it.
+ */
+static uint16_t
+fcb_batch_elem(struct fcb *fcb, struct fcb_batch *fb, uint16_t off,
+  struct fcb_entry *loc)
+{
+    int cnt;
+
+    cnt = fcb_get_len(fb->fb_buf + off, &loc->fe_data_len);
+    loc->fe_data_off = off + fcb_len_in_flash(fcb, cnt);
+    loc->fe_elem_off = off;
+    return loc->fe_data_off + fcb_len_in_flash(fcb, loc->fe_data_len) +
+      fcb_len_in_flash(fcb, FCB_CRC_SZ);
+}
+
+int
+fcb_batch_commit(struct fcb *fcb, struct fcb_batch *fb)
+{
+    struct fcb_entry loc;
+    struct flash_area *fap;
+    uint32_t base;
+    uint16_t off;
+    uint16_t next;
+    uint8_t crc8;
+    int rc;
+
+    if (fb->fb_len == 0) {
+        return 0;
+    }
+
+    /*
+     * CRC covers the length field and the data, as in fcb_elem_crc8().
+     */
+    for (off = 0; off < fb->fb_len; off = next) {
+        next = fcb_batch_elem(fcb, fb, off, &loc);
+        crc8 = crc8_init();
+        crc8 = crc8_calc(crc8, fb->fb_buf + off, loc.fe_data_off - off);
+        crc8 = crc8_calc(crc8, fb->fb_buf + loc.fe_data_off,
+          loc.fe_data_len);
+        fb->fb_buf[loc.fe_data_off +
+          fcb_len_in_flash(fcb, loc.fe_data_len)] = crc8;
+    }
+
+    rc = os_mutex_pend(&fcb->f_mtx, OS_WAIT_FOREVER);
+    if (rc && rc != OS_NOT_STARTED) {
+        return FCB_ERR_ARGS;
+    }
+    rc = fcb_append_space(fcb, fb->fb_len);
+    if (rc) {
+        os_mutex_release(&fcb->f_mtx);
+        return rc;
+    }
+    fap = fcb->f_active.fe_area;
+    base = fcb->f_active.fe_elem_off;
+    fcb->f_active.fe_elem_off += fb->fb_len;
+    os_mutex_release(&fcb->f_mtx);
+
+    rc = flash_area_write(fap, base, fb->fb_buf, fb->fb_len);
+    if (rc) {
+        return FCB_ERR_FLASH;
+    }
+
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+    if (fcb->f_index) {
+        os_mutex_pend(&fcb->f_mtx, OS_WAIT_FOREVER);
+        for (off = 0; off < fb->fb_len; off = next) {
+            next = fcb_batch_elem(fcb, fb, off, &loc);
+            loc.fe_area = fap;
+            loc.fe_elem_off += base;
+            loc.fe_data_off += base;
+            fcb_index_add(fcb, &loc);
+        }
+        os_mutex_release(&fcb->f_mtx);
+    }
+#endif
+
+    fb->fb_len = 0;
+    fb->fb_entries = 0;
+    return 0;
+}
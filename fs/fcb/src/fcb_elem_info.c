@@ -23,19 +23,14 @@
 #include "fcb_priv.h"
 
 /*
- * Given offset in flash area, fill in rest of the fcb_entry, and crc8 over
- * the data.
+ * Given offset in flash area, read the length of the element and fill in
+ * rest of the fcb_entry. Returns the number of bytes in the length
+ * field, which are left in buf.
  */
-int
-fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *c8p)
+static int
+fcb_elem_len(struct fcb *fcb, struct fcb_entry *loc, uint8_t *buf)
 {
-    uint8_t tmp_str[FCB_TMP_BUF_SZ];
     int cnt;
-    int blk_sz;
-    uint8_t crc8;
-    uint16_t len;
-    uint32_t off;
-    uint32_t end;
     int rc;
 
     if (loc->fe_elem_off + 2 > loc->fe_area->fa_size) {
@@ -44,14 +39,37 @@ fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *c8p)
     if (flash_area_isempty_at(loc->fe_area, loc->fe_elem_off, 2)) {
         return FCB_ERR_NOVAR;
     }
-    rc = flash_area_read(loc->fe_area, loc->fe_elem_off, tmp_str, 2);
+    rc = flash_area_read(loc->fe_area, loc->fe_elem_off, buf, 2);
     if (rc) {
         return FCB_ERR_FLASH;
     }
 
-    cnt = fcb_get_len(tmp_str, &len);
+    cnt = fcb_get_len(buf, &loc->fe_data_len);
     loc->fe_data_off = loc->fe_elem_off + fcb_len_in_flash(fcb, cnt);
-    loc->fe_data_len = len;
+    return cnt;
+}
+
+/*
+ * Given offset in flash area, fill in rest of the fcb_entry, and crc8 over
+ * the data.
+ */
+int
+fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, uint8_t *c8p)
+{
+    uint8_t tmp_str[FCB_TMP_BUF_SZ];
+    int cnt;
+    int blk_sz;
+    uint8_t crc8;
+    uint16_t len;
+    uint32_t off;
+    uint32_t end;
+    int rc;
+
+    cnt = fcb_elem_len(fcb, loc, tmp_str);
+    if (cnt < 0) {
+        return cnt;
+    }
+    len = loc->fe_data_len;
 
     crc8 = crc8_init();
     crc8 = crc8_calc(crc8, tmp_str, cnt);
@@ -82,6 +100,17 @@ fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc)
     uint8_t crc8;
     uint8_t fl_crc8;
     uint32_t off;
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    uint8_t len_buf[2];
+#endif
+
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    if (fcb->f_trusted &&
+      (fcb->f_verified & fcb_sector_bit(fcb, loc->fe_area))) {
+        rc = fcb_elem_len(fcb, loc, len_buf);
+        return rc < 0 ? rc : 0;
+    }
+#endif
 
     rc = fcb_elem_crc8(fcb, loc, &crc8);
     if (rc) {
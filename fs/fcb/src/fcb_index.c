@@ -0,0 +1,188 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include <string.h>
+
+#include "fcb/fcb.h"
+#include "fcb_priv.h"
+
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+
+static struct fcb_sector_index *
+fcb_index_get(struct fcb *fcb, struct flash_area *fap)
+{
+    return &fcb->f_index[fap - fcb->f_sectors];
+}
+
+static struct flash_area *
+fcb_getprev_area(struct fcb *fcb, struct flash_area *fap)
+{
+    if (fap == &fcb->f_sectors[0]) {
+        fap = &fcb->f_sectors[fcb->f_sector_cnt];
+    }
+    return fap - 1;
+}
+
+/*
+ * Forget everything about a sector; called when it is erased or taken
+ * into use.
+ */
+void
+fcb_index_clear(struct fcb *fcb, struct flash_area *fap)
+{
+    if (fcb->f_index) {
+        memset(fcb_index_get(fcb, fap), 0, sizeof(struct fcb_sector_index));
+    }
+}
+
+/*
+ * Account for an entry which has been completely written. Caller holds
+ * f_mtx, or is fcb_init().
+ */
+void
+fcb_index_add(struct fcb *fcb, struct fcb_entry *loc)
+{
+    struct fcb_sector_index *fsi;
+    uint64_t keys[FCB_INDEX_KEYS];
+    int rc;
+    int i;
+
+    if (!fcb->f_index) {
+        return;
+    }
+    fsi = fcb_index_get(fcb, loc->fe_area);
+
+    /*
+     * With several writers, entries can be finished out of order. Keep
+     * the keys of whichever entry comes first in the sector.
+     */
+    if (fcb->f_index_key &&
+      (fsi->fsi_entries == 0 ||
+       loc->fe_elem_off == sizeof(struct fcb_disk_area))) {
+        rc = fcb->f_index_key(fcb, loc, keys);
+        for (i = 0; i < FCB_INDEX_KEYS; i++) {
+            fsi->fsi_key[i] = rc ? 0 : keys[i];
+        }
+    }
+    fsi->fsi_entries++;
+}
+
+void
+fcb_index_rebuild(struct fcb *fcb)
+{
+    struct fcb_entry loc;
+
+    if (!fcb->f_index) {
+        return;
+    }
+    memset(fcb->f_index, 0,
+      fcb->f_sector_cnt * sizeof(struct fcb_sector_index));
+
+    memset(&loc, 0, sizeof(loc));
+    while (fcb_getnext_nolock(fcb, &loc) == 0) {
+        fcb_index_add(fcb, &loc);
+    }
+}
+
+/*
+ * fcb_offset_last_n() using entry counts from the index. Only the
+ * sector where the last n entries begin is read.
+ */
+int
+fcb_index_last_n(struct fcb *fcb, uint8_t entries, struct fcb_entry *loc)
+{
+    struct flash_area *fap;
+    int total;
+    int rc;
+
+    rc = os_mutex_pend(&fcb->f_mtx, OS_WAIT_FOREVER);
+    if (rc && rc != OS_NOT_STARTED) {
+        return FCB_ERR_ARGS;
+    }
+    total = 0;
+    fap = fcb->f_active.fe_area;
+    while (1) {
+        total += fcb_index_get(fcb, fap)->fsi_entries;
+        if (total >= entries || fap == fcb->f_oldest) {
+            break;
+        }
+        fap = fcb_getprev_area(fcb, fap);
+    }
+
+    memset(loc, 0, sizeof(*loc));
+    loc->fe_area = fap;
+    rc = fcb_getnext_nolock(fcb, loc);
+    for (total -= entries; rc == 0 && total > 0; total--) {
+        rc = fcb_getnext_nolock(fcb, loc);
+    }
+    os_mutex_release(&fcb->f_mtx);
+
+    return rc ? OS_ENOENT : 0;
+}
+
+int
+fcb_seek(struct fcb *fcb, int key, uint64_t value, struct fcb_entry *loc)
+{
+    struct fcb_sector_index *fsi;
+    struct flash_area *fap;
+    struct flash_area *start;
+    int rc;
+
+    if (!fcb->f_index || !fcb->f_index_key ||
+      key < 0 || key >= FCB_INDEX_KEYS) {
+        return FCB_ERR_ARGS;
+    }
+
+    rc = os_mutex_pend(&fcb->f_mtx, OS_WAIT_FOREVER);
+    if (rc && rc != OS_NOT_STARTED) {
+        return FCB_ERR_ARGS;
+    }
+    if (fcb_is_empty(fcb)) {
+        rc = FCB_ERR_NOVAR;
+        goto out;
+    }
+
+    /*
+     * Keys do not decrease, so all entries with key >= value are in the
+     * last sector starting below value, or after it.
+     */
+    start = fcb->f_oldest;
+    fap = fcb->f_oldest;
+    while (1) {
+        fsi = fcb_index_get(fcb, fap);
+        if (fsi->fsi_entries) {
+            if (fsi->fsi_key[key] >= value) {
+                break;
+            }
+            start = fap;
+        }
+        if (fap == fcb->f_active.fe_area) {
+            break;
+        }
+        fap = fcb_getnext_area(fcb, fap);
+    }
+
+    memset(loc, 0, sizeof(*loc));
+    loc->fe_area = start;
+    rc = 0;
+out:
+    os_mutex_release(&fcb->f_mtx);
+    return rc;
+}
+
+#endif
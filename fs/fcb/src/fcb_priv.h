@@ -55,9 +55,48 @@ int fcb_elem_info(struct fcb *, struct fcb_entry *);
 int fcb_elem_crc8(struct fcb *, struct fcb_entry *loc, uint8_t *crc8p);
 
 int fcb_sector_hdr_init(struct fcb *, struct flash_area *fap, uint16_t id);
+int fcb_append_space(struct fcb *, uint32_t len);
 int fcb_sector_hdr_read(struct fcb *, struct flash_area *fap,
   struct fcb_disk_area *fdap);
 
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+void fcb_index_clear(struct fcb *, struct flash_area *fap);
+void fcb_index_add(struct fcb *, struct fcb_entry *loc);
+void fcb_index_rebuild(struct fcb *);
+int fcb_index_last_n(struct fcb *, uint8_t entries, struct fcb_entry *loc);
+#else
+static inline void
+fcb_index_rebuild(struct fcb *fcb)
+{
+}
+#endif
+
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+static inline uint32_t
+fcb_sector_bit(struct fcb *fcb, struct flash_area *fap)
+{
+    int idx;
+
+    idx = fap - fcb->f_sectors;
+    return idx < 32 ? 1UL << idx : 0;
+}
+#endif
+
+/*
+ * Drop what is kept in RAM about a sector; called when the sector is
+ * erased or taken into use.
+ */
+static inline void
+fcb_sector_forget(struct fcb *fcb, struct flash_area *fap)
+{
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+    fcb_index_clear(fcb, fap);
+#endif
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    fcb->f_verified &= ~fcb_sector_bit(fcb, fap);
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,6 +36,7 @@ fcb_rotate(struct fcb *fcb)
         rc = FCB_ERR_FLASH;
         goto out;
     }
+    fcb_sector_forget(fcb, fcb->f_oldest);
     if (fcb->f_oldest == fcb->f_active.fe_area) {
         /*
          * Need to create a new active area, as we're wiping the current.
@@ -45,6 +46,7 @@ fcb_rotate(struct fcb *fcb)
         if (rc) {
             goto out;
         }
+        fcb_sector_forget(fcb, fap);
         fcb->f_active.fe_area = fap;
         fcb->f_active.fe_elem_off = sizeof(struct fcb_disk_area);
         fcb->f_active_id++;
@@ -20,14 +20,78 @@
 #include "fcb/fcb.h"
 #include "fcb_priv.h"
 
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
 /*
- * Call 'cb' for every element in flash circular buffer. If fap is specified,
- * only elements with that flash_area are reported.
+ * Tracks whether a walk has read through a sector without any entries
+ * being skipped for a bad CRC.
  */
-int
-fcb_walk(struct fcb *fcb, struct flash_area *fap, fcb_walk_cb cb, void *cb_arg)
+struct fcb_walk_verify {
+    struct flash_area *fwv_area;
+    uint32_t fwv_next_off;	/* where the next entry should start */
+    int fwv_clean;
+};
+
+/*
+ * Marks the sector being read as verified if entries were contiguous
+ * up to the end of data. The active sector is never marked, as an entry
+ * there may still be in the middle of being written.
+ */
+static void
+fcb_walk_verify_done(struct fcb *fcb, struct fcb_walk_verify *fwv)
+{
+    struct flash_area *fap;
+
+    fap = fwv->fwv_area;
+    if (!fap || !fwv->fwv_clean || fap == fcb->f_active.fe_area) {
+        return;
+    }
+    if (fwv->fwv_next_off + 2 > fap->fa_size ||
+      flash_area_isempty_at(fap, fwv->fwv_next_off, 2)) {
+        fcb->f_verified |= fcb_sector_bit(fcb, fap);
+    }
+}
+
+static void
+fcb_walk_verify_next(struct fcb *fcb, struct fcb_walk_verify *fwv,
+  struct fcb_entry *loc)
+{
+    if (loc->fe_area != fwv->fwv_area) {
+        fcb_walk_verify_done(fcb, fwv);
+        fwv->fwv_area = loc->fe_area;
+        fwv->fwv_clean =
+          (loc->fe_elem_off == sizeof(struct fcb_disk_area));
+    } else if (loc->fe_elem_off != fwv->fwv_next_off) {
+        fwv->fwv_clean = 0;
+    }
+    fwv->fwv_next_off = loc->fe_data_off +
+      fcb_len_in_flash(fcb, loc->fe_data_len) +
+      fcb_len_in_flash(fcb, FCB_CRC_SZ);
+}
+#endif
+
+static int
+fcb_getnext_walk(struct fcb *fcb, struct fcb_entry *loc, int trusted)
+{
+    int rc;
+
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    fcb->f_trusted = trusted;
+    rc = fcb_getnext_nolock(fcb, loc);
+    fcb->f_trusted = 0;
+#else
+    rc = fcb_getnext_nolock(fcb, loc);
+#endif
+    return rc;
+}
+
+static int
+fcb_walk_int(struct fcb *fcb, struct flash_area *fap, fcb_walk_cb cb,
+  void *cb_arg, int trusted)
 {
     struct fcb_entry loc;
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    struct fcb_walk_verify fwv = { 0 };
+#endif
     int rc;
 
     loc.fe_area = fap;
@@ -37,7 +101,10 @@ fcb_walk(struct fcb *fcb, struct flash_area *fap, fcb_walk_cb cb, void *cb_arg)
     if (rc && rc != OS_NOT_STARTED) {
         return FCB_ERR_ARGS;
     }
-    while ((rc = fcb_getnext_nolock(fcb, &loc)) != FCB_ERR_NOVAR) {
+    while ((rc = fcb_getnext_walk(fcb, &loc, trusted)) != FCB_ERR_NOVAR) {
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+        fcb_walk_verify_next(fcb, &fwv, &loc);
+#endif
         os_mutex_release(&fcb->f_mtx);
         if (fap && loc.fe_area != fap) {
             return 0;
@@ -48,6 +115,28 @@ fcb_walk(struct fcb *fcb, struct flash_area *fap, fcb_walk_cb cb, void *cb_arg)
         }
         os_mutex_pend(&fcb->f_mtx, OS_WAIT_FOREVER);
     }
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    fcb_walk_verify_done(fcb, &fwv);
+#endif
     os_mutex_release(&fcb->f_mtx);
     return 0;
 }
+
+/*
+ * Call 'cb' for every element in flash circular buffer. If fap is specified,
+ * only elements with that flash_area are reported.
+ */
+int
+fcb_walk(struct fcb *fcb, struct flash_area *fap, fcb_walk_cb cb, void *cb_arg)
+{
+    return fcb_walk_int(fcb, fap, cb, cb_arg, 0);
+}
+
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+int
+fcb_walk_trusted(struct fcb *fcb, struct flash_area *fap, fcb_walk_cb cb,
+  void *cb_arg)
+{
+    return fcb_walk_int(fcb, fap, cb, cb_arg, 1);
+}
+#endif
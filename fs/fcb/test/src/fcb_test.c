@@ -158,6 +158,9 @@ TEST_CASE_DECL(fcb_test_reset)
 TEST_CASE_DECL(fcb_test_rotate)
 TEST_CASE_DECL(fcb_test_multiple_scratch)
 TEST_CASE_DECL(fcb_test_last_of_n)
+TEST_CASE_DECL(fcb_test_seek)
+TEST_CASE_DECL(fcb_test_trusted_walk)
+TEST_CASE_DECL(fcb_test_batch)
 
 TEST_SUITE(fcb_test_all)
 {
@@ -190,6 +193,15 @@ TEST_SUITE(fcb_test_all)
 
     tu_case_set_pre_cb(fcb_tc_pretest, (void*)4);
     fcb_test_last_of_n();
+
+    tu_case_set_pre_cb(fcb_tc_pretest, (void*)4);
+    fcb_test_seek();
+
+    tu_case_set_pre_cb(fcb_tc_pretest, (void*)4);
+    fcb_test_trusted_walk();
+
+    tu_case_set_pre_cb(fcb_tc_pretest, (void*)2);
+    fcb_test_batch();
 }
 
 #if MYNEWT_VAL(SELFTEST)
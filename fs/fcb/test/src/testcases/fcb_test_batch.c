@@ -0,0 +1,126 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "fcb_test.h"
+
+extern int flash_native_memset(uint32_t offset, uint8_t c, uint32_t len);
+
+static int
+fcb_test_batch_cnt_cb(struct fcb_entry *loc, void *arg)
+{
+    (*(int *)arg)++;
+    return 0;
+}
+
+TEST_CASE(fcb_test_batch)
+{
+    struct fcb *fcb;
+    struct fcb_batch fb;
+    struct fcb_entry loc;
+    struct flash_area *fap;
+    uint8_t batch_buf[1024];
+    uint8_t *data;
+    uint32_t base;
+    int var_cnt;
+    int rc;
+    int i;
+    int j;
+
+    fcb = &test_fcb;
+    fcb_batch_init(&fb, batch_buf, sizeof(batch_buf));
+
+    rc = fcb_batch_commit(fcb, &fb);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(fcb_is_empty(fcb));
+
+    /*
+     * Same entries as fcb_test_append, committed a buffer at a time.
+     */
+    for (i = 0; i < 128; i++) {
+        data = fcb_batch_reserve(fcb, &fb, i);
+        if (!data) {
+            rc = fcb_batch_commit(fcb, &fb);
+            TEST_ASSERT_FATAL(rc == 0);
+            TEST_ASSERT(fb.fb_len == 0 && fb.fb_entries == 0);
+            data = fcb_batch_reserve(fcb, &fb, i);
+        }
+        TEST_ASSERT_FATAL(data != NULL);
+        for (j = 0; j < i; j++) {
+            data[j] = fcb_test_append_data(i, j);
+        }
+    }
+    rc = fcb_batch_commit(fcb, &fb);
+    TEST_ASSERT(rc == 0);
+
+    var_cnt = 0;
+    rc = fcb_walk(fcb, 0, fcb_test_data_walk_cb, &var_cnt);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(var_cnt == 128);
+
+    /*
+     * Too big to ever fit.
+     */
+    TEST_ASSERT(fcb_batch_reserve(fcb, &fb, sizeof(batch_buf)) == NULL);
+
+    /*
+     * Reset while writing a batch of three: the first entry made it, the
+     * second is partly written, the third not at all.
+     */
+    for (i = 0; i < 3; i++) {
+        data = fcb_batch_reserve(fcb, &fb, 40);
+        TEST_ASSERT_FATAL(data != NULL);
+        memset(data, i, 40);
+    }
+    fap = fcb->f_active.fe_area;
+    base = fcb->f_active.fe_elem_off;
+    rc = fcb_batch_commit(fcb, &fb);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(fcb->f_active.fe_area == fap);
+
+    flash_native_memset(fap->fa_off + base + 42 + 20, 0xff, 2 * 42 - 20);
+
+    rc = fcb_init(fcb);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    var_cnt = 0;
+    rc = fcb_walk(fcb, 0, fcb_test_batch_cnt_cb, &var_cnt);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(var_cnt == 128 + 1);
+
+    /* Appending carries on after the damaged entry. */
+    data = fcb_batch_reserve(fcb, &fb, 40);
+    TEST_ASSERT_FATAL(data != NULL);
+    memset(data, 3, 40);
+    rc = fcb_batch_commit(fcb, &fb);
+    TEST_ASSERT(rc == 0);
+
+    var_cnt = 0;
+    rc = fcb_walk(fcb, 0, fcb_test_batch_cnt_cb, &var_cnt);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(var_cnt == 128 + 2);
+
+    memset(&loc, 0, sizeof(loc));
+    while (fcb_getnext(fcb, &loc) == 0) {
+        ;
+    }
+    rc = flash_area_read(loc.fe_area, loc.fe_data_off, batch_buf, 40);
+    TEST_ASSERT(rc == 0);
+    for (i = 0; i < 40; i++) {
+        TEST_ASSERT(batch_buf[i] == 3);
+    }
+}
@@ -0,0 +1,177 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "fcb_test.h"
+
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+
+static struct fcb_sector_index fcb_test_index[4];
+
+/* Key 0 is the sequence number at the start of the entry, key 1 ten times
+ * that.
+ */
+static int
+fcb_test_index_key(struct fcb *fcb, struct fcb_entry *loc, uint64_t *keys)
+{
+    uint32_t seq;
+    int rc;
+
+    rc = flash_area_read(loc->fe_area, loc->fe_data_off, &seq, sizeof(seq));
+    if (rc) {
+        return rc;
+    }
+    keys[0] = seq;
+    keys[1] = (uint64_t)seq * 10;
+    return 0;
+}
+
+static uint32_t
+fcb_test_seq(struct fcb_entry *loc)
+{
+    uint32_t seq;
+    int rc;
+
+    rc = flash_area_read(loc->fe_area, loc->fe_data_off, &seq, sizeof(seq));
+    TEST_ASSERT_FATAL(rc == 0);
+    return seq;
+}
+
+/*
+ * Seek to value, and check that value is found while reading less than
+ * two sectors' worth of entries.
+ */
+static void
+fcb_test_seek_one(struct fcb *fcb, int key, uint32_t seq, int per_sector)
+{
+    struct fcb_entry loc;
+    uint32_t first;
+    int rc;
+
+    rc = fcb_seek(fcb, key, key == 0 ? seq : (uint64_t)seq * 10, &loc);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = fcb_getnext(fcb, &loc);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    first = fcb_test_seq(&loc);
+    TEST_ASSERT(first <= seq);
+    TEST_ASSERT(seq - first < 2 * per_sector);
+
+    while (fcb_test_seq(&loc) != seq) {
+        rc = fcb_getnext(fcb, &loc);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+}
+#endif
+
+TEST_CASE(fcb_test_seek)
+{
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+    struct fcb_sector_index saved[4];
+    struct fcb_entry loc;
+    struct fcb_entry plain;
+    struct fcb *fcb;
+    uint8_t test_data[128];
+    uint32_t seq;
+    int per_sector;
+    int rc;
+    int i;
+
+    fcb = &test_fcb;
+    fcb->f_index = fcb_test_index;
+    fcb->f_index_key = fcb_test_index_key;
+    rc = fcb_init(fcb);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = fcb_seek(fcb, 0, 0, &loc);
+    TEST_ASSERT(rc == FCB_ERR_NOVAR);
+    rc = fcb_seek(fcb, FCB_INDEX_KEYS, 0, &loc);
+    TEST_ASSERT(rc == FCB_ERR_ARGS);
+
+    /*
+     * Fill the whole FCB with numbered entries.
+     */
+    memset(test_data, 0, sizeof(test_data));
+    for (seq = 0; ; seq++) {
+        rc = fcb_append(fcb, sizeof(test_data), &loc);
+        if (rc == FCB_ERR_NOSPACE) {
+            break;
+        }
+        TEST_ASSERT_FATAL(rc == 0);
+
+        memcpy(test_data, &seq, sizeof(seq));
+        rc = flash_area_write(loc.fe_area, loc.fe_data_off, test_data,
+          sizeof(test_data));
+        TEST_ASSERT(rc == 0);
+
+        rc = fcb_append_finish(fcb, &loc);
+        TEST_ASSERT(rc == 0);
+    }
+    per_sector = fcb_test_index[0].fsi_entries;
+    TEST_ASSERT_FATAL(per_sector > 1);
+    for (i = 0; i < 4; i++) {
+        TEST_ASSERT(fcb_test_index[i].fsi_entries == per_sector);
+        TEST_ASSERT(fcb_test_index[i].fsi_key[0] == i * per_sector);
+        TEST_ASSERT(fcb_test_index[i].fsi_key[1] == i * per_sector * 10);
+    }
+
+    for (i = 0; i < seq; i += 7) {
+        fcb_test_seek_one(fcb, 0, i, per_sector);
+        fcb_test_seek_one(fcb, 1, i, per_sector);
+    }
+
+    /* Past the end; lands in the active sector. */
+    rc = fcb_seek(fcb, 0, seq + 100, &loc);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(loc.fe_area == fcb->f_active.fe_area);
+
+    /*
+     * fcb_offset_last_n() gives the same answer with and without index.
+     */
+    for (i = 1; i < 255; i += 13) {
+        rc = fcb_offset_last_n(fcb, i, &loc);
+        TEST_ASSERT(rc == 0);
+        fcb->f_index = NULL;
+        rc = fcb_offset_last_n(fcb, i, &plain);
+        fcb->f_index = fcb_test_index;
+        TEST_ASSERT(rc == 0);
+        TEST_ASSERT(loc.fe_area == plain.fe_area);
+        TEST_ASSERT(loc.fe_elem_off == plain.fe_elem_off);
+    }
+
+    /*
+     * Rotating drops the oldest sector from the index.
+     */
+    rc = fcb_rotate(fcb);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(fcb_test_index[0].fsi_entries == 0);
+    rc = fcb_seek(fcb, 0, 0, &loc);
+    TEST_ASSERT(rc == 0);
+    rc = fcb_getnext(fcb, &loc);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(fcb_test_seq(&loc) == per_sector);
+
+    /*
+     * Index rebuilt at init matches the one kept while appending.
+     */
+    memcpy(saved, fcb_test_index, sizeof(saved));
+    memset(fcb_test_index, 0xff, sizeof(fcb_test_index));
+    rc = fcb_init(fcb);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(memcmp(saved, fcb_test_index, sizeof(saved)) == 0);
+#endif
+}
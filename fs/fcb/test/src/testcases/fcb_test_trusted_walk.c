@@ -0,0 +1,115 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "fcb_test.h"
+
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+extern int flash_native_memset(uint32_t offset, uint8_t c, uint32_t len);
+#endif
+
+TEST_CASE(fcb_test_trusted_walk)
+{
+#if MYNEWT_VAL(FCB_TRUSTED_WALK)
+    struct fcb *fcb;
+    struct fcb_entry loc;
+    struct fcb_entry bad;
+    uint8_t test_data[128];
+    int elem_cnts[4] = { 0 };
+    int cnts[4];
+    int rc;
+    struct append_arg aa_arg = {
+        .elem_cnts = cnts
+    };
+
+    fcb = &test_fcb;
+
+    /*
+     * Fill two sectors, and start the third.
+     */
+    memset(test_data, 0xa5, sizeof(test_data));
+    while (elem_cnts[2] < 2) {
+        rc = fcb_append(fcb, sizeof(test_data), &loc);
+        TEST_ASSERT_FATAL(rc == 0);
+        elem_cnts[loc.fe_area - test_fcb_area]++;
+
+        rc = flash_area_write(loc.fe_area, loc.fe_data_off, test_data,
+          sizeof(test_data));
+        TEST_ASSERT(rc == 0);
+
+        rc = fcb_append_finish(fcb, &loc);
+        TEST_ASSERT(rc == 0);
+        if (elem_cnts[0] == 3 && elem_cnts[1] == 0) {
+            bad = loc;
+        }
+    }
+    TEST_ASSERT(fcb->f_verified == 0);
+
+    /*
+     * A full walk verifies the sectors which are not active.
+     */
+    memset(cnts, 0, sizeof(cnts));
+    rc = fcb_walk(fcb, NULL, fcb_test_cnt_elems_cb, &aa_arg);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(memcmp(cnts, elem_cnts, sizeof(cnts)) == 0);
+    TEST_ASSERT(fcb->f_verified == 0x3);
+
+    /*
+     * Damage an entry in a verified sector. A trusted walk does not
+     * notice, a normal one skips the entry.
+     */
+    rc = flash_native_memset(bad.fe_area->fa_off + bad.fe_data_off, 0, 1);
+    TEST_ASSERT(rc == 0);
+
+    memset(cnts, 0, sizeof(cnts));
+    rc = fcb_walk_trusted(fcb, NULL, fcb_test_cnt_elems_cb, &aa_arg);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(memcmp(cnts, elem_cnts, sizeof(cnts)) == 0);
+
+    memset(cnts, 0, sizeof(cnts));
+    rc = fcb_walk(fcb, NULL, fcb_test_cnt_elems_cb, &aa_arg);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cnts[0] == elem_cnts[0] - 1);
+
+    /*
+     * Sector with a bad entry does not get verified again.
+     */
+    rc = fcb_init(fcb);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(fcb->f_verified == 0);
+    memset(cnts, 0, sizeof(cnts));
+    rc = fcb_walk_trusted(fcb, NULL, fcb_test_cnt_elems_cb, &aa_arg);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cnts[0] == elem_cnts[0] - 1);
+    TEST_ASSERT(fcb->f_verified == 0x2);
+
+    /*
+     * Erasing a sector forgets it.
+     */
+    rc = fcb_rotate(fcb);
+    TEST_ASSERT(rc == 0);
+    rc = fcb_rotate(fcb);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(fcb->f_verified == 0);
+
+    memset(cnts, 0, sizeof(cnts));
+    rc = fcb_walk_trusted(fcb, NULL, fcb_test_cnt_elems_cb, &aa_arg);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cnts[0] == 0 && cnts[1] == 0);
+    TEST_ASSERT(cnts[2] == elem_cnts[2]);
+#endif
+}
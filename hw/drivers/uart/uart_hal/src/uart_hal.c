@@ -28,6 +28,31 @@
 
 #include "uart_hal/uart_hal.h"
 
+#if MYNEWT_VAL(UART_HAL_RX_BUF_SIZE) > 0
+#include "spsc_ring/spsc_ring.h"
+
+/*
+ * Receive state of a port with an RX ring.  The HAL interrupt fills the ring
+ * and the default event queue passes the bytes on to the uc_rx_char callback.
+ * The HAL takes a single callback argument, so the TX callbacks are routed
+ * through here as well.
+ */
+struct uart_hal_rx {
+    struct spsc_ring uhr_ring;
+    struct os_event uhr_ev;
+    int uhr_port;
+    uart_tx_char uhr_tx_char;
+    uart_tx_done uhr_tx_done;
+    uart_rx_char uhr_rx_char;
+    void *uhr_cb_arg;
+    /* Set when the HAL was told to stop RX because the ring was full. */
+    volatile uint8_t uhr_stalled;
+    uint8_t uhr_buf[MYNEWT_VAL(UART_HAL_RX_BUF_SIZE)];
+};
+
+static struct uart_hal_rx uart_hal_rx[MYNEWT_VAL(UART_HAL_RX_PORTS)];
+#endif
+
 inline static int
 uart_hal_dev_get_id(struct uart_dev *dev)
 {
@@ -40,6 +65,98 @@ uart_hal_dev_set_id(struct uart_dev *dev, int id)
     dev->ud_priv = (void *)((intptr_t)(id + 1));
 }
 
+#if MYNEWT_VAL(UART_HAL_RX_BUF_SIZE) > 0
+static struct uart_hal_rx *
+uart_hal_rx_get(struct uart_dev *dev)
+{
+    int id;
+
+    id = uart_hal_dev_get_id(dev);
+    if (id >= MYNEWT_VAL(UART_HAL_RX_PORTS)) {
+        return NULL;
+    }
+    return &uart_hal_rx[id];
+}
+
+static int
+uart_hal_rx_tx_char(void *arg)
+{
+    struct uart_hal_rx *rx = arg;
+
+    return rx->uhr_tx_char(rx->uhr_cb_arg);
+}
+
+static void
+uart_hal_rx_tx_done(void *arg)
+{
+    struct uart_hal_rx *rx = arg;
+
+    if (rx->uhr_tx_done) {
+        rx->uhr_tx_done(rx->uhr_cb_arg);
+    }
+}
+
+/*
+ * Called by the HAL with interrupts disabled.
+ */
+static int
+uart_hal_rx_rx_char(void *arg, uint8_t byte)
+{
+    struct uart_hal_rx *rx = arg;
+
+    if (spsc_ring_put(&rx->uhr_ring, byte)) {
+        rx->uhr_stalled = 1;
+        return -1;
+    }
+
+    if (!rx->uhr_ev.ev_queued) {
+        os_eventq_put(os_eventq_dflt_get(), &rx->uhr_ev);
+    }
+
+    return 0;
+}
+
+/*
+ * Releases consumed bytes back to the ring, and restarts the HAL if it was
+ * stopped because the ring had filled up.
+ */
+static void
+uart_hal_rx_consumed(struct uart_hal_rx *rx, uint32_t len)
+{
+    spsc_ring_read_commit(&rx->uhr_ring, len);
+
+    if (rx->uhr_stalled) {
+        rx->uhr_stalled = 0;
+        hal_uart_start_rx(rx->uhr_port);
+    }
+}
+
+static void
+uart_hal_rx_event(struct os_event *ev)
+{
+    struct uart_hal_rx *rx;
+    uint8_t *data;
+    uint32_t len;
+    uint32_t i;
+
+    rx = ev->ev_arg;
+
+    while ((len = spsc_ring_read_reserve(&rx->uhr_ring, (void **)&data)) > 0) {
+        for (i = 0; i < len; i++) {
+            if (rx->uhr_rx_char(rx->uhr_cb_arg, data[i]) < 0) {
+                /*
+                 * The byte stays in the ring until the user calls
+                 * uart_start_rx().
+                 */
+                uart_hal_rx_consumed(rx, i);
+                return;
+            }
+        }
+        uart_hal_rx_consumed(rx, len);
+    }
+}
+#endif
+
 static void
 uart_hal_start_tx(struct uart_dev *dev)
 {
@@ -51,8 +168,21 @@ uart_hal_start_tx(struct uart_dev *dev)
 static void
 uart_hal_start_rx(struct uart_dev *dev)
 {
+#if MYNEWT_VAL(UART_HAL_RX_BUF_SIZE) > 0
+    struct uart_hal_rx *rx;
+#endif
+
     assert(dev->ud_priv);
 
+#if MYNEWT_VAL(UART_HAL_RX_BUF_SIZE) > 0
+    rx = uart_hal_rx_get(dev);
+    if (rx && rx->uhr_rx_char) {
+        /* Deliver what is queued; the HAL is restarted once there is room. */
+        os_eventq_put(os_eventq_dflt_get(), &rx->uhr_ev);
+        return;
+    }
+#endif
+
     hal_uart_start_rx(uart_hal_dev_get_id(dev));
 }
 
@@ -69,6 +199,13 @@ uart_hal_open(struct os_dev *odev, uint32_t wait, void *arg)
 {
     struct uart_conf *uc;
     struct uart_dev *dev;
+    hal_uart_tx_char tx_char;
+    hal_uart_tx_done tx_done;
+    hal_uart_rx_char rx_char;
+    void *cb_arg;
+#if MYNEWT_VAL(UART_HAL_RX_BUF_SIZE) > 0
+    struct uart_hal_rx *rx;
+#endif
     int rc;
 
     dev = (struct uart_dev *)odev;
@@ -89,8 +226,34 @@ uart_hal_open(struct os_dev *odev, uint32_t wait, void *arg)
     dev->ud_conf_port.uc_speed = uc->uc_speed;
     dev->ud_conf_port.uc_stopbits = uc->uc_stopbits;
 
-    rc = hal_uart_init_cbs(uart_hal_dev_get_id(dev), uc->uc_tx_char, uc->uc_tx_done,
-                           uc->uc_rx_char, uc->uc_cb_arg);
+    tx_char = uc->uc_tx_char;
+    tx_done = uc->uc_tx_done;
+    rx_char = uc->uc_rx_char;
+    cb_arg = uc->uc_cb_arg;
+
+#if MYNEWT_VAL(UART_HAL_RX_BUF_SIZE) > 0
+    rx = uart_hal_rx_get(dev);
+    if (rx && uc->uc_rx_char) {
+        os_eventq_remove(os_eventq_dflt_get(), &rx->uhr_ev);
+        spsc_ring_init(&rx->uhr_ring, rx->uhr_buf, sizeof(rx->uhr_buf));
+        rx->uhr_ev.ev_cb = uart_hal_rx_event;
+        rx->uhr_ev.ev_arg = rx;
+        rx->uhr_port = uart_hal_dev_get_id(dev);
+        rx->uhr_tx_char = uc->uc_tx_char;
+        rx->uhr_tx_done = uc->uc_tx_done;
+        rx->uhr_rx_char = uc->uc_rx_char;
+        rx->uhr_cb_arg = uc->uc_cb_arg;
+        rx->uhr_stalled = 0;
+
+        tx_char = uc->uc_tx_char ? uart_hal_rx_tx_char : NULL;
+        tx_done = uart_hal_rx_tx_done;
+        rx_char = uart_hal_rx_rx_char;
+        cb_arg = rx;
+    }
+#endif
+
+    rc = hal_uart_init_cbs(uart_hal_dev_get_id(dev), tx_char, tx_done,
+                           rx_char, cb_arg);
     if (rc) {
         return OS_EINVAL;
     }
@@ -115,6 +278,12 @@ uart_hal_close(struct os_dev *odev)
         return OS_EINVAL;
     }
 
+#if MYNEWT_VAL(UART_HAL_RX_BUF_SIZE) > 0
+    if (uart_hal_rx_get(dev)) {
+        os_eventq_remove(os_eventq_dflt_get(), &uart_hal_rx_get(dev)->uhr_ev);
+    }
+#endif
+
     return OS_OK;
 }
 
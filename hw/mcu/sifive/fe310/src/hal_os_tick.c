@@ -48,12 +48,20 @@ os_tick_init(uint32_t os_ticks_per_sec, int prio)
 void
 timer_interrupt_handler(void)
 {
-    uint64_t time = get_timer_value();
-    int delta = (int)(time - last_tick_time);
+    uint64_t time;
+    int delta;
+    int ticks;
+
+    os_trace_isr_enter();
+
+    time = get_timer_value();
+    delta = (int)(time - last_tick_time);
     last_tick_time = time;
 
-    int ticks = delta / ticks_per_ostick;
+    ticks = delta / ticks_per_ostick;
     set_mtimecmp(time + ticks_per_ostick);
 
     os_time_advance(ticks);
+
+    os_trace_isr_exit();
 }
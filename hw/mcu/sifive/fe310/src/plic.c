@@ -51,7 +51,11 @@ plic_disable_interrupt(int int_num)
 void
 external_interrupt_handler(uintptr_t mcause)
 {
-    int num = PLIC_REG(PLIC_CLAIM_OFFSET);
+    int num;
+
+    os_trace_isr_enter();
+
+    num = PLIC_REG(PLIC_CLAIM_OFFSET);
     /*
      * Interrupts have some overhead, handle all pending interrupts.
      */
@@ -63,4 +67,6 @@ external_interrupt_handler(uintptr_t mcause)
         /* Check if other interupt is already pending */
         num = PLIC_REG(PLIC_CLAIM_OFFSET);
     }
+
+    os_trace_isr_exit();
 }
@@ -21,6 +21,7 @@
 #include <errno.h>
 #include <assert.h>
 #include "os/mynewt.h"
+#include "rwlock/rwlock.h"
 #include "sensor/sensor.h"
 #include "sensor_priv.h"
 #include "sensor/accel.h"
@@ -52,7 +53,10 @@ os_time_t smgr_wakeup[500];
 #endif
 
 struct {
-    struct os_mutex mgr_lock;
+    struct rwlock mgr_lock;
+    /* Task holding mgr_lock for writing, and how many times it has taken it */
+    struct os_task *mgr_lock_owner;
+    int mgr_lock_depth;
 
     struct os_callout mgr_wakeup_callout;
     struct os_eventq *mgr_eventq;
@@ -83,17 +87,27 @@ static uint8_t sensor_notify_evt_area[OS_MEMPOOL_BYTES(MYNEWT_VAL(SENSOR_NOTIF_E
 
 /**
  * Lock sensor manager to access the list of sensors
+ *
+ * The lock is exclusive, and may be taken again by the task holding it.
+ * Lookups which do not change the list only take it for reading.
  */
 int
 sensor_mgr_lock(void)
 {
-    int rc;
+    struct os_task *t;
 
-    rc = os_mutex_pend(&sensor_mgr.mgr_lock, OS_TIMEOUT_NEVER);
-    if (rc == 0 || rc == OS_NOT_STARTED) {
+    if (!os_started()) {
         return (0);
     }
-    return (rc);
+
+    t = os_sched_get_current_task();
+    if (sensor_mgr.mgr_lock_owner != t) {
+        rwlock_acquire_write(&sensor_mgr.mgr_lock);
+        sensor_mgr.mgr_lock_owner = t;
+    }
+    sensor_mgr.mgr_lock_depth++;
+
+    return (0);
 }
 
 /**
@@ -102,7 +116,43 @@ sensor_mgr_lock(void)
 void
 sensor_mgr_unlock(void)
 {
-    (void) os_mutex_release(&sensor_mgr.mgr_lock);
+    if (!os_started()) {
+        return;
+    }
+
+    assert(sensor_mgr.mgr_lock_owner == os_sched_get_current_task());
+    if (--sensor_mgr.mgr_lock_depth == 0) {
+        sensor_mgr.mgr_lock_owner = NULL;
+        rwlock_release_write(&sensor_mgr.mgr_lock);
+    }
+}
+
+/**
+ * Lock the list of sensors for a lookup.  Nothing is taken if the calling
+ * task already holds the list through sensor_mgr_lock().
+ *
+ * @return true if the read lock was taken and must be released with
+ *         sensor_mgr_unlock_read().
+ */
+static bool
+sensor_mgr_lock_read(void)
+{
+    /* Only the owning task itself can see its own task as the owner. */
+    if (!os_started() ||
+        sensor_mgr.mgr_lock_owner == os_sched_get_current_task()) {
+        return false;
+    }
+
+    rwlock_acquire_read(&sensor_mgr.mgr_lock);
+    return true;
+}
+
+static void
+sensor_mgr_unlock_read(bool locked)
+{
+    if (locked) {
+        rwlock_release_read(&sensor_mgr.mgr_lock);
+    }
 }
 
 static void
@@ -329,16 +379,17 @@ static struct sensor *
 sensor_find_min_nextrun_sensor(os_time_t now, os_time_t *min_nextrun)
 {
     struct sensor *head;
+    bool locked;
 
     head = NULL;
 
-    sensor_mgr_lock();
+    locked = sensor_mgr_lock_read();
 
     head = SLIST_FIRST(&sensor_mgr.mgr_sensor_list);
 
     *min_nextrun = sensor_calc_nextrun_delta(head, now);
 
-    sensor_mgr_unlock();
+    sensor_mgr_unlock_read(locked);
 
     return head;
 
@@ -678,7 +729,7 @@ sensor_mgr_init(void)
             sensor_base_ts_update_event, NULL);
     os_callout_reset(&st_up_osco, OS_TICKS_PER_SEC);
 
-    os_mutex_init(&sensor_mgr.mgr_lock);
+    rwlock_init(&sensor_mgr.mgr_lock);
 }
 
 /**
@@ -706,15 +757,9 @@ sensor_mgr_find_next(sensor_mgr_compare_func_t compare_func, void *arg,
         struct sensor *prev_cursor)
 {
     struct sensor *cursor;
-    int rc;
+    bool locked;
 
-    cursor = NULL;
-
-    /* Couldn't acquire lock of sensor list, exit */
-    rc = sensor_mgr_lock();
-    if (rc != 0) {
-        goto done;
-    }
+    locked = sensor_mgr_lock_read();
 
     cursor = prev_cursor;
     if (cursor == NULL) {
@@ -730,9 +775,8 @@ sensor_mgr_find_next(sensor_mgr_compare_func_t compare_func, void *arg,
         cursor = SLIST_NEXT(cursor, s_next);
     }
 
-    sensor_mgr_unlock();
+    sensor_mgr_unlock_read(locked);
 
-done:
     return (cursor);
 }
 
@@ -719,12 +719,8 @@ sensor_oic_init(void)
 
     while (1) {
 
-        sensor_mgr_lock();
-
         sensor = sensor_mgr_find_next_bytype(SENSOR_TYPE_ALL, sensor);
 
-        sensor_mgr_unlock();
-
         if (sensor == NULL) {
             /* Sensor not found */
             break;
@@ -108,6 +108,7 @@ void os_init(int (*fn)(int argc, char **argv));
 void os_start(void);
 
 #include "os/endian.h"
+#include "os/os_alloc_trace.h"
 #include "os/os_callout.h"
 #include "os/os_cfg.h"
 #include "os/os_cputime.h"
@@ -125,6 +126,7 @@ void os_start(void);
 #include "os/os_task.h"
 #include "os/os_time.h"
 #include "os/os_trace_api.h"
+#include "os/os_workq.h"
 #include "os/queue.h"
 #include "os/util.h"
 
@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * @addtogroup OSKernel
+ * @{
+ *   @defgroup OSAllocTrace Allocation Tracing
+ *   @{
+ */
+
+#ifndef H_OS_ALLOC_TRACE_
+#define H_OS_ALLOC_TRACE_
+
+#include <stdint.h>
+#include "syscfg/syscfg.h"
+#include "os/os_time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Allocation trace record types */
+#define OS_ALLOC_TRACE_MALLOC           1
+#define OS_ALLOC_TRACE_FREE             2
+#define OS_ALLOC_TRACE_MEMBLOCK_GET     3
+#define OS_ALLOC_TRACE_MEMBLOCK_PUT     4
+#define OS_ALLOC_TRACE_MBUF_GET         5
+#define OS_ALLOC_TRACE_MBUF_FREE        6
+
+/**
+ * One allocation or free, as stored in the trace ring.
+ */
+struct os_alloc_trace_rec {
+    /** The memory allocated or freed */
+    uintptr_t oatr_ptr;
+    /** Return address of the allocating or freeing call */
+    uintptr_t oatr_caller;
+    /** Requested size in bytes; 0 for frees */
+    uint32_t oatr_size;
+    /** os_time_get() at the time of the call */
+    os_time_t oatr_time;
+    /** OS_ALLOC_TRACE_[...] */
+    uint8_t oatr_type;
+};
+
+/**
+ * Allocations still outstanding in the trace ring that were made by one call
+ * site.
+ */
+struct os_alloc_trace_site {
+    /** Return address of the allocating call */
+    uintptr_t oats_caller;
+    /** Number of outstanding allocations */
+    uint32_t oats_count;
+    /** Total size of the outstanding allocations */
+    uint32_t oats_bytes;
+    /** Time of the oldest outstanding allocation */
+    os_time_t oats_oldest;
+    /** OS_ALLOC_TRACE_[...] type of the allocations */
+    uint8_t oats_type;
+};
+
+/**
+ * Called by os_alloc_trace_sites() for each call site.  A non-zero return
+ * stops the walk.
+ */
+typedef int os_alloc_trace_site_fn(const struct os_alloc_trace_site *oats,
+                                   void *arg);
+
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+
+/**
+ * Group the allocations in the trace ring that have not been freed by call
+ * site, and call fn for each site.  An allocation counts as outstanding if no
+ * later record in the ring frees the same memory; once the ring has wrapped,
+ * allocations older than its oldest record are not seen.  Tracing is paused
+ * during the walk; allocations made meanwhile are counted as dropped.
+ *
+ * @param fn  Function to call for each call site.
+ * @param arg Argument to pass to fn.
+ *
+ * @return 0 on success; the non-zero value returned by fn otherwise.
+ */
+int os_alloc_trace_sites(os_alloc_trace_site_fn *fn, void *arg);
+
+/**
+ * Get the number of records that were not traced because tracing was paused
+ * by os_alloc_trace_sites().
+ */
+uint32_t os_alloc_trace_dropped(void);
+
+/**
+ * Discard all trace records.
+ */
+void os_alloc_trace_clear(void);
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+void os_alloc_trace_record(uint8_t type, const void *ptr, uint32_t size,
+                           const void *caller);
+/**
+ * @endcond
+ */
+
+/**
+ * Records an allocation or free made by the caller of the current function.
+ * Expands to nothing unless OS_ALLOC_TRACE is enabled.
+ */
+#define OS_ALLOC_TRACE(type, ptr, size)                                     \
+    os_alloc_trace_record((type), (ptr), (size), __builtin_return_address(0))
+
+#else
+
+#define OS_ALLOC_TRACE(type, ptr, size)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_OS_ALLOC_TRACE_ */
+
+/**
+ *   @} OSAllocTrace
+ * @} OSKernel
+ */
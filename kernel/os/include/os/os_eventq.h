@@ -29,6 +29,7 @@
 #define _OS_EVENTQ_H
 
 #include <inttypes.h>
+#include "syscfg/syscfg.h"
 #include "os/os_time.h"
 #include "os/queue.h"
 
@@ -46,6 +47,10 @@ typedef void os_event_fn(struct os_event *ev);
 struct os_event {
     /** Whether this OS event is queued on an event queue. */
     uint8_t ev_queued;
+#if MYNEWT_VAL(OS_EVENTQ_PRIO_LEVELS) > 1
+    /** Priority level the event is queued at; set by os_eventq_put_prio(). */
+    uint8_t ev_prio;
+#endif
     /**
      * Callback to call when the event is taken off of an event queue.
      * APIs, except for os_eventq_run(), assume this callback will be called by
@@ -54,6 +59,10 @@ struct os_event {
     os_event_fn *ev_cb;
     /** Argument to pass to the event queue callback. */
     void *ev_arg;
+#if MYNEWT_VAL(OS_EVENTQ_STATS) || MYNEWT_VAL(OS_EVENTQ_PROF)
+    /** os_cputime at which the event was queued. */
+    uint32_t ev_put_time;
+#endif
 
 
     STAILQ_ENTRY(os_event) ev_next;
@@ -62,6 +71,32 @@ struct os_event {
 /** Return whether or not the given event is queued. */
 #define OS_EVENT_QUEUED(__ev) ((__ev)->ev_queued)
 
+/** Number of event queue priority levels. */
+#define OS_EVENTQ_PRIO_LEVELS   MYNEWT_VAL(OS_EVENTQ_PRIO_LEVELS)
+#if OS_EVENTQ_PRIO_LEVELS < 1 || OS_EVENTQ_PRIO_LEVELS > 9
+#error "OS_EVENTQ_PRIO_LEVELS must be between 1 and 9"
+#endif
+/** Highest event queue priority. */
+#define OS_EVENTQ_PRIO_HIGHEST  0
+/** Priority used by os_eventq_put(); also the lowest priority. */
+#define OS_EVENTQ_PRIO_DFLT     (OS_EVENTQ_PRIO_LEVELS - 1)
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+/**
+ * Event queue instrumentation.  Times are in os_cputime ticks.
+ */
+struct os_eventq_stats {
+    /** Number of events currently queued. */
+    uint16_t oes_depth;
+    /** Largest number of events queued at once. */
+    uint16_t oes_max_depth;
+    /** Longest time an event spent queued before it was pulled. */
+    uint32_t oes_max_dwell;
+    /** Longest event callback run by os_eventq_run(). */
+    uint32_t oes_max_cb_time;
+};
+#endif
+
 struct os_eventq {
     /** Pointer to task that "owns" this event queue. */
     struct os_task *evq_owner;
@@ -72,8 +107,40 @@ struct os_eventq {
     struct os_task *evq_task;
 
 
+    /** Events queued at the default (lowest) priority. */
     STAILQ_HEAD(, os_event) evq_list;
+#if MYNEWT_VAL(OS_EVENTQ_PRIO_LEVELS) > 1
+    /** Events queued at priorities above the default, highest first. */
+    STAILQ_HEAD(, os_event) evq_prio[OS_EVENTQ_PRIO_LEVELS - 1];
+    /** Bit N set when evq_prio[N] is non-empty. */
+    uint8_t evq_prio_map;
+#endif
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    struct os_eventq_stats evq_stats;
+    /** Name given by os_eventq_register(), NULL if not registered. */
+    const char *evq_name;
+    STAILQ_ENTRY(os_eventq) evq_next;
+#endif
+};
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+/**
+ * Information describing a registered event queue, filled out by
+ * os_eventq_info_get_next().
+ */
+struct os_eventq_info {
+    /** Name the event queue was registered with */
+    const char *oei_name;
+    /** Number of events currently queued */
+    uint16_t oei_depth;
+    /** Largest number of events queued at once */
+    uint16_t oei_max_depth;
+    /** Longest time an event waited on the queue, in microseconds */
+    uint32_t oei_max_dwell_us;
+    /** Longest callback run by os_eventq_run(), in microseconds */
+    uint32_t oei_max_cb_us;
 };
+#endif
 
 
 /**
@@ -98,6 +165,22 @@ int os_eventq_inited(const struct os_eventq *evq);
  */
 void os_eventq_put(struct os_eventq *, struct os_event *);
 
+/**
+ * Put an event on the event queue at the given priority.  Events are pulled
+ * off the queue highest priority first, and in FIFO order within a priority
+ * level.  os_eventq_put() queues at OS_EVENTQ_PRIO_DFLT.
+ *
+ * If the event is already queued, it is left at its current position.
+ *
+ * @param evq The event queue to put an event on
+ * @param ev The event to put on the queue
+ * @param prio The priority, from OS_EVENTQ_PRIO_HIGHEST (0) to
+ *             OS_EVENTQ_PRIO_DFLT (OS_EVENTQ_PRIO_LEVELS - 1).  Values
+ *             past OS_EVENTQ_PRIO_DFLT are treated as OS_EVENTQ_PRIO_DFLT.
+ */
+void os_eventq_put_prio(struct os_eventq *evq, struct os_event *ev,
+                        uint8_t prio);
+
 /**
  * Poll an event from the event queue and return it immediately.
  * If no event is available, don't block, just return NULL.
@@ -154,6 +237,93 @@ void os_eventq_remove(struct os_eventq *, struct os_event *);
  */
 struct os_eventq *os_eventq_dflt_get(void);
 
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+/**
+ * Register an event queue under the given name, so that its statistics are
+ * reported by os_eventq_info_get_next().  Registering an already registered
+ * queue only changes its name.  Registration survives os_eventq_init().
+ *
+ * @param evq The event queue to register
+ * @param name The name to report the event queue under
+ *
+ * @return 0 on success, OS_INVALID_PARM on bad arguments.
+ */
+int os_eventq_register(struct os_eventq *evq, const char *name);
+
+/**
+ * Clear the maximum depth, dwell and callback time statistics of an event
+ * queue.
+ *
+ * @param evq The event queue to clear statistics of
+ */
+void os_eventq_stats_clear(struct os_eventq *evq);
+
+/**
+ * Get information about the next registered event queue.
+ *
+ * @param prev The previous event queue returned by os_eventq_info_get_next(),
+ *             or NULL to begin iteration.
+ * @param oei  The event queue information structure to fill out.
+ *
+ * @return A pointer to the event queue that has been read, or NULL when
+ *         finished.
+ */
+struct os_eventq *os_eventq_info_get_next(const struct os_eventq *prev,
+                                          struct os_eventq_info *oei);
+#endif
+
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+/**
+ * Profile of one event callback, as run by os_eventq_run().  Times are in
+ * microseconds.
+ */
+struct os_eventq_prof_info {
+    /** The event callback */
+    os_event_fn *oepi_cb;
+    /** Number of times the callback was run */
+    uint32_t oepi_count;
+    /** Longest single run of the callback */
+    uint32_t oepi_run_max_us;
+    /** Longest time an event for the callback waited on its queue */
+    uint32_t oepi_wait_max_us;
+    /** Total time spent in the callback */
+    uint64_t oepi_run_total_us;
+    /** Total time events for the callback waited on their queues */
+    uint64_t oepi_wait_total_us;
+};
+
+/**
+ * Get the profile of the next event callback.
+ *
+ * @param prev The value returned by the previous call, or -1 to begin
+ *             iteration.
+ * @param oepi The profile structure to fill out.
+ *
+ * @return A value to pass as prev to the next call, or -1 when finished.
+ */
+int os_eventq_prof_info_get_next(int prev, struct os_eventq_prof_info *oepi);
+
+/**
+ * Get the number of callback runs that were not profiled because the
+ * profile table was full.
+ */
+uint32_t os_eventq_prof_overflow(void);
+
+/**
+ * Forget all profiled callbacks.
+ */
+void os_eventq_prof_clear(void);
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+void os_eventq_prof_record(os_event_fn *cb, uint32_t wait_ticks,
+                           uint32_t run_ticks);
+/**
+ * @endcond
+ */
+#endif
+
 /**
  * @cond INTERNAL_HIDDEN
  * [DEPRECATED]
@@ -30,11 +30,34 @@
 #define H_OS_HEAP_
 
 #include <stddef.h>
+#include <stdint.h>
+#include "syscfg/syscfg.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+struct os_task;
+
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+/* Small allocation size classes: 16, 32, 64 and 128 bytes */
+#define OS_MALLOC_CACHE_CLASSES     4
+#define OS_MALLOC_CACHE_MIN_SHIFT   4
+#define OS_MALLOC_CACHE_MAX_SIZE    \
+    (1 << (OS_MALLOC_CACHE_MIN_SHIFT + OS_MALLOC_CACHE_CLASSES - 1))
+
+/**
+ * Per-task cache of free small allocation blocks, kept in struct os_task.
+ * Each class is a singly linked list threaded through the free blocks
+ * themselves.  Only the owning task touches its cache, so no locking is
+ * needed.
+ */
+struct os_malloc_cache {
+    void *omc_head[OS_MALLOC_CACHE_CLASSES];
+    uint8_t omc_cnt[OS_MALLOC_CACHE_CLASSES];
+};
+#endif
+
 
 /**
  * Operating system level malloc().   This ensures that a safe malloc occurs
@@ -42,6 +65,12 @@ extern "C" {
  * libc's malloc() implementation, which is not guaranteed to be thread-safe.
  * This malloc() will always be thread-safe.
  *
+ * With OS_MALLOC_TASK_CACHE enabled, requests of up to
+ * OS_MALLOC_CACHE_MAX_SIZE bytes are served from shared size class pools
+ * through a cache kept in the calling task, without taking the heap mutex.
+ * os_malloc(), os_free() and os_realloc() must not be called from interrupt
+ * context.
+ *
  * @param size The number of bytes to allocate
  *
  * @return A pointer to the memory region allocated.
@@ -70,6 +99,16 @@ void os_free(void *mem);
  */
 void *os_realloc(void *ptr, size_t size);
 
+/**
+ * Returns all blocks held in a task's allocation cache to the shared pools.
+ * Called by os_task_remove(); a task may also call it on itself to give
+ * back memory after a burst of small allocations.  Does nothing unless
+ * OS_MALLOC_TASK_CACHE is enabled.
+ *
+ * @param t The task whose cache to flush
+ */
+void os_malloc_task_flush(struct os_task *t);
+
 #ifdef __cplusplus
 }
 #endif
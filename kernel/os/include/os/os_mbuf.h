@@ -94,6 +94,14 @@ struct os_mbuf {
      * Length of data in this buffer
      */
     uint16_t om_len;
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+    /**
+     * Number of mbufs using this mbuf's buffer, this one included.  The
+     * buffer is returned to its pool when this drops to zero.  Kept here,
+     * in the gap before om_omp, so that no padding follows om_databuf.
+     */
+    uint16_t om_refcnt;
+#endif
 
     /**
      * The mbuf pool this mbuf was allocated out of
@@ -102,12 +110,44 @@ struct os_mbuf {
 
     SLIST_ENTRY(os_mbuf) om_next;
 
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+    /**
+     * For a clone, the mbuf whose buffer holds the data; NULL if the data
+     * lives in this mbuf's own buffer.
+     */
+    struct os_mbuf *om_shared;
+#endif
+
     /**
      * Pointer to the beginning of the data, after this buffer
      */
     uint8_t om_databuf[0];
 };
 
+/**
+ * A contiguous run of bytes, either inside an mbuf chain (as returned by
+ * os_mbuf_iter_next()) or in a flat buffer (as passed to os_mbuf_appendv()).
+ */
+struct os_mbuf_iovec {
+    /** Start of the data */
+    void *omi_base;
+    /** Number of bytes at omi_base */
+    uint16_t omi_len;
+};
+
+/**
+ * Iterator over a byte range of an mbuf chain.  Initialize with
+ * os_mbuf_iter_init(); the fields are private.
+ */
+struct os_mbuf_iter {
+    /** Mbuf holding the next segment */
+    const struct os_mbuf *omit_om;
+    /** Offset of the next segment within omit_om */
+    uint16_t omit_off;
+    /** Bytes of the requested range not yet returned */
+    int omit_left;
+};
+
 /**
  * Structure representing a queue of mbufs.
  */
@@ -173,6 +213,31 @@ struct os_mqueue {
     ((om)->om_pkthdr_len - sizeof (struct os_mbuf_pkthdr))
 
 
+/** @cond INTERNAL_HIDDEN */
+
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+/* The mbuf whose buffer holds the data of the given mbuf. */
+#define _OS_MBUF_BUF(__om) \
+    ((__om)->om_shared != NULL ? (__om)->om_shared : (__om))
+#else
+#define _OS_MBUF_BUF(__om) (__om)
+#endif
+
+/** @endcond */
+
+/**
+ * Checks whether the data of an mbuf is also referenced by another mbuf, in
+ * which case it must not be written to; see os_mbuf_clone().  Always false
+ * unless OS_MBUF_CLONE is enabled.
+ *
+ * @param __om The mbuf to check
+ */
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+#define OS_MBUF_IS_SHARED(__om) (_OS_MBUF_BUF(__om)->om_refcnt > 1)
+#else
+#define OS_MBUF_IS_SHARED(__om) (0)
+#endif
+
 /** @cond INTERNAL_HIDDEN */
 
 /*
@@ -181,16 +246,24 @@ struct os_mqueue {
 static inline uint16_t
 _os_mbuf_leadingspace(struct os_mbuf *om)
 {
+    struct os_mbuf *buf;
     uint16_t startoff;
     uint16_t leadingspace;
 
+    /* Shared data is read-only; there is no room to grow into. */
+    if (OS_MBUF_IS_SHARED(om)) {
+        return 0;
+    }
+
+    buf = _OS_MBUF_BUF(om);
+
     startoff = 0;
-    if (OS_MBUF_IS_PKTHDR(om)) {
-        startoff = om->om_pkthdr_len;
+    if (OS_MBUF_IS_PKTHDR(buf)) {
+        startoff = buf->om_pkthdr_len;
     }
 
     leadingspace = (uint16_t) (OS_MBUF_DATA(om, uint8_t *) -
-        ((uint8_t *) &om->om_databuf[0] + startoff));
+        ((uint8_t *) &buf->om_databuf[0] + startoff));
 
     return (leadingspace);
 }
@@ -217,10 +290,16 @@ static inline uint16_t
 _os_mbuf_trailingspace(struct os_mbuf *om)
 {
     struct os_mbuf_pool *omp;
+    struct os_mbuf *buf;
 
-    omp = om->om_omp;
+    if (OS_MBUF_IS_SHARED(om)) {
+        return 0;
+    }
 
-    return (&om->om_databuf[0] + omp->omp_databuf_len) -
+    buf = _OS_MBUF_BUF(om);
+    omp = buf->om_omp;
+
+    return (&buf->om_databuf[0] + omp->omp_databuf_len) -
       (om->om_data + om->om_len);
 }
 
@@ -383,6 +462,44 @@ struct os_mbuf *os_mbuf_get_pkthdr(struct os_mbuf_pool *omp,
  */
 struct os_mbuf *os_mbuf_dup(struct os_mbuf *m);
 
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+/**
+ * Creates a copy of an mbuf chain that shares the data of the original
+ * instead of copying it.  Each mbuf of the clone points into the buffer of
+ * the corresponding original mbuf, whose reference count is incremented;
+ * packet and user headers are copied.  A buffer is only returned to its
+ * pool once every mbuf using it has been freed.
+ *
+ * Shared data is copy-on-write: os_mbuf_append(), os_mbuf_prepend(),
+ * os_mbuf_extend() and friends allocate new mbufs rather than growing into a
+ * shared buffer, and os_mbuf_copyinto() makes the mbufs it overwrites
+ * private first.  Code that writes through om_data directly must call
+ * os_mbuf_unshare() first.
+ *
+ * @param omp                   The pool to allocate the clone's mbuf headers
+ *                                  from; NULL to use the pool of each
+ *                                  original mbuf.  Note that later appends
+ *                                  to the clone allocate from this pool.
+ * @param om                    The mbuf chain to clone.
+ *
+ * @return                      The clone on success;
+ *                              NULL on failure.
+ */
+struct os_mbuf *os_mbuf_clone(struct os_mbuf_pool *omp, struct os_mbuf *om);
+
+/**
+ * Gives every mbuf of a chain a private copy of its data, so that the chain
+ * can be written to in place.  Mbufs whose data is not shared are left
+ * untouched.
+ *
+ * @param om                    The mbuf chain to make writable.
+ *
+ * @return                      0 on success;
+ *                              OS_ENOMEM if a buffer could not be allocated.
+ */
+int os_mbuf_unshare(struct os_mbuf *om);
+#endif
+
 /**
  * Locates the specified absolute offset within an mbuf chain.  The offset
  * can be one past than the total length of the chain, but no greater.
@@ -414,6 +531,38 @@ struct os_mbuf *os_mbuf_off(const struct os_mbuf *om, int off,
  */
 int os_mbuf_copydata(const struct os_mbuf *m, int off, int len, void *dst);
 
+/**
+ * Prepares an iterator that returns the data in the given range of an mbuf
+ * chain as a sequence of contiguous segments, one per mbuf, without copying
+ * it.  The chain must not be modified while the iterator is in use.
+ *
+ * @param it                    The iterator to initialize.
+ * @param om                    The mbuf chain to iterate over.
+ * @param off                   The offset within the chain of the first byte.
+ * @param len                   The number of bytes to iterate over.  The
+ *                                  iteration stops early at the end of the
+ *                                  chain.
+ *
+ * @return                      0 on success;
+ *                              OS_EINVAL if off is beyond the end of the
+ *                                  chain.
+ */
+int os_mbuf_iter_init(struct os_mbuf_iter *it, const struct os_mbuf *om,
+                      int off, int len);
+
+/**
+ * Returns the next segment of the range an iterator was initialized with.
+ * The segment points into the mbuf chain and remains valid as long as the
+ * chain is not modified or freed.
+ *
+ * @param it                    The iterator.
+ * @param iov                   On success, the next segment.
+ *
+ * @return                      1 if a segment was returned;
+ *                              0 if the range or the chain is exhausted.
+ */
+int os_mbuf_iter_next(struct os_mbuf_iter *it, struct os_mbuf_iovec *iov);
+
 /**
  * @brief Calculates the length of an mbuf chain.
  *
@@ -439,6 +588,24 @@ uint16_t os_mbuf_len(const struct os_mbuf *om);
  */
 int os_mbuf_append(struct os_mbuf *m, const void *, uint16_t);
 
+/**
+ * Appends the contents of several flat buffers onto an mbuf chain.  The end
+ * of the chain is located only once, and the buffers are copied back to back
+ * into the trailing space of the chain and newly allocated mbufs.  On error,
+ * the data may be partially appended; the packet header length, if any,
+ * reflects what was appended.
+ *
+ * @param om                    The mbuf chain to append to.
+ * @param iov                   The buffers to append.
+ * @param iovcnt                The number of entries in iov.
+ *
+ * @return                      0 on success;
+ *                              OS_EINVAL on bad arguments;
+ *                              OS_ENOMEM if mbufs ran out.
+ */
+int os_mbuf_appendv(struct os_mbuf *om, const struct os_mbuf_iovec *iov,
+                    int iovcnt);
+
 /**
  * Reads data from one mbuf and appends it to another.  On error, the specified
  * data range may be partially appended.  Neither mbuf is required to contain
@@ -574,6 +741,22 @@ struct os_mbuf *os_mbuf_prepend_pullup(struct os_mbuf *om, uint16_t len);
  */
 int os_mbuf_copyinto(struct os_mbuf *om, int off, const void *src, int len);
 
+/**
+ * Vectored version of os_mbuf_copyinto(): copies the contents of several flat
+ * buffers, back to back, into an mbuf chain starting at the specified
+ * offset.  The chain is extended as necessary and its packet header length,
+ * if any, is updated.
+ *
+ * @param om                    The mbuf chain to copy into.
+ * @param off                   The offset within the chain to copy to.
+ * @param iov                   The buffers to copy from.
+ * @param iovcnt                The number of entries in iov.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int os_mbuf_copyinto_v(struct os_mbuf *om, int off,
+                       const struct os_mbuf_iovec *iov, int iovcnt);
+
 /**
  * Attaches a second mbuf chain onto the end of the first.  If the first chain
  * contains a packet header, the header's length is updated.  If the second
@@ -240,6 +240,19 @@ int os_memblock_from(const struct os_mempool *mp, const void *block_addr);
  */
 void *os_memblock_get(struct os_mempool *mp);
 
+/**
+ * Gets up to n memory blocks from a memory pool.  All blocks are taken in a
+ * single critical section, which makes this cheaper than calling
+ * os_memblock_get() in a loop when allocating in bursts.
+ *
+ * @param mp Pointer to the memory pool
+ * @param blocks Array that receives the block pointers
+ * @param n Maximum number of blocks to get
+ *
+ * @return int The number of blocks obtained; less than n if the pool ran out
+ */
+int os_memblock_get_n(struct os_mempool *mp, void **blocks, int n);
+
 /**
  * Puts the memory block back into the pool, ignoring the put callback, if any.
  * This function should only be called from a put callback to free a block
@@ -262,6 +275,21 @@ os_error_t os_memblock_put_from_cb(struct os_mempool *mp, void *block_addr);
  */
 os_error_t os_memblock_put(struct os_mempool *mp, void *block_addr);
 
+/**
+ * Puts n memory blocks back into the pool.  The blocks are chained together
+ * first and then returned to the free list in a single critical section.  If
+ * the pool is an extended mempool with a put callback, the callback is called
+ * for each block instead.
+ *
+ * @param mp Pointer to memory pool
+ * @param blocks Array of pointers to the memory blocks
+ * @param n Number of blocks in the array
+ *
+ * @return os_error_t OS_OK on success; the first error reported by the put
+ *                    callback otherwise
+ */
+os_error_t os_memblock_put_n(struct os_mempool *mp, void **blocks, int n);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,26 @@
 extern "C" {
 #endif
 
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+/**
+ * Mutex contention statistics.  Times are in os_cputime ticks.
+ */
+struct os_mutex_stats {
+    /** Number of times the mutex was acquired, not counting nesting */
+    uint32_t oms_acquired;
+    /** Number of pends that had to wait, including those that timed out */
+    uint32_t oms_contended;
+    /** Total time spent waiting for the mutex */
+    uint64_t oms_wait_total;
+    /** Longest wait for the mutex */
+    uint32_t oms_max_wait;
+    /** Longest time the mutex was held */
+    uint32_t oms_max_hold;
+    /** os_cputime at which the current owner acquired the mutex */
+    uint32_t oms_hold_start;
+};
+#endif
+
 /**
  * OS mutex structure
  */
@@ -46,7 +66,36 @@ struct os_mutex {
     uint16_t    mu_level;
     /** Task that owns the mutex */
     struct os_task *mu_owner;
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    struct os_mutex_stats mu_stats;
+    /** Name given by os_mutex_register(), NULL if not registered */
+    const char *mu_name;
+    STAILQ_ENTRY(os_mutex) mu_next;
+#endif
+};
+
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+/**
+ * Information describing a registered mutex, filled out by
+ * os_mutex_info_get_next().
+ */
+struct os_mutex_info {
+    /** Name the mutex was registered with */
+    const char *omi_name;
+    /** Name of the task owning the mutex, NULL if not owned */
+    const char *omi_owner;
+    /** Number of times the mutex was acquired */
+    uint32_t omi_acquired;
+    /** Number of pends that had to wait */
+    uint32_t omi_contended;
+    /** Longest wait for the mutex, in microseconds */
+    uint32_t omi_max_wait_us;
+    /** Longest time the mutex was held, in microseconds */
+    uint32_t omi_max_hold_us;
+    /** Total time spent waiting for the mutex, in microseconds */
+    uint64_t omi_wait_total_us;
 };
+#endif
 
 /*
   XXX: NOTES
@@ -89,6 +138,10 @@ os_error_t os_mutex_release(struct os_mutex *mu);
 /**
  * Pend (wait) for a mutex.
  *
+ * While the caller waits, the owner runs at no lower a priority than the
+ * caller.  If the owner is itself waiting for another mutex, the boost is
+ * passed on along the chain of owners.
+ *
  * @param mu Pointer to mutex.
  * @param timeout Timeout, in os ticks.
  *                A timeout of 0 means do not wait if not available.
@@ -102,6 +155,39 @@ os_error_t os_mutex_release(struct os_mutex *mu);
  */
 os_error_t os_mutex_pend(struct os_mutex *mu, os_time_t timeout);
 
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+/**
+ * Register a mutex under the given name, so that its statistics are reported
+ * by os_mutex_info_get_next().  Registering an already registered mutex only
+ * changes its name.  Registration survives os_mutex_init().
+ *
+ * @param mu The mutex to register
+ * @param name The name to report the mutex under
+ *
+ * @return 0 on success, OS_INVALID_PARM on bad arguments.
+ */
+int os_mutex_register(struct os_mutex *mu, const char *name);
+
+/**
+ * Clear the contention statistics of a mutex.
+ *
+ * @param mu The mutex to clear statistics of
+ */
+void os_mutex_stats_clear(struct os_mutex *mu);
+
+/**
+ * Get information about the next registered mutex.
+ *
+ * @param prev The previous mutex returned by os_mutex_info_get_next(), or
+ *             NULL to begin iteration.
+ * @param omi  The mutex information structure to fill out.
+ *
+ * @return A pointer to the mutex that has been read, or NULL when finished.
+ */
+struct os_mutex *os_mutex_info_get_next(const struct os_mutex *prev,
+                                        struct os_mutex_info *omi);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -47,6 +47,23 @@ void os_sched_ctx_sw_hook(struct os_task *);
 
 /** @endcond */
 
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+/**
+ * Marks the start of interrupt processing for CPU time accounting.  Time
+ * between os_sched_isr_enter() and the matching os_sched_isr_exit() is
+ * charged as ISR time to the interrupted task, rather than as its run time.
+ * os_trace_isr_enter() and os_trace_isr_exit(), used by the kernel and MCU
+ * interrupt handlers, call these; other handlers can call either pair to be
+ * accounted for.  Calls may nest.
+ */
+void os_sched_isr_enter(void);
+
+/**
+ * Marks the end of interrupt processing for CPU time accounting.
+ */
+void os_sched_isr_exit(void);
+#endif
+
 /**
  * Returns the currently running task. Note that this task may or may not be
  * the highest priority task ready to run.
@@ -92,6 +109,7 @@ struct os_task *os_sched_next_task(void);
 void os_sched(struct os_task *);
 
 /** @cond INTERNAL_HIDDEN */
+void os_sched_init(void);
 void os_sched_os_timer_exp(void);
 os_error_t os_sched_insert(struct os_task *);
 int os_sched_sleep(struct os_task *, os_time_t nticks);
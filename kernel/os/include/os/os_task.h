@@ -99,7 +99,12 @@ struct os_task {
     /** Task flags, bitmask */
     uint8_t t_flags;
     uint8_t t_lockcnt;
+#if MYNEWT_VAL(OS_SCHED_BITMAP)
+    /** Priority of the ready list this task is queued on */
+    uint8_t t_rdy_prio;
+#else
     uint8_t t_pad;
+#endif
 
     /** Task name */
     const char *t_name;
@@ -118,6 +123,12 @@ struct os_task {
     os_time_t t_next_wakeup;
     /** Total task run time */
     os_time_t t_run_time;
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    /** Total task run time, in os_cputime ticks */
+    uint64_t t_run_cputime;
+    /** Time spent in interrupts while this task was running, in ticks */
+    uint64_t t_isr_cputime;
+#endif
     /**
      * Total number of times this task has been context switched during
      * execution.
@@ -127,6 +138,20 @@ struct os_task {
     STAILQ_ENTRY(os_task) t_os_task_list;
     TAILQ_ENTRY(os_task) t_os_list;
     SLIST_ENTRY(os_task) t_obj_list;
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+    /** Free small blocks kept for os_malloc() calls from this task */
+    struct os_malloc_cache t_malloc_cache;
+#endif
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+    /** Deepest stack use found so far, in os_stack_t units */
+    uint16_t t_stack_hwm;
+#endif
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    /** Sleep heap linkage, used while sleeping with a timeout */
+    struct os_task *t_heap_child;
+    struct os_task *t_heap_next;
+    struct os_task *t_heap_prev;
+#endif
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -191,6 +216,12 @@ struct os_task_info {
     uint32_t oti_cswcnt;
     /** Task runtime */
     uint32_t oti_runtime;
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    /** Task runtime in microseconds */
+    uint64_t oti_runtime_us;
+    /** Interrupt time while task was running, in microseconds */
+    uint64_t oti_isr_time_us;
+#endif
     /** Last time this task checked in with sanity */
     os_time_t oti_last_checkin;
     /** Next time this task is scheduled to check-in with sanity */
@@ -209,6 +240,8 @@ struct os_task_info {
  * - Stack Size
  * - Context Switch Count
  * - Runtime
+ * - Runtime and interrupt time in microseconds, if OS_TASK_RUN_TIME_CPUTIME
+ *   is enabled.  Idle time is the runtime of the idle task.
  * - Last & Next Sanity checkin
  * - Task Name
  *
@@ -232,6 +265,32 @@ struct os_task_info {
 struct os_task *os_task_info_get_next(const struct os_task *,
         struct os_task_info *);
 
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+/**
+ * Measure the stack use of a task.  The deepest use found is remembered, and
+ * an incremental scan only looks below it, stopping after
+ * OS_TASK_STACK_WATERMARK_GAP untouched words; a full scan examines the
+ * whole unused part of the stack.
+ *
+ * @param t The task to measure
+ * @param full Non-zero to scan the whole unused part of the stack
+ *
+ * @return The deepest stack use seen, in os_stack_t units.
+ */
+uint16_t os_task_stack_usage(struct os_task *t, int full);
+
+/**
+ * Recommend a stack size for a measured stack use: the use plus
+ * OS_TASK_STACK_MARGIN percent and the context switch guard, rounded up to
+ * a multiple of 8.
+ *
+ * @param usage Stack use, in os_stack_t units
+ *
+ * @return The recommended stack size, in os_stack_t units.
+ */
+uint16_t os_task_stack_recommend(uint16_t usage);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,8 +22,14 @@
 
 #ifdef __ASSEMBLER__
 
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+/* os_sched_isr_enter/exit record the SystemView event themselves */
+#define os_trace_isr_enter              os_sched_isr_enter
+#define os_trace_isr_exit               os_sched_isr_exit
+#else
 #define os_trace_isr_enter              SEGGER_SYSVIEW_RecordEnterISR
 #define os_trace_isr_exit               SEGGER_SYSVIEW_RecordExitISR
+#endif
 #define os_trace_task_start_exec        SEGGER_SYSVIEW_OnTaskStartExec
 
 #else
@@ -42,6 +48,7 @@
 #define OS_TRACE_ID_EVENTQ_REMOVE               (43)
 #define OS_TRACE_ID_EVENTQ_POLL_0TIMO           (44)
 #define OS_TRACE_ID_EVENTQ_POLL                 (45)
+#define OS_TRACE_ID_EVENTQ_RUN                  (46)
 #define OS_TRACE_ID_MUTEX_INIT                  (50)
 #define OS_TRACE_ID_MUTEX_RELEASE               (51)
 #define OS_TRACE_ID_MUTEX_PEND                  (52)
@@ -91,13 +98,21 @@ os_trace_module_desc(const os_trace_module_t *m, const char *desc)
 static inline void
 os_trace_isr_enter(void)
 {
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    os_sched_isr_enter();
+#else
     SEGGER_SYSVIEW_RecordEnterISR();
+#endif
 }
 
 static inline void
 os_trace_isr_exit(void)
 {
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    os_sched_isr_exit();
+#else
     SEGGER_SYSVIEW_RecordExitISR();
+#endif
 }
 
 static inline void
@@ -209,11 +224,17 @@ os_trace_api_ret_u32(unsigned id, uint32_t ret)
 static inline void
 os_trace_isr_enter(void)
 {
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    os_sched_isr_enter();
+#endif
 }
 
 static inline void
 os_trace_isr_exit(void)
 {
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    os_sched_isr_exit();
+#endif
 }
 
 static inline void
@@ -297,6 +318,23 @@ os_trace_api_ret_u32(unsigned id, uint32_t return_value)
 
 #endif /* !MYNEWT_VAL(OS_SYSVIEW) || defined(OS_TRACE_DISABLE_FILE_API) */
 
+/*
+ * Called by os_eventq_run() once an event callback returns, with the time
+ * the event spent queued and the time the callback ran, in os_cputime ticks.
+ */
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+static inline void
+os_trace_eventq_run(os_event_fn *cb, uint32_t wait_ticks, uint32_t run_ticks)
+{
+    os_eventq_prof_record(cb, wait_ticks, run_ticks);
+}
+#else
+static inline void
+os_trace_eventq_run(os_event_fn *cb, uint32_t wait_ticks, uint32_t run_ticks)
+{
+}
+#endif
+
 #endif /* __ASSEMBLER__ */
 
 #endif /* OS_TRACE_API_H */
@@ -0,0 +1,187 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/**
+ * @addtogroup OSKernel
+ * @{
+ *   @defgroup OSWorkq Worker Pools
+ *   @{
+ */
+
+#ifndef H_OS_WORKQ_
+#define H_OS_WORKQ_
+
+#include <stdint.h>
+#include "os/os_eventq.h"
+#include "os/os_sem.h"
+#include "os/os_task.h"
+#include "os/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct os_work;
+
+/**
+ * Function run by a worker task.
+ *
+ * @param work The work item being run
+ */
+typedef void os_work_fn(struct os_work *work);
+
+/** Work item is queued on a worker */
+#define OS_WORK_F_QUEUED    (0x01)
+/** Work item is being run by a worker */
+#define OS_WORK_F_RUNNING   (0x02)
+/** Work item was submitted while running; it is queued when the run ends */
+#define OS_WORK_F_REQUEUE   (0x04)
+
+/**
+ * A unit of work for an os_workq.  Initialize with os_work_init(); all
+ * fields are private.
+ */
+struct os_work {
+    os_work_fn *ow_fn;
+    void *ow_arg;
+    uint8_t ow_flags;
+    /** Queue the completion event is posted to, NULL for none */
+    struct os_eventq *ow_done_evq;
+    /** ow_done_evq for the run submitted while the item was running */
+    struct os_eventq *ow_requeue_evq;
+    /** Completion callback given to os_work_init() */
+    os_event_fn *ow_done_cb;
+    /** Number of finished runs whose completion callback is yet to run */
+    uint16_t ow_done_pending;
+    /** Completion event, ev_arg points to this work item */
+    struct os_event ow_done_ev;
+    TAILQ_ENTRY(os_work) ow_next;
+};
+
+/**
+ * A worker task and its deque of work.  Workers pop their own deque from the
+ * tail and, when it is empty, steal from the head of the other workers'
+ * deques.
+ */
+struct os_workq_worker {
+    struct os_task oww_task;
+    struct os_workq *oww_wq;
+    TAILQ_HEAD(os_work_deque, os_work) oww_deque;
+    /** Number of work items run by this worker */
+    uint32_t oww_runs;
+    /** Number of those taken from another worker */
+    uint32_t oww_steals;
+};
+
+/**
+ * A pool of worker tasks.
+ */
+struct os_workq {
+    struct os_workq_worker *owq_workers;
+    /** Number of work items queued; idle workers wait on this */
+    struct os_sem owq_sem;
+    uint8_t owq_num_workers;
+    /** Worker that receives the next submission from outside the pool */
+    uint8_t owq_next;
+};
+
+/**
+ * Create a pool of worker tasks.  Task priorities must be unique, so worker
+ * i runs at priority prio + i.  The workers share the pool's name.
+ *
+ * @param wq The pool to initialize
+ * @param name Name of the worker tasks
+ * @param workers Array of num_workers worker structures
+ * @param num_workers Number of worker tasks to start
+ * @param prio Priority of the first worker task
+ * @param stacks num_workers stacks of stack_size elements each, laid out
+ *               back to back
+ * @param stack_size Size of each stack, in os_stack_t units
+ *
+ * @return 0 on success, OS_INVALID_PARM on bad arguments, or the error
+ *         returned by os_task_init().
+ */
+int os_workq_init(struct os_workq *wq, const char *name,
+                  struct os_workq_worker *workers, int num_workers,
+                  uint8_t prio, os_stack_t *stacks, uint16_t stack_size);
+
+/**
+ * Initialize a work item.
+ *
+ * @param work The work item to initialize
+ * @param fn Function to run on a worker task
+ * @param done_cb Completion callback, run from the event queue given to
+ *                os_workq_submit(); may be NULL
+ * @param arg Argument for the work item, see os_work_arg()
+ */
+void os_work_init(struct os_work *work, os_work_fn *fn, os_event_fn *done_cb,
+                  void *arg);
+
+/**
+ * @return The argument the work item was initialized with.
+ */
+static inline void *
+os_work_arg(const struct os_work *work)
+{
+    return work->ow_arg;
+}
+
+/**
+ * Queue a work item.  Items submitted by a worker of the pool go on that
+ * worker's own deque, others are spread round robin; no order of execution
+ * is guaranteed.  Once the function has run, the work item's completion
+ * event is posted to done_evq, with ev_arg pointing to the work item.  The
+ * item may be submitted again from its completion callback or its function;
+ * the completion callback then runs once per run, even if several runs
+ * finish before the event is processed.  Work items are not reentrant: an
+ * item submitted while it is running is queued once the run returns.
+ *
+ * @param wq The pool to run the work item on
+ * @param work The work item
+ * @param done_evq Queue to post the completion event to, NULL for none
+ *
+ * @return 0 on success, OS_EBUSY if the work item is already queued or
+ *         already resubmitted while running, OS_INVALID_PARM on bad
+ *         arguments.
+ */
+int os_workq_submit(struct os_workq *wq, struct os_work *work,
+                    struct os_eventq *done_evq);
+
+/**
+ * Remove a work item that has not started running yet.
+ *
+ * @param wq The pool the work item was submitted to
+ * @param work The work item
+ *
+ * @return 0 if the work item was removed, or if it was running and its
+ *         resubmission was dropped; OS_EBUSY if it is running and was not
+ *         resubmitted, OS_ENOENT if it was not queued.
+ */
+int os_work_cancel(struct os_workq *wq, struct os_work *work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**
+ *   @} OSWorkq
+ * @} OSKernel
+ */
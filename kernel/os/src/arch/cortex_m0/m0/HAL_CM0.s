@@ -104,7 +104,7 @@ SVC_Handler:
         .cantunwind
 
         PUSH    {R4,LR}
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         BL      os_trace_isr_enter
 #endif
 
@@ -120,7 +120,7 @@ SVC_Handler:
         BLX     R12                     /* Call SVC Function */
         MRS     R3,PSP                  /* Read PSP */
         STMIA   R3!,{R0-R2}             /* Store return values */
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         BL      os_trace_isr_exit
 #endif
         POP     {R4,PC}                 /* RETI */
@@ -141,7 +141,7 @@ SVC_User:
         MRS     R4,PSP                  /* Read PSP */
         STMIA   R4!,{R0-R3}             /* Function return values */
 SVC_Done:
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         BL      os_trace_isr_exit
 #endif
         POP     {R4,PC}                 /* RETI */
@@ -213,11 +213,11 @@ SysTick_Handler:
         .cantunwind
 
         PUSH    {R4,LR}                 /* Save EXC_RETURN */
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         BL      os_trace_isr_enter
 #endif
         BL      timer_handler
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         BL      os_trace_isr_exit
 #endif
         POP     {R4,PC}                 /* Restore EXC_RETURN */
@@ -250,7 +250,7 @@ os_default_irq_asm:
         .fnstart
         .cantunwind
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         PUSH    {R4,LR}
         BL      os_trace_isr_enter
 #endif
@@ -291,7 +291,7 @@ using_msp_as_sp:
         MOV     R9,R1
         MOV     R10,R2
         MOV     R11,R3
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         BL      os_trace_isr_exit
         POP     {R4,PC}
 #else
@@ -98,7 +98,7 @@ SVC_Handler:
         .fnstart
         .cantunwind
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         PUSH    {R4,LR}
         BL      os_trace_isr_enter
         POP     {R4,LR}
@@ -117,7 +117,7 @@ SVC_Handler:
         MRS     R12,PSP                 /* Read PSP */
         STM     R12,{R0-R2}             /* Store return values */
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         PUSH    {R4,LR}
         BL      os_trace_isr_exit
         POP     {R4,LR}
@@ -142,7 +142,7 @@ SVC_User:
         MRS     R12,PSP
         STM     R12,{R0-R3}             /* Function return values */
 SVC_Done:
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         BL      os_trace_isr_exit
 #endif
         POP     {R4,LR}                 /* Restore EXC_RETURN */
@@ -220,11 +220,11 @@ SysTick_Handler:
         .cantunwind
 
         PUSH    {R4,LR}                 /* Save EXC_RETURN */
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         BL      os_trace_isr_enter
 #endif
         BL      timer_handler
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         BL      os_trace_isr_exit
 #endif
         POP     {R4,LR}                 /* Restore EXC_RETURN */
@@ -241,7 +241,7 @@ os_default_irq_asm:
         .fnstart
         .cantunwind
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         PUSH    {R4,LR}
         BL      os_trace_isr_enter
         POP     {R4,LR}
@@ -260,7 +260,7 @@ os_default_irq_asm:
         BL      os_default_irq
         POP     {R3-R11,LR}                 /* Restore EXC_RETURN */
 
-#if MYNEWT_VAL(OS_SYSVIEW)
+#if MYNEWT_VAL(OS_SYSVIEW) || MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
         PUSH    {R4,LR}
         BL      os_trace_isr_exit
         POP     {R4,LR}
@@ -176,9 +176,12 @@ os_init(int (*main_fn)(int argc, char **arg))
     SEGGER_RTT_Init();
 #endif
 
-    TAILQ_INIT(&g_callout_list);
+    os_callout_list_init();
     STAILQ_INIT(&g_os_task_list);
     os_eventq_init(os_eventq_dflt_get());
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    os_eventq_register(os_eventq_dflt_get(), "dflt");
+#endif
 
     /* Initialize device list. */
     os_dev_reset();
@@ -230,6 +233,10 @@ os_pkg_init(void)
     assert(err == OS_OK);
 
     os_msys_init();
+
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+    os_malloc_cache_init();
+#endif
 }
 
 /**
@@ -0,0 +1,293 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <string.h>
+#include "os/mynewt.h"
+
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+
+#include "cbmem/cbmem.h"
+
+#define OS_ALLOC_TRACE_BUF_SIZE     MYNEWT_VAL(OS_ALLOC_TRACE_BUF_SIZE)
+#define OS_ALLOC_TRACE_ENTRY_SIZE   \
+    (sizeof(struct cbmem_entry_hdr) + sizeof(struct os_alloc_trace_rec))
+#define OS_ALLOC_TRACE_MAX_RECS     \
+    (OS_ALLOC_TRACE_BUF_SIZE / OS_ALLOC_TRACE_ENTRY_SIZE)
+
+_Static_assert(OS_ALLOC_TRACE_MAX_RECS > 0,
+               "OS_ALLOC_TRACE_BUF_SIZE too small for a single record");
+
+static uint32_t os_alloc_trace_buf[OS_ALLOC_TRACE_BUF_SIZE / 4];
+static struct cbmem os_alloc_trace_cbmem;
+
+/* Copy of the newest record in the ring, if last_valid is set */
+static struct os_alloc_trace_rec os_alloc_trace_last;
+static uint8_t os_alloc_trace_last_valid;
+
+static uint8_t os_alloc_trace_ready;
+static uint8_t os_alloc_trace_paused;
+static uint32_t os_alloc_trace_drop_cnt;
+
+/* Records still outstanding, by position in the ring; used by the walk */
+static uint32_t os_alloc_trace_live[(OS_ALLOC_TRACE_MAX_RECS + 31) / 32];
+
+static int
+os_alloc_trace_is_alloc(uint8_t type)
+{
+    return type == OS_ALLOC_TRACE_MALLOC ||
+           type == OS_ALLOC_TRACE_MEMBLOCK_GET ||
+           type == OS_ALLOC_TRACE_MBUF_GET;
+}
+
+/* Must be called with interrupts disabled */
+static void
+os_alloc_trace_init(void)
+{
+    if (!os_alloc_trace_ready) {
+        cbmem_init(&os_alloc_trace_cbmem, os_alloc_trace_buf,
+                   sizeof os_alloc_trace_buf);
+        os_alloc_trace_ready = 1;
+    }
+}
+
+void
+os_alloc_trace_record(uint8_t type, const void *ptr, uint32_t size,
+                      const void *caller)
+{
+    struct os_alloc_trace_rec rec;
+    struct os_alloc_trace_rec *last;
+    os_sr_t sr;
+    int alloc;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    memset(&rec, 0, sizeof rec);
+    rec.oatr_ptr = (uintptr_t)ptr;
+    rec.oatr_caller = (uintptr_t)caller;
+    rec.oatr_size = size;
+    rec.oatr_time = os_time_get();
+    rec.oatr_type = type;
+
+    alloc = os_alloc_trace_is_alloc(type);
+    last = &os_alloc_trace_last;
+
+    OS_ENTER_CRITICAL(sr);
+
+    os_alloc_trace_init();
+
+    if (os_alloc_trace_paused) {
+        os_alloc_trace_drop_cnt++;
+    } else if (os_alloc_trace_last_valid && last->oatr_ptr == rec.oatr_ptr &&
+               os_alloc_trace_is_alloc(last->oatr_type) == alloc) {
+        /*
+         * Layered allocators, e.g. os_msys_get() on top of os_mbuf_get() on
+         * top of os_memblock_get(), record the same memory right after each
+         * other.  Keep one record: the outermost caller for allocations,
+         * the first one for frees.
+         */
+        if (alloc) {
+            rec.oatr_time = last->oatr_time;
+            *last = rec;
+            cbmem_update_last_nolock(&os_alloc_trace_cbmem, &rec, sizeof rec);
+        }
+    } else {
+        cbmem_append_nolock(&os_alloc_trace_cbmem, &rec, sizeof rec);
+        *last = rec;
+        os_alloc_trace_last_valid = 1;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+}
+
+/*
+ * Gives the caller exclusive access to the ring: the cbmem lock keeps other
+ * readers out, and records are dropped instead of appended until unlocked.
+ */
+static void
+os_alloc_trace_lock(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    os_alloc_trace_init();
+    OS_EXIT_CRITICAL(sr);
+
+    cbmem_lock_acquire(&os_alloc_trace_cbmem);
+
+    OS_ENTER_CRITICAL(sr);
+    os_alloc_trace_paused = 1;
+    OS_EXIT_CRITICAL(sr);
+}
+
+static void
+os_alloc_trace_unlock(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    os_alloc_trace_paused = 0;
+    OS_EXIT_CRITICAL(sr);
+
+    cbmem_lock_release(&os_alloc_trace_cbmem);
+}
+
+static void
+os_alloc_trace_read(struct cbmem_entry_hdr *hdr,
+                    struct os_alloc_trace_rec *rec)
+{
+    cbmem_read(&os_alloc_trace_cbmem, hdr, rec, 0, sizeof *rec);
+}
+
+/*
+ * Marks the allocation records that no later record frees or records
+ * again.
+ */
+static void
+os_alloc_trace_mark_live(void)
+{
+    struct os_alloc_trace_rec rec;
+    struct os_alloc_trace_rec later;
+    struct cbmem_entry_hdr *hdr;
+    struct cbmem_iter it;
+    struct cbmem_iter next;
+    int live;
+    int i;
+
+    memset(os_alloc_trace_live, 0, sizeof os_alloc_trace_live);
+
+    cbmem_iter_start(&os_alloc_trace_cbmem, &it);
+    for (i = 0; i < OS_ALLOC_TRACE_MAX_RECS; i++) {
+        hdr = cbmem_iter_next(&os_alloc_trace_cbmem, &it);
+        if (hdr == NULL) {
+            break;
+        }
+
+        os_alloc_trace_read(hdr, &rec);
+        if (!os_alloc_trace_is_alloc(rec.oatr_type)) {
+            continue;
+        }
+
+        live = 1;
+        next = it;
+        while ((hdr = cbmem_iter_next(&os_alloc_trace_cbmem, &next))) {
+            os_alloc_trace_read(hdr, &later);
+            if (later.oatr_ptr == rec.oatr_ptr) {
+                live = 0;
+                break;
+            }
+        }
+
+        if (live) {
+            os_alloc_trace_live[i / 32] |= 1UL << (i % 32);
+        }
+    }
+}
+
+int
+os_alloc_trace_sites(os_alloc_trace_site_fn *fn, void *arg)
+{
+    struct os_alloc_trace_site oats;
+    struct os_alloc_trace_rec rec;
+    struct cbmem_entry_hdr *hdr;
+    struct cbmem_iter it;
+    struct cbmem_iter next;
+    int rc;
+    int i;
+    int j;
+
+    os_alloc_trace_lock();
+
+    os_alloc_trace_mark_live();
+
+    rc = 0;
+    cbmem_iter_start(&os_alloc_trace_cbmem, &it);
+    for (i = 0; i < OS_ALLOC_TRACE_MAX_RECS; i++) {
+        hdr = cbmem_iter_next(&os_alloc_trace_cbmem, &it);
+        if (hdr == NULL) {
+            break;
+        }
+        if (!(os_alloc_trace_live[i / 32] & (1UL << (i % 32)))) {
+            continue;
+        }
+
+        /* First outstanding allocation from this site; collect the rest. */
+        os_alloc_trace_read(hdr, &rec);
+        oats.oats_caller = rec.oatr_caller;
+        oats.oats_type = rec.oatr_type;
+        oats.oats_count = 1;
+        oats.oats_bytes = rec.oatr_size;
+        oats.oats_oldest = rec.oatr_time;
+
+        next = it;
+        for (j = i + 1; j < OS_ALLOC_TRACE_MAX_RECS; j++) {
+            hdr = cbmem_iter_next(&os_alloc_trace_cbmem, &next);
+            if (hdr == NULL) {
+                break;
+            }
+            if (!(os_alloc_trace_live[j / 32] & (1UL << (j % 32)))) {
+                continue;
+            }
+
+            os_alloc_trace_read(hdr, &rec);
+            if (rec.oatr_caller == oats.oats_caller &&
+                rec.oatr_type == oats.oats_type) {
+                oats.oats_count++;
+                oats.oats_bytes += rec.oatr_size;
+                os_alloc_trace_live[j / 32] &= ~(1UL << (j % 32));
+            }
+        }
+
+        rc = fn(&oats, arg);
+        if (rc != 0) {
+            break;
+        }
+    }
+
+    os_alloc_trace_unlock();
+
+    return rc;
+}
+
+uint32_t
+os_alloc_trace_dropped(void)
+{
+    return os_alloc_trace_drop_cnt;
+}
+
+void
+os_alloc_trace_clear(void)
+{
+    os_sr_t sr;
+
+    os_alloc_trace_lock();
+
+    cbmem_flush(&os_alloc_trace_cbmem);
+
+    OS_ENTER_CRITICAL(sr);
+    os_alloc_trace_last_valid = 0;
+    os_alloc_trace_drop_cnt = 0;
+    OS_EXIT_CRITICAL(sr);
+
+    os_alloc_trace_unlock();
+}
+
+#endif
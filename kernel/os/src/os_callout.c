@@ -26,8 +26,181 @@
 #include "os/mynewt.h"
 #include "os_priv.h"
 
+#if MYNEWT_VAL(OS_CALLOUT_WHEEL)
+
+#define OS_CALLOUT_WHEEL_SLOTS  MYNEWT_VAL(OS_CALLOUT_WHEEL_SLOTS)
+#define OS_CALLOUT_WHEEL_MASK   (OS_CALLOUT_WHEEL_SLOTS - 1)
+
+#if (OS_CALLOUT_WHEEL_SLOTS & OS_CALLOUT_WHEEL_MASK) != 0
+#error "OS_CALLOUT_WHEEL_SLOTS must be a power of two"
+#endif
+
+/*
+ * Hashed timing wheel.  A callout lives in the slot indexed by the low bits
+ * of its expiry tick; slots are unsorted, so arming and stopping are O(1).
+ * Every tick only the slot for that tick needs to be examined.  Callouts
+ * more than one revolution away are skipped until their round comes up.
+ */
+static struct os_callout_list os_callout_wheel[OS_CALLOUT_WHEEL_SLOTS];
+
+/* Last tick whose slot has been processed by os_callout_tick() */
+static os_time_t os_callout_wheel_last;
+
+/*
+ * Cached earliest expiry, for os_callout_wakeup_ticks().  It is kept exact
+ * when callouts are armed, and recomputed lazily once it goes stale.
+ */
+static os_time_t os_callout_wheel_next;
+static uint8_t os_callout_wheel_next_valid;
+static uint32_t os_callout_wheel_cnt;
+
+static struct os_callout_list *
+os_callout_slot(const struct os_callout *c)
+{
+    return &os_callout_wheel[c->c_ticks & OS_CALLOUT_WHEEL_MASK];
+}
+
+static void
+os_callout_insert(struct os_callout *c)
+{
+    TAILQ_INSERT_TAIL(os_callout_slot(c), c, c_next);
+
+    if (os_callout_wheel_cnt++ == 0) {
+        os_callout_wheel_next = c->c_ticks;
+        os_callout_wheel_next_valid = 1;
+    } else if (os_callout_wheel_next_valid &&
+               OS_TIME_TICK_LT(c->c_ticks, os_callout_wheel_next)) {
+        os_callout_wheel_next = c->c_ticks;
+    }
+}
+
+static void
+os_callout_remove(struct os_callout *c)
+{
+    TAILQ_REMOVE(os_callout_slot(c), c, c_next);
+    c->c_next.tqe_prev = NULL;
+
+    os_callout_wheel_cnt--;
+    if (c->c_ticks == os_callout_wheel_next) {
+        os_callout_wheel_next_valid = 0;
+    }
+}
+
+/*
+ * Finds the earliest expiry.  Everything up to os_callout_wheel_last has
+ * already fired, so slots are walked forward from there; the first callout
+ * whose expiry matches the tick being looked at is the earliest one.  Only
+ * if everything is more than a revolution away do we fall back to looking
+ * at every armed callout.
+ */
+static void
+os_callout_find_next(void)
+{
+    struct os_callout *c;
+    os_time_t tick;
+    int found;
+    int i;
+
+    if (os_callout_wheel_cnt == 0) {
+        os_callout_wheel_next_valid = 0;
+        return;
+    }
+
+    tick = os_callout_wheel_last;
+    for (i = 0; i < OS_CALLOUT_WHEEL_SLOTS; i++) {
+        tick++;
+        TAILQ_FOREACH(c, &os_callout_wheel[tick & OS_CALLOUT_WHEEL_MASK],
+                      c_next) {
+            if (c->c_ticks == tick) {
+                os_callout_wheel_next = tick;
+                os_callout_wheel_next_valid = 1;
+                return;
+            }
+        }
+    }
+
+    found = 0;
+    for (i = 0; i < OS_CALLOUT_WHEEL_SLOTS; i++) {
+        TAILQ_FOREACH(c, &os_callout_wheel[i], c_next) {
+            if (!found || OS_TIME_TICK_LT(c->c_ticks, os_callout_wheel_next)) {
+                os_callout_wheel_next = c->c_ticks;
+                found = 1;
+            }
+        }
+    }
+    os_callout_wheel_next_valid = found;
+}
+
+/*
+ * Removes and returns one expired callout from the slot which covers 'tick',
+ * or NULL if there are none left.
+ */
+static struct os_callout *
+os_callout_expired(os_time_t tick, os_time_t now)
+{
+    struct os_callout *c;
+
+    TAILQ_FOREACH(c, &os_callout_wheel[tick & OS_CALLOUT_WHEEL_MASK],
+                  c_next) {
+        if (OS_TIME_TICK_GEQ(now, c->c_ticks)) {
+            os_callout_remove(c);
+            return c;
+        }
+    }
+
+    return NULL;
+}
+
+void
+os_callout_list_init(void)
+{
+    int i;
+
+    for (i = 0; i < OS_CALLOUT_WHEEL_SLOTS; i++) {
+        TAILQ_INIT(&os_callout_wheel[i]);
+    }
+    os_callout_wheel_last = os_time_get();
+    os_callout_wheel_next_valid = 0;
+    os_callout_wheel_cnt = 0;
+}
+
+#else
+
 struct os_callout_list g_callout_list;
 
+static void
+os_callout_insert(struct os_callout *c)
+{
+    struct os_callout *entry;
+
+    TAILQ_FOREACH(entry, &g_callout_list, c_next) {
+        if (OS_TIME_TICK_LT(c->c_ticks, entry->c_ticks)) {
+            break;
+        }
+    }
+
+    if (entry) {
+        TAILQ_INSERT_BEFORE(entry, c, c_next);
+    } else {
+        TAILQ_INSERT_TAIL(&g_callout_list, c, c_next);
+    }
+}
+
+static void
+os_callout_remove(struct os_callout *c)
+{
+    TAILQ_REMOVE(&g_callout_list, c, c_next);
+    c->c_next.tqe_prev = NULL;
+}
+
+void
+os_callout_list_init(void)
+{
+    TAILQ_INIT(&g_callout_list);
+}
+
+#endif
+
 void os_callout_init(struct os_callout *c, struct os_eventq *evq,
                      os_event_fn *ev_cb, void *ev_arg)
 {
@@ -51,8 +224,7 @@ os_callout_stop(struct os_callout *c)
     OS_ENTER_CRITICAL(sr);
 
     if (os_callout_queued(c)) {
-        TAILQ_REMOVE(&g_callout_list, c, c_next);
-        c->c_next.tqe_prev = NULL;
+        os_callout_remove(c);
     }
 
     if (c->c_evq) {
@@ -67,7 +239,6 @@ os_callout_stop(struct os_callout *c)
 int
 os_callout_reset(struct os_callout *c, os_time_t ticks)
 {
-    struct os_callout *entry;
     os_sr_t sr;
     int ret;
 
@@ -87,19 +258,7 @@ os_callout_reset(struct os_callout *c, os_time_t ticks)
     }
 
     c->c_ticks = os_time_get() + ticks;
-
-    entry = NULL;
-    TAILQ_FOREACH(entry, &g_callout_list, c_next) {
-        if (OS_TIME_TICK_LT(c->c_ticks, entry->c_ticks)) {
-            break;
-        }
-    }
-
-    if (entry) {
-        TAILQ_INSERT_BEFORE(entry, c, c_next);
-    } else {
-        TAILQ_INSERT_TAIL(&g_callout_list, c, c_next);
-    }
+    os_callout_insert(c);
 
     OS_EXIT_CRITICAL(sr);
 
@@ -117,6 +276,54 @@ err:
  * to run, it posts an event for each callout that's ready to run,
  * to the event queue provided to os_callout_init().
  */
+#if MYNEWT_VAL(OS_CALLOUT_WHEEL)
+void
+os_callout_tick(void)
+{
+    os_sr_t sr;
+    struct os_callout *c;
+    os_time_t tick;
+    uint32_t now;
+    int slots;
+
+    os_trace_api_void(OS_TRACE_ID_CALLOUT_TICK);
+
+    now = os_time_get();
+
+    /*
+     * Visit the slot of every tick which elapsed since the last call; after
+     * a full revolution every slot has been looked at.
+     */
+    OS_ENTER_CRITICAL(sr);
+    tick = os_callout_wheel_last;
+    os_callout_wheel_last = now;
+    OS_EXIT_CRITICAL(sr);
+
+    slots = 0;
+    while (OS_TIME_TICK_LT(tick, now) && slots < OS_CALLOUT_WHEEL_SLOTS) {
+        tick++;
+        slots++;
+
+        while (1) {
+            OS_ENTER_CRITICAL(sr);
+            c = os_callout_expired(tick, now);
+            OS_EXIT_CRITICAL(sr);
+
+            if (c) {
+                if (c->c_evq) {
+                    os_eventq_put(c->c_evq, &c->c_ev);
+                } else {
+                    c->c_ev.ev_cb(&c->c_ev);
+                }
+            } else {
+                break;
+            }
+        }
+    }
+
+    os_trace_api_ret(OS_TRACE_ID_CALLOUT_TICK);
+}
+#else
 void
 os_callout_tick(void)
 {
@@ -154,6 +361,7 @@ os_callout_tick(void)
 
     os_trace_api_ret(OS_TRACE_ID_CALLOUT_TICK);
 }
+#endif
 
 /*
  * Returns the number of ticks to the first pending callout. If there are no
@@ -171,6 +379,21 @@ os_callout_wakeup_ticks(os_time_t now)
 
     OS_ASSERT_CRITICAL();
 
+#if MYNEWT_VAL(OS_CALLOUT_WHEEL)
+    (void)c;
+    if (!os_callout_wheel_next_valid) {
+        os_callout_find_next();
+    }
+    if (os_callout_wheel_next_valid) {
+        if (OS_TIME_TICK_GEQ(os_callout_wheel_next, now)) {
+            rt = os_callout_wheel_next - now;
+        } else {
+            rt = 0;     /* callout time is in the past */
+        }
+    } else {
+        rt = OS_TIMEOUT_NEVER;
+    }
+#else
     c = TAILQ_FIRST(&g_callout_list);
     if (c != NULL) {
         if (OS_TIME_TICK_GEQ(c->c_ticks, now)) {
@@ -181,6 +404,7 @@ os_callout_wakeup_ticks(os_time_t now)
     } else {
         rt = OS_TIMEOUT_NEVER;
     }
+#endif
 
     return (rt);
 }
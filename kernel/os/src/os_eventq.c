@@ -27,11 +27,157 @@
 
 static struct os_eventq os_eventq_main;
 
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+static STAILQ_HEAD(, os_eventq) os_eventq_list =
+    STAILQ_HEAD_INITIALIZER(os_eventq_list);
+
+static int
+os_eventq_is_registered(const struct os_eventq *evq)
+{
+    struct os_eventq *cur;
+
+    STAILQ_FOREACH(cur, &os_eventq_list, evq_next) {
+        if (cur == evq) {
+            return 1;
+        }
+    }
+    return 0;
+}
+#endif
+
+/*
+ * Queue an event at the tail of its priority level.  Must be called with
+ * interrupts disabled.
+ */
+static void
+os_eventq_insert(struct os_eventq *evq, struct os_event *ev, uint8_t prio)
+{
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    if (prio >= OS_EVENTQ_PRIO_DFLT) {
+        prio = OS_EVENTQ_PRIO_DFLT;
+        STAILQ_INSERT_TAIL(&evq->evq_list, ev, ev_next);
+    } else {
+        STAILQ_INSERT_TAIL(&evq->evq_prio[prio], ev, ev_next);
+        evq->evq_prio_map |= 1 << prio;
+    }
+    ev->ev_prio = prio;
+#else
+    (void)prio;
+    STAILQ_INSERT_TAIL(&evq->evq_list, ev, ev_next);
+#endif
+    ev->ev_queued = 1;
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS) || MYNEWT_VAL(OS_EVENTQ_PROF)
+    ev->ev_put_time = os_cputime_get32();
+#endif
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    evq->evq_stats.oes_depth++;
+    if (evq->evq_stats.oes_depth > evq->evq_stats.oes_max_depth) {
+        evq->evq_stats.oes_max_depth = evq->evq_stats.oes_depth;
+    }
+#endif
+}
+
+/*
+ * Remove the first event from the highest non-empty priority level, or
+ * return NULL if the queue is empty.  Must be called with interrupts
+ * disabled.
+ */
+static struct os_event *
+os_eventq_pull(struct os_eventq *evq)
+{
+    struct os_event *ev;
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    int prio;
+
+    if (evq->evq_prio_map != 0) {
+        prio = __builtin_ctz(evq->evq_prio_map);
+        ev = STAILQ_FIRST(&evq->evq_prio[prio]);
+        STAILQ_REMOVE_HEAD(&evq->evq_prio[prio], ev_next);
+        if (STAILQ_EMPTY(&evq->evq_prio[prio])) {
+            evq->evq_prio_map &= ~(1 << prio);
+        }
+    } else
+#endif
+    {
+        ev = STAILQ_FIRST(&evq->evq_list);
+        if (ev == NULL) {
+            return NULL;
+        }
+        STAILQ_REMOVE_HEAD(&evq->evq_list, ev_next);
+    }
+    ev->ev_queued = 0;
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    {
+        uint32_t dwell;
+
+        evq->evq_stats.oes_depth--;
+        dwell = os_cputime_get32() - ev->ev_put_time;
+        if (dwell > evq->evq_stats.oes_max_dwell) {
+            evq->evq_stats.oes_max_dwell = dwell;
+        }
+    }
+#endif
+
+    return ev;
+}
+
+/*
+ * Remove a queued event from wherever it is on the queue.  Must be called
+ * with interrupts disabled.
+ */
+static void
+os_eventq_unlink(struct os_eventq *evq, struct os_event *ev)
+{
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    if (ev->ev_prio < OS_EVENTQ_PRIO_DFLT) {
+        STAILQ_REMOVE(&evq->evq_prio[ev->ev_prio], ev, os_event, ev_next);
+        if (STAILQ_EMPTY(&evq->evq_prio[ev->ev_prio])) {
+            evq->evq_prio_map &= ~(1 << ev->ev_prio);
+        }
+    } else
+#endif
+    {
+        STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
+    }
+    ev->ev_queued = 0;
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    evq->evq_stats.oes_depth--;
+#endif
+}
+
 void
 os_eventq_init(struct os_eventq *evq)
 {
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    int i;
+#endif
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    const char *name;
+
+    /* Keep the queue registered across re-initialization. */
+    name = NULL;
+    if (os_eventq_is_registered(evq)) {
+        name = evq->evq_name;
+        STAILQ_REMOVE(&os_eventq_list, evq, os_eventq, evq_next);
+    }
+#endif
+
     memset(evq, 0, sizeof(*evq));
     STAILQ_INIT(&evq->evq_list);
+#if OS_EVENTQ_PRIO_LEVELS > 1
+    for (i = 0; i < OS_EVENTQ_PRIO_LEVELS - 1; i++) {
+        STAILQ_INIT(&evq->evq_prio[i]);
+    }
+#endif
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    if (name != NULL) {
+        os_eventq_register(evq, name);
+    }
+#endif
 }
 
 int
@@ -42,6 +188,12 @@ os_eventq_inited(const struct os_eventq *evq)
 
 void
 os_eventq_put(struct os_eventq *evq, struct os_event *ev)
+{
+    os_eventq_put_prio(evq, ev, OS_EVENTQ_PRIO_DFLT);
+}
+
+void
+os_eventq_put_prio(struct os_eventq *evq, struct os_event *ev, uint8_t prio)
 {
     int resched;
     os_sr_t sr;
@@ -58,8 +210,7 @@ os_eventq_put(struct os_eventq *evq, struct os_event *ev)
     }
 
     /* Queue the event */
-    ev->ev_queued = 1;
-    STAILQ_INSERT_TAIL(&evq->evq_list, ev, ev_next);
+    os_eventq_insert(evq, ev, prio);
 
     resched = 0;
     if (evq->evq_task) {
@@ -90,14 +241,13 @@ struct os_event *
 os_eventq_get_no_wait(struct os_eventq *evq)
 {
     struct os_event *ev;
+    os_sr_t sr;
 
     os_trace_api_u32(OS_TRACE_ID_EVENTQ_GET_NO_WAIT, (uint32_t)evq);
 
-    ev = STAILQ_FIRST(&evq->evq_list);
-    if (ev) {
-        STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
-        ev->ev_queued = 0;
-    }
+    OS_ENTER_CRITICAL(sr);
+    ev = os_eventq_pull(evq);
+    OS_EXIT_CRITICAL(sr);
 
     os_trace_api_ret_u32(OS_TRACE_ID_EVENTQ_GET_NO_WAIT, (uint32_t)ev);
 
@@ -127,10 +277,8 @@ os_eventq_get(struct os_eventq *evq)
     }
     OS_ENTER_CRITICAL(sr);
 pull_one:
-    ev = STAILQ_FIRST(&evq->evq_list);
+    ev = os_eventq_pull(evq);
     if (ev) {
-        STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
-        ev->ev_queued = 0;
         t->t_flags &= ~OS_TASK_FLAG_EVQ_WAIT;
     } else {
         evq->evq_task = t;
@@ -155,11 +303,39 @@ void
 os_eventq_run(struct os_eventq *evq)
 {
     struct os_event *ev;
+#if MYNEWT_VAL(OS_EVENTQ_STATS) || MYNEWT_VAL(OS_EVENTQ_PROF)
+    os_event_fn *cb;
+    uint32_t start;
+    uint32_t wait;
+    uint32_t elapsed;
+#endif
 
     ev = os_eventq_get(evq);
     assert(ev->ev_cb != NULL);
 
+    os_trace_api_u32x2(OS_TRACE_ID_EVENTQ_RUN, (uint32_t)evq, (uint32_t)ev);
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS) || MYNEWT_VAL(OS_EVENTQ_PROF)
+    /* The callback may free or requeue the event; don't touch it after. */
+    cb = ev->ev_cb;
+    start = os_cputime_get32();
+    wait = start - ev->ev_put_time;
+
+    /* Includes any time the callback spent preempted. */
+    cb(ev);
+    elapsed = os_cputime_get32() - start;
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    if (elapsed > evq->evq_stats.oes_max_cb_time) {
+        evq->evq_stats.oes_max_cb_time = elapsed;
+    }
+#endif
+    os_trace_eventq_run(cb, wait, elapsed);
+#else
     ev->ev_cb(ev);
+#endif
+
+    os_trace_api_ret(OS_TRACE_ID_EVENTQ_RUN);
 }
 
 static struct os_event *
@@ -176,10 +352,8 @@ os_eventq_poll_0timo(struct os_eventq **evq, int nevqs)
 
     OS_ENTER_CRITICAL(sr);
     for (i = 0; i < nevqs; i++) {
-        ev = STAILQ_FIRST(&evq[i]->evq_list);
+        ev = os_eventq_pull(evq[i]);
         if (ev) {
-            STAILQ_REMOVE(&evq[i]->evq_list, ev, os_event, ev_next);
-            ev->ev_queued = 0;
             break;
         }
     }
@@ -214,10 +388,8 @@ os_eventq_poll(struct os_eventq **evq, int nevqs, os_time_t timo)
     cur_t = os_sched_get_current_task();
 
     for (i = 0; i < nevqs; i++) {
-        ev = STAILQ_FIRST(&evq[i]->evq_list);
+        ev = os_eventq_pull(evq[i]);
         if (ev) {
-            STAILQ_REMOVE(&evq[i]->evq_list, ev, os_event, ev_next);
-            ev->ev_queued = 0;
             /* Reset the items that already have an evq task set. */
             for (j = 0; j < i; j++) {
                 evq[j]->evq_task = NULL;
@@ -245,11 +417,7 @@ os_eventq_poll(struct os_eventq **evq, int nevqs, os_time_t timo)
          * we haven't found one.
          */
         if (!ev) {
-            ev = STAILQ_FIRST(&evq[i]->evq_list);
-            if (ev) {
-                STAILQ_REMOVE(&evq[i]->evq_list, ev, os_event, ev_next);
-                ev->ev_queued = 0;
-            }
+            ev = os_eventq_pull(evq[i]);
         }
         evq[i]->evq_task = NULL;
     }
@@ -270,9 +438,8 @@ os_eventq_remove(struct os_eventq *evq, struct os_event *ev)
 
     OS_ENTER_CRITICAL(sr);
     if (OS_EVENT_QUEUED(ev)) {
-        STAILQ_REMOVE(&evq->evq_list, ev, os_event, ev_next);
+        os_eventq_unlink(evq, ev);
     }
-    ev->ev_queued = 0;
     OS_EXIT_CRITICAL(sr);
 
     os_trace_api_ret(OS_TRACE_ID_EVENTQ_REMOVE);
@@ -284,6 +451,66 @@ os_eventq_dflt_get(void)
     return &os_eventq_main;
 }
 
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+int
+os_eventq_register(struct os_eventq *evq, const char *name)
+{
+    if (evq == NULL || name == NULL) {
+        return OS_INVALID_PARM;
+    }
+
+    evq->evq_name = name;
+    if (!os_eventq_is_registered(evq)) {
+        STAILQ_INSERT_TAIL(&os_eventq_list, evq, evq_next);
+    }
+
+    return 0;
+}
+
+void
+os_eventq_stats_clear(struct os_eventq *evq)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    evq->evq_stats.oes_max_depth = evq->evq_stats.oes_depth;
+    evq->evq_stats.oes_max_dwell = 0;
+    evq->evq_stats.oes_max_cb_time = 0;
+    OS_EXIT_CRITICAL(sr);
+}
+
+struct os_eventq *
+os_eventq_info_get_next(const struct os_eventq *prev,
+                        struct os_eventq_info *oei)
+{
+    struct os_eventq *cur;
+    struct os_eventq_stats stats;
+    os_sr_t sr;
+
+    if (prev != NULL) {
+        cur = STAILQ_NEXT(prev, evq_next);
+    } else {
+        cur = STAILQ_FIRST(&os_eventq_list);
+    }
+
+    if (cur == NULL) {
+        return NULL;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    stats = cur->evq_stats;
+    OS_EXIT_CRITICAL(sr);
+
+    oei->oei_name = cur->evq_name;
+    oei->oei_depth = stats.oes_depth;
+    oei->oei_max_depth = stats.oes_max_depth;
+    oei->oei_max_dwell_us = os_cputime_ticks_to_usecs(stats.oes_max_dwell);
+    oei->oei_max_cb_us = os_cputime_ticks_to_usecs(stats.oes_max_cb_time);
+
+    return cur;
+}
+#endif
+
 /**
  * [DEPRECATED - packages should manually enqueue start events to the default
  * task instead of calling this function]
@@ -0,0 +1,128 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "os/mynewt.h"
+
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+
+#define OS_EVENTQ_PROF_SLOTS    MYNEWT_VAL(OS_EVENTQ_PROF_SLOTS)
+
+#if OS_EVENTQ_PROF_SLOTS & (OS_EVENTQ_PROF_SLOTS - 1)
+#error "OS_EVENTQ_PROF_SLOTS must be a power of two"
+#endif
+
+/*
+ * Open addressed table keyed by callback address.  Entries are never
+ * removed individually, so a lookup stops at the first empty slot.
+ */
+static struct os_eventq_prof_info os_eventq_prof[OS_EVENTQ_PROF_SLOTS];
+static uint32_t os_eventq_prof_ovf;
+
+static struct os_eventq_prof_info *
+os_eventq_prof_find(os_event_fn *cb)
+{
+    struct os_eventq_prof_info *oepi;
+    uint32_t idx;
+    int i;
+
+    /* Knuth multiplicative hash; low address bits are alignment. */
+    idx = ((uint32_t)(uintptr_t)cb >> 1) * 2654435761u;
+    idx >>= 16;
+
+    for (i = 0; i < OS_EVENTQ_PROF_SLOTS; i++) {
+        oepi = &os_eventq_prof[(idx + i) & (OS_EVENTQ_PROF_SLOTS - 1)];
+        if (oepi->oepi_cb == cb) {
+            return oepi;
+        }
+        if (oepi->oepi_cb == NULL) {
+            oepi->oepi_cb = cb;
+            return oepi;
+        }
+    }
+
+    return NULL;
+}
+
+void
+os_eventq_prof_record(os_event_fn *cb, uint32_t wait_ticks,
+                      uint32_t run_ticks)
+{
+    struct os_eventq_prof_info *oepi;
+    uint32_t wait_us;
+    uint32_t run_us;
+    os_sr_t sr;
+
+    wait_us = os_cputime_ticks_to_usecs(wait_ticks);
+    run_us = os_cputime_ticks_to_usecs(run_ticks);
+
+    OS_ENTER_CRITICAL(sr);
+    oepi = os_eventq_prof_find(cb);
+    if (oepi == NULL) {
+        os_eventq_prof_ovf++;
+    } else {
+        oepi->oepi_count++;
+        oepi->oepi_run_total_us += run_us;
+        if (run_us > oepi->oepi_run_max_us) {
+            oepi->oepi_run_max_us = run_us;
+        }
+        oepi->oepi_wait_total_us += wait_us;
+        if (wait_us > oepi->oepi_wait_max_us) {
+            oepi->oepi_wait_max_us = wait_us;
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+
+int
+os_eventq_prof_info_get_next(int prev, struct os_eventq_prof_info *oepi)
+{
+    os_sr_t sr;
+    int i;
+
+    for (i = prev + 1; i < OS_EVENTQ_PROF_SLOTS; i++) {
+        if (os_eventq_prof[i].oepi_cb != NULL) {
+            OS_ENTER_CRITICAL(sr);
+            *oepi = os_eventq_prof[i];
+            OS_EXIT_CRITICAL(sr);
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+uint32_t
+os_eventq_prof_overflow(void)
+{
+    return os_eventq_prof_ovf;
+}
+
+void
+os_eventq_prof_clear(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    memset(os_eventq_prof, 0, sizeof(os_eventq_prof));
+    os_eventq_prof_ovf = 0;
+    OS_EXIT_CRITICAL(sr);
+}
+
+#endif
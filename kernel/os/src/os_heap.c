@@ -18,12 +18,75 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
+#include <string.h>
 #include "os/mynewt.h"
+#include "os_priv.h"
+
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+#include "stats/stats.h"
+#endif
 
 #if MYNEWT_VAL(OS_SCHEDULING)
 static struct os_mutex os_malloc_mutex;
 #endif
 
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+
+#define OS_MALLOC_CACHE_HWM     MYNEWT_VAL(OS_MALLOC_TASK_CACHE_HWM)
+#define OS_MALLOC_CACHE_BLOCKS  MYNEWT_VAL(OS_MALLOC_TASK_CACHE_BLOCKS)
+
+/* Blocks moved between a task cache and its pool at a time */
+#define OS_MALLOC_CACHE_BATCH   ((OS_MALLOC_CACHE_HWM + 1) / 2)
+
+_Static_assert(OS_MALLOC_CACHE_HWM > 0 && OS_MALLOC_CACHE_HWM < 64,
+               "OS_MALLOC_TASK_CACHE_HWM must be between 1 and 63");
+
+#define OS_MALLOC_CACHE_SIZE(cls)   (1 << (OS_MALLOC_CACHE_MIN_SHIFT + (cls)))
+
+static os_membuf_t os_malloc_cache_mem16[
+    OS_MEMPOOL_SIZE(OS_MALLOC_CACHE_BLOCKS, OS_MALLOC_CACHE_SIZE(0))];
+static os_membuf_t os_malloc_cache_mem32[
+    OS_MEMPOOL_SIZE(OS_MALLOC_CACHE_BLOCKS, OS_MALLOC_CACHE_SIZE(1))];
+static os_membuf_t os_malloc_cache_mem64[
+    OS_MEMPOOL_SIZE(OS_MALLOC_CACHE_BLOCKS, OS_MALLOC_CACHE_SIZE(2))];
+static os_membuf_t os_malloc_cache_mem128[
+    OS_MEMPOOL_SIZE(OS_MALLOC_CACHE_BLOCKS, OS_MALLOC_CACHE_SIZE(3))];
+
+static os_membuf_t * const os_malloc_cache_mem[OS_MALLOC_CACHE_CLASSES] = {
+    os_malloc_cache_mem16,
+    os_malloc_cache_mem32,
+    os_malloc_cache_mem64,
+    os_malloc_cache_mem128,
+};
+
+static char * const os_malloc_cache_names[OS_MALLOC_CACHE_CLASSES] = {
+    "os_malloc_16",
+    "os_malloc_32",
+    "os_malloc_64",
+    "os_malloc_128",
+};
+
+/* Shared pools the task caches are filled from and flushed to */
+static struct os_mempool os_malloc_pools[OS_MALLOC_CACHE_CLASSES];
+
+STATS_SECT_START(os_malloc_stats)
+    STATS_SECT_ENTRY(hit)
+    STATS_SECT_ENTRY(refill)
+    STATS_SECT_ENTRY(flush)
+    STATS_SECT_ENTRY(fallback)
+STATS_SECT_END
+
+STATS_NAME_START(os_malloc_stats)
+    STATS_NAME(os_malloc_stats, hit)
+    STATS_NAME(os_malloc_stats, refill)
+    STATS_NAME(os_malloc_stats, flush)
+    STATS_NAME(os_malloc_stats, fallback)
+STATS_NAME_END(os_malloc_stats)
+
+static STATS_SECT_DECL(os_malloc_stats) os_malloc_stats;
+#endif
+
 static void
 os_malloc_lock(void)
 {
@@ -50,10 +113,207 @@ os_malloc_unlock(void)
 #endif
 }
 
-void *
-os_malloc(size_t size)
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+void
+os_malloc_cache_init(void)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < OS_MALLOC_CACHE_CLASSES; i++) {
+        /* Fails harmlessly the first time; sysinit may run more than once. */
+        os_mempool_unregister(&os_malloc_pools[i]);
+        rc = os_mempool_init(&os_malloc_pools[i], OS_MALLOC_CACHE_BLOCKS,
+                             OS_MALLOC_CACHE_SIZE(i), os_malloc_cache_mem[i],
+                             os_malloc_cache_names[i]);
+        assert(rc == 0);
+    }
+}
+
+void
+os_malloc_cache_stats_init(void)
 {
+    static bool registered;
+    int rc;
+
+    stats_init(STATS_HDR(os_malloc_stats),
+               STATS_SIZE_INIT_PARMS(os_malloc_stats, STATS_SIZE_32),
+               STATS_NAME_INIT_PARMS(os_malloc_stats));
+
+    /* sysinit may run more than once, e.g. between unit tests. */
+    if (!registered) {
+        rc = stats_register("os_malloc", STATS_HDR(os_malloc_stats));
+        assert(rc == 0);
+        registered = true;
+    }
+}
+
+/* Size class for an allocation, or -1 if it is too large to be cached */
+static int
+os_malloc_cache_class(size_t size)
+{
+    int cls;
+
+    if (size == 0 || size > OS_MALLOC_CACHE_MAX_SIZE) {
+        return -1;
+    }
+
+    cls = 0;
+    while (OS_MALLOC_CACHE_SIZE(cls) < size) {
+        cls++;
+    }
+    return cls;
+}
+
+/* Size class of the pool a block came from, or -1 if it is a heap block */
+static int
+os_malloc_cache_owner(const void *ptr)
+{
+    int i;
+
+    for (i = 0; i < OS_MALLOC_CACHE_CLASSES; i++) {
+        if (os_memblock_from(&os_malloc_pools[i], ptr)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* The calling task, or NULL when there is no task context to cache in */
+static struct os_task *
+os_malloc_cache_task(void)
+{
+    if (!g_os_started) {
+        return NULL;
+    }
+    return os_sched_get_current_task();
+}
+
+/* Returns blocks from a cache class to its pool until only keep are left */
+static void
+os_malloc_cache_trim(struct os_malloc_cache *c, int cls, int keep)
+{
+    void *blocks[OS_MALLOC_CACHE_BATCH];
+    os_error_t rc;
+    int n;
+
+    while (c->omc_cnt[cls] > keep) {
+        n = 0;
+        while (c->omc_cnt[cls] > keep && n < OS_MALLOC_CACHE_BATCH) {
+            blocks[n] = c->omc_head[cls];
+            c->omc_head[cls] = *(void **)blocks[n];
+            c->omc_cnt[cls]--;
+            n++;
+        }
+        rc = os_memblock_put_n_untraced(&os_malloc_pools[cls], blocks, n);
+        assert(rc == OS_OK);
+        STATS_INC(os_malloc_stats, flush);
+    }
+}
+
+static void *
+os_malloc_cache_get(struct os_task *t, int cls)
+{
+    struct os_malloc_cache *c;
+    void *blocks[OS_MALLOC_CACHE_BATCH];
     void *ptr;
+    int n;
+    int i;
+
+    c = &t->t_malloc_cache;
+
+    ptr = c->omc_head[cls];
+    if (ptr != NULL) {
+        c->omc_head[cls] = *(void **)ptr;
+        c->omc_cnt[cls]--;
+        STATS_INC(os_malloc_stats, hit);
+    } else {
+        /*
+         * Cache is empty; take a batch from the pool and keep the rest.
+         * Blocks are traced as they leave the cache, not the pool.
+         */
+        n = os_memblock_get_n_untraced(&os_malloc_pools[cls], blocks,
+                                       OS_MALLOC_CACHE_BATCH);
+        if (n == 0) {
+            return NULL;
+        }
+        for (i = 1; i < n; i++) {
+            *(void **)blocks[i] = c->omc_head[cls];
+            c->omc_head[cls] = blocks[i];
+        }
+        c->omc_cnt[cls] = n - 1;
+        STATS_INC(os_malloc_stats, refill);
+        ptr = blocks[0];
+    }
+
+    OS_ALLOC_TRACE(OS_ALLOC_TRACE_MALLOC, ptr, OS_MALLOC_CACHE_SIZE(cls));
+
+    return ptr;
+}
+
+static void
+os_malloc_cache_put(struct os_task *t, int cls, void *ptr)
+{
+    struct os_malloc_cache *c;
+    os_error_t rc;
+
+    if (t == NULL) {
+        rc = os_memblock_put(&os_malloc_pools[cls], ptr);
+        assert(rc == OS_OK);
+        return;
+    }
+
+    OS_ALLOC_TRACE(OS_ALLOC_TRACE_FREE, ptr, 0);
+
+    c = &t->t_malloc_cache;
+    *(void **)ptr = c->omc_head[cls];
+    c->omc_head[cls] = ptr;
+    c->omc_cnt[cls]++;
+
+    if (c->omc_cnt[cls] > OS_MALLOC_CACHE_HWM) {
+        os_malloc_cache_trim(c, cls, OS_MALLOC_CACHE_HWM / 2);
+    }
+}
+#endif
+
+void
+os_malloc_task_flush(struct os_task *t)
+{
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+    int i;
+
+    for (i = 0; i < OS_MALLOC_CACHE_CLASSES; i++) {
+        os_malloc_cache_trim(&t->t_malloc_cache, i, 0);
+    }
+#endif
+}
+
+static void *
+os_heap_alloc(size_t size)
+{
+    void *ptr;
+
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+    struct os_task *t;
+    int cls;
+
+    cls = os_malloc_cache_class(size);
+    if (cls >= 0) {
+        t = os_malloc_cache_task();
+        if (t != NULL) {
+            ptr = os_malloc_cache_get(t, cls);
+            if (ptr != NULL) {
+                return ptr;
+            }
+        } else {
+            ptr = os_memblock_get(&os_malloc_pools[cls]);
+            if (ptr != NULL) {
+                return ptr;
+            }
+        }
+        STATS_INC(os_malloc_stats, fallback);
+    }
+#endif
 
     os_malloc_lock();
     ptr = malloc(size);
@@ -62,19 +322,59 @@ os_malloc(size_t size)
     return ptr;
 }
 
-void
-os_free(void *mem)
+static void
+os_heap_free(void *mem)
 {
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+    int cls;
+
+    if (mem == NULL) {
+        return;
+    }
+
+    cls = os_malloc_cache_owner(mem);
+    if (cls >= 0) {
+        os_malloc_cache_put(os_malloc_cache_task(), cls, mem);
+        return;
+    }
+#endif
+
     os_malloc_lock();
     free(mem);
     os_malloc_unlock();
 }
 
-void *
-os_realloc(void *ptr, size_t size)
+static void *
+os_heap_realloc(void *ptr, size_t size)
 {
     void *new_ptr;
 
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+    int cls;
+
+    if (ptr == NULL) {
+        return os_heap_alloc(size);
+    }
+
+    cls = os_malloc_cache_owner(ptr);
+    if (cls >= 0) {
+        if (size == 0) {
+            os_heap_free(ptr);
+            return NULL;
+        }
+        if (size <= OS_MALLOC_CACHE_SIZE(cls)) {
+            return ptr;
+        }
+
+        new_ptr = os_heap_alloc(size);
+        if (new_ptr != NULL) {
+            memcpy(new_ptr, ptr, OS_MALLOC_CACHE_SIZE(cls));
+            os_heap_free(ptr);
+        }
+        return new_ptr;
+    }
+#endif
+
     os_malloc_lock();
     new_ptr = realloc(ptr, size);
     os_malloc_unlock();
@@ -82,3 +382,35 @@ os_realloc(void *ptr, size_t size)
     return new_ptr;
 }
 
+void *
+os_malloc(size_t size)
+{
+    void *ptr;
+
+    ptr = os_heap_alloc(size);
+    OS_ALLOC_TRACE(OS_ALLOC_TRACE_MALLOC, ptr, size);
+
+    return ptr;
+}
+
+void
+os_free(void *mem)
+{
+    /* Trace first; once freed, the memory may be handed out again. */
+    OS_ALLOC_TRACE(OS_ALLOC_TRACE_FREE, mem, 0);
+    os_heap_free(mem);
+}
+
+void *
+os_realloc(void *ptr, size_t size)
+{
+    void *new_ptr;
+
+    new_ptr = os_heap_realloc(ptr, size);
+    if (new_ptr != NULL || size == 0) {
+        OS_ALLOC_TRACE(OS_ALLOC_TRACE_FREE, ptr, 0);
+        OS_ALLOC_TRACE(OS_ALLOC_TRACE_MALLOC, new_ptr, size);
+    }
+
+    return new_ptr;
+}
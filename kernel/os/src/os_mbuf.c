@@ -34,6 +34,7 @@
  */
 
 #include <assert.h>
+#include <stddef.h>
 #include <string.h>
 #include <limits.h>
 #include "syscfg/syscfg.h"
@@ -41,6 +42,14 @@
 #define OS_TRACE_DISABLE_FILE_API
 #endif
 #include "os/mynewt.h"
+#if MYNEWT_VAL(OS_MSYS_STATS)
+#include "stats/stats.h"
+#endif
+#include "os_priv.h"
+
+/* The packet and user headers are placed at om + sizeof(struct os_mbuf). */
+_Static_assert(offsetof(struct os_mbuf, om_databuf) == sizeof(struct os_mbuf),
+               "om_databuf shall be at the end of struct os_mbuf");
 
 /**
  * @addtogroup OSKernel
@@ -120,6 +129,240 @@ err:
     return (rc);
 }
 
+#if MYNEWT_VAL(OS_MSYS_SIZE_CLASS)
+
+#if MYNEWT_VAL(OS_MSYS_STATS)
+STATS_SECT_START(os_msys_stats)
+    STATS_SECT_ENTRY(hit)
+    STATS_SECT_ENTRY(miss)
+    STATS_SECT_ENTRY(fallback)
+    STATS_SECT_ENTRY(hwm)
+STATS_SECT_END
+
+STATS_NAME_START(os_msys_stats)
+    STATS_NAME(os_msys_stats, hit)
+    STATS_NAME(os_msys_stats, miss)
+    STATS_NAME(os_msys_stats, fallback)
+    STATS_NAME(os_msys_stats, hwm)
+STATS_NAME_END(os_msys_stats)
+
+/*
+ * Statistics are kept per registration slot, not per class, as registered
+ * stats sections must not move once registered.  Slots are reused after
+ * os_msys_reset().
+ */
+static STATS_SECT_DECL(os_msys_stats)
+    os_msys_stats[MYNEWT_VAL(OS_MSYS_SIZE_CLASS_MAX)];
+static uint8_t os_msys_stats_registered[MYNEWT_VAL(OS_MSYS_SIZE_CLASS_MAX)];
+static bool os_msys_stats_ready;
+#endif
+
+/*
+ * Registered pools, sorted by ascending omp_databuf_len.  Each pool is a
+ * size class; an allocation goes to the smallest class that fits the
+ * requested size and falls back to the next larger classes when that one is
+ * exhausted.
+ */
+static struct os_msys_class {
+    struct os_mbuf_pool *omc_pool;
+#if MYNEWT_VAL(OS_MSYS_STATS)
+    /* Index of the pool's stats in os_msys_stats */
+    uint8_t omc_stats_slot;
+#endif
+} os_msys_classes[MYNEWT_VAL(OS_MSYS_SIZE_CLASS_MAX)];
+static int os_msys_num_classes;
+
+#if MYNEWT_VAL(OS_MSYS_STATS)
+#define OS_MSYS_CLASS_STATS(class) \
+    os_msys_stats[os_msys_classes[(class)].omc_stats_slot]
+
+/* Number of blocks of the class' pool that were ever in use at once */
+static inline int
+os_msys_class_hwm(int class)
+{
+    struct os_mempool *mp;
+
+    mp = os_msys_classes[class].omc_pool->omp_pool;
+    return mp->mp_num_blocks - mp->mp_min_free;
+}
+
+static void
+os_msys_stats_register(int slot, struct os_mbuf_pool *pool)
+{
+    int rc;
+
+    rc = stats_init(STATS_HDR(os_msys_stats[slot]),
+                    STATS_SIZE_INIT_PARMS(os_msys_stats[slot], STATS_SIZE_32),
+                    STATS_NAME_INIT_PARMS(os_msys_stats));
+    if (rc != 0) {
+        return;
+    }
+
+    if (!os_msys_stats_registered[slot]) {
+        if (stats_register(pool->omp_pool->name,
+                           STATS_HDR(os_msys_stats[slot])) == 0) {
+            os_msys_stats_registered[slot] = 1;
+        }
+    }
+}
+
+void
+os_msys_stats_init(void)
+{
+    int i;
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+    /* Pools registered before the stats package came up. */
+    for (i = 0; i < os_msys_num_classes; i++) {
+        os_msys_stats_register(os_msys_classes[i].omc_stats_slot,
+                               os_msys_classes[i].omc_pool);
+    }
+    os_msys_stats_ready = true;
+}
+
+static void
+os_msys_stats_alloc(int class, int best)
+{
+    if (class == best) {
+        STATS_INC(OS_MSYS_CLASS_STATS(class), hit);
+    } else {
+        STATS_INC(OS_MSYS_CLASS_STATS(best), miss);
+        STATS_INC(OS_MSYS_CLASS_STATS(class), fallback);
+    }
+
+    STATS_CLEAR(OS_MSYS_CLASS_STATS(class), hwm);
+    STATS_INCN(OS_MSYS_CLASS_STATS(class), hwm, os_msys_class_hwm(class));
+}
+#else
+#define os_msys_stats_alloc(class, best)
+#endif
+
+int
+os_msys_register(struct os_mbuf_pool *new_pool)
+{
+    struct os_mbuf_pool *pool;
+    int i;
+
+    if (os_msys_num_classes >= MYNEWT_VAL(OS_MSYS_SIZE_CLASS_MAX)) {
+        return OS_ENOMEM;
+    }
+
+    /* Insertion sort; registration is rare and the table small. */
+    for (i = os_msys_num_classes; i > 0; i--) {
+        pool = os_msys_classes[i - 1].omc_pool;
+        if (pool->omp_databuf_len <= new_pool->omp_databuf_len) {
+            break;
+        }
+        os_msys_classes[i] = os_msys_classes[i - 1];
+    }
+    os_msys_classes[i].omc_pool = new_pool;
+#if MYNEWT_VAL(OS_MSYS_STATS)
+    os_msys_classes[i].omc_stats_slot = os_msys_num_classes;
+    if (os_msys_stats_ready) {
+        os_msys_stats_register(os_msys_num_classes, new_pool);
+    }
+#endif
+    os_msys_num_classes++;
+
+    STAILQ_INSERT_TAIL(&g_msys_pool_list, new_pool, omp_next);
+
+    return (0);
+}
+
+void
+os_msys_reset(void)
+{
+    os_msys_num_classes = 0;
+    STAILQ_INIT(&g_msys_pool_list);
+}
+
+/**
+ * Finds the best fit class for the given size: the smallest pool whose
+ * buffers hold dsize bytes, or the largest pool if none does.
+ */
+static int
+_os_msys_find_class(uint16_t dsize)
+{
+    int lo;
+    int hi;
+    int mid;
+
+    lo = 0;
+    hi = os_msys_num_classes - 1;
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (os_msys_classes[mid].omc_pool->omp_databuf_len < dsize) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+struct os_mbuf *
+os_msys_get(uint16_t dsize, uint16_t leadingspace)
+{
+    struct os_mbuf *m;
+    int best;
+    int i;
+
+    if (os_msys_num_classes == 0) {
+        return (NULL);
+    }
+
+    best = _os_msys_find_class(dsize);
+    for (i = best; i < os_msys_num_classes; i++) {
+        m = os_mbuf_get(os_msys_classes[i].omc_pool, leadingspace);
+        if (m) {
+            os_msys_stats_alloc(i, best);
+            OS_ALLOC_TRACE(OS_ALLOC_TRACE_MBUF_GET, m,
+                           m->om_omp->omp_pool->mp_block_size);
+            return (m);
+        }
+    }
+
+#if MYNEWT_VAL(OS_MSYS_STATS)
+    STATS_INC(OS_MSYS_CLASS_STATS(best), miss);
+#endif
+    return (NULL);
+}
+
+struct os_mbuf *
+os_msys_get_pkthdr(uint16_t dsize, uint16_t user_hdr_len)
+{
+    uint16_t total_pkthdr_len;
+    struct os_mbuf *m;
+    int best;
+    int i;
+
+    if (os_msys_num_classes == 0) {
+        return (NULL);
+    }
+
+    total_pkthdr_len =  user_hdr_len + sizeof(struct os_mbuf_pkthdr);
+    best = _os_msys_find_class(dsize + total_pkthdr_len);
+    for (i = best; i < os_msys_num_classes; i++) {
+        m = os_mbuf_get_pkthdr(os_msys_classes[i].omc_pool, user_hdr_len);
+        if (m) {
+            os_msys_stats_alloc(i, best);
+            OS_ALLOC_TRACE(OS_ALLOC_TRACE_MBUF_GET, m,
+                           m->om_omp->omp_pool->mp_block_size);
+            return (m);
+        }
+    }
+
+#if MYNEWT_VAL(OS_MSYS_STATS)
+    STATS_INC(OS_MSYS_CLASS_STATS(best), miss);
+#endif
+    return (NULL);
+}
+
+#else
+
 int
 os_msys_register(struct os_mbuf_pool *new_pool)
 {
@@ -179,6 +422,10 @@ os_msys_get(uint16_t dsize, uint16_t leadingspace)
     }
 
     m = os_mbuf_get(pool, leadingspace);
+    if (m) {
+        OS_ALLOC_TRACE(OS_ALLOC_TRACE_MBUF_GET, m,
+                       pool->omp_pool->mp_block_size);
+    }
     return (m);
 err:
     return (NULL);
@@ -198,11 +445,17 @@ os_msys_get_pkthdr(uint16_t dsize, uint16_t user_hdr_len)
     }
 
     m = os_mbuf_get_pkthdr(pool, user_hdr_len);
+    if (m) {
+        OS_ALLOC_TRACE(OS_ALLOC_TRACE_MBUF_GET, m,
+                       pool->omp_pool->mp_block_size);
+    }
     return (m);
 err:
     return (NULL);
 }
 
+#endif
+
 int
 os_msys_count(void)
 {
@@ -266,6 +519,12 @@ os_mbuf_get(struct os_mbuf_pool *omp, uint16_t leadingspace)
     om->om_len = 0;
     om->om_data = (&om->om_databuf[0] + leadingspace);
     om->om_omp = omp;
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+    om->om_shared = NULL;
+    om->om_refcnt = 1;
+#endif
+
+    OS_ALLOC_TRACE(OS_ALLOC_TRACE_MBUF_GET, om, omp->omp_pool->mp_block_size);
 
 done:
     os_trace_api_ret_u32(OS_TRACE_ID_MBUF_GET, (uint32_t)om);
@@ -298,6 +557,9 @@ os_mbuf_get_pkthdr(struct os_mbuf_pool *omp, uint8_t user_pkthdr_len)
         pkthdr->omp_len = 0;
         pkthdr->omp_flags = 0;
         STAILQ_NEXT(pkthdr, omp_next) = NULL;
+
+        OS_ALLOC_TRACE(OS_ALLOC_TRACE_MBUF_GET, om,
+                       omp->omp_pool->mp_block_size);
     }
 
 done:
@@ -305,19 +567,59 @@ done:
     return om;
 }
 
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+/*
+ * Drops a reference to the buffer of the given mbuf, returning the buffer to
+ * its pool if this was the last one.
+ */
+static int
+_os_mbuf_release(struct os_mbuf *om)
+{
+    os_sr_t sr;
+    int last;
+
+    OS_ENTER_CRITICAL(sr);
+    assert(om->om_refcnt > 0);
+    om->om_refcnt--;
+    last = om->om_refcnt == 0;
+    OS_EXIT_CRITICAL(sr);
+
+    if (last && om->om_omp != NULL) {
+        return os_memblock_put(om->om_omp->omp_pool, om);
+    }
+
+    return 0;
+}
+#endif
+
 int
 os_mbuf_free(struct os_mbuf *om)
 {
     int rc;
 
     os_trace_api_u32(OS_TRACE_ID_MBUF_FREE, (uint32_t)om);
+    OS_ALLOC_TRACE(OS_ALLOC_TRACE_MBUF_FREE, om, 0);
 
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+    if (om->om_shared != NULL) {
+        rc = _os_mbuf_release(om->om_shared);
+        if (rc != 0) {
+            goto done;
+        }
+    }
+
+    rc = _os_mbuf_release(om);
+    if (rc != 0) {
+        goto done;
+    }
+#else
     if (om->om_omp != NULL) {
         rc = os_memblock_put(om->om_omp->omp_pool, om);
         if (rc != 0) {
             goto done;
         }
     }
+#endif
 
     rc = 0;
 
@@ -385,16 +687,20 @@ os_mbuf_len(const struct os_mbuf *om)
 }
 
 int
-os_mbuf_append(struct os_mbuf *om, const void *data,  uint16_t len)
+os_mbuf_appendv(struct os_mbuf *om, const struct os_mbuf_iovec *iov,
+                int iovcnt)
 {
     struct os_mbuf_pool *omp;
     struct os_mbuf *last;
     struct os_mbuf *new;
+    const uint8_t *data;
     int remainder;
+    int appended;
     int space;
     int rc;
+    int i;
 
-    if (om == NULL) {
+    if (om == NULL || (iov == NULL && iovcnt > 0)) {
         rc = OS_EINVAL;
         goto err;
     }
@@ -407,57 +713,65 @@ os_mbuf_append(struct os_mbuf *om, const void *data,  uint16_t len)
         last = SLIST_NEXT(last, om_next);
     }
 
-    remainder = len;
-    space = OS_MBUF_TRAILINGSPACE(last);
-
-    /* If room in current mbuf, copy the first part of the data into the
-     * remaining space in that mbuf.
+    /* Fill the remaining space in the last mbuf, then keep allocating new
+     * mbufs and copying data into them, until all buffers are exhausted.
      */
-    if (space > 0) {
-        if (space > remainder) {
-            space = remainder;
-        }
-
-        memcpy(OS_MBUF_DATA(last, uint8_t *) + last->om_len , data, space);
+    rc = 0;
+    appended = 0;
+    for (i = 0; i < iovcnt && rc == 0; i++) {
+        data = iov[i].omi_base;
+        remainder = iov[i].omi_len;
+
+        while (remainder > 0) {
+            space = OS_MBUF_TRAILINGSPACE(last);
+            if (space <= 0) {
+                new = os_mbuf_get(omp, 0);
+                if (!new) {
+                    rc = OS_ENOMEM;
+                    break;
+                }
+                SLIST_NEXT(last, om_next) = new;
+                last = new;
+                space = OS_MBUF_TRAILINGSPACE(last);
+            }
 
-        last->om_len += space;
-        data += space;
-        remainder -= space;
-    }
+            if (space > remainder) {
+                space = remainder;
+            }
 
-    /* Take the remaining data, and keep allocating new mbufs and copying
-     * data into it, until data is exhausted.
-     */
-    while (remainder > 0) {
-        new = os_mbuf_get(omp, 0);
-        if (!new) {
-            break;
+            memcpy(OS_MBUF_DATA(last, uint8_t *) + last->om_len, data, space);
+            last->om_len += space;
+            data += space;
+            remainder -= space;
+            appended += space;
         }
-
-        new->om_len = min(omp->omp_databuf_len, remainder);
-        memcpy(OS_MBUF_DATA(new, void *), data, new->om_len);
-        data += new->om_len;
-        remainder -= new->om_len;
-        SLIST_NEXT(last, om_next) = new;
-        last = new;
     }
 
     /* Adjust the packet header length in the buffer */
     if (OS_MBUF_IS_PKTHDR(om)) {
-        OS_MBUF_PKTHDR(om)->omp_len += len - remainder;
+        OS_MBUF_PKTHDR(om)->omp_len += appended;
     }
 
-    if (remainder != 0) {
-        rc = OS_ENOMEM;
+    if (rc != 0) {
         goto err;
     }
 
-
     return (0);
 err:
     return (rc);
 }
 
+int
+os_mbuf_append(struct os_mbuf *om, const void *data,  uint16_t len)
+{
+    struct os_mbuf_iovec iov;
+
+    iov.omi_base = (void *)data;
+    iov.omi_len = len;
+
+    return os_mbuf_appendv(om, &iov, 1);
+}
+
 int
 os_mbuf_appendfrom(struct os_mbuf *dst, const struct os_mbuf *src,
                    uint16_t src_off, uint16_t len)
@@ -531,6 +845,129 @@ err:
     return (NULL);
 }
 
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+struct os_mbuf *
+os_mbuf_clone(struct os_mbuf_pool *omp, struct os_mbuf *om)
+{
+    struct os_mbuf_pool *hdr_omp;
+    struct os_mbuf *head;
+    struct os_mbuf *copy;
+    struct os_mbuf *prev;
+    struct os_mbuf *buf;
+    os_sr_t sr;
+
+    head = NULL;
+    prev = NULL;
+
+    for (; om != NULL; om = SLIST_NEXT(om, om_next)) {
+        hdr_omp = omp != NULL ? omp : om->om_omp;
+
+        if (head == NULL && OS_MBUF_IS_PKTHDR(om)) {
+            copy = os_mbuf_get_pkthdr(hdr_omp, OS_MBUF_USRHDR_LEN(om));
+            if (copy != NULL) {
+                _os_mbuf_copypkthdr(copy, om);
+            }
+        } else {
+            copy = os_mbuf_get(hdr_omp, 0);
+        }
+        if (copy == NULL) {
+            os_mbuf_free_chain(head);
+            return (NULL);
+        }
+
+        /* Always refer to the mbuf that really holds the data, so cloning a
+         * clone does not keep the intermediate header alive.
+         */
+        buf = _OS_MBUF_BUF(om);
+        OS_ENTER_CRITICAL(sr);
+        buf->om_refcnt++;
+        OS_EXIT_CRITICAL(sr);
+
+        copy->om_shared = buf;
+        copy->om_flags = om->om_flags;
+        copy->om_data = om->om_data;
+        copy->om_len = om->om_len;
+
+        if (prev == NULL) {
+            head = copy;
+        } else {
+            SLIST_NEXT(prev, om_next) = copy;
+        }
+        prev = copy;
+    }
+
+    return (head);
+}
+
+/*
+ * Gives a single mbuf a private copy of its data.  A clone whose own buffer
+ * is unused moves the data there; otherwise a new buffer is taken from the
+ * pool the data currently lives in and this mbuf becomes its only user.
+ */
+static int
+_os_mbuf_unshare(struct os_mbuf *om)
+{
+    struct os_mbuf *old;
+    struct os_mbuf *buf;
+    struct os_mbuf *n;
+    uint16_t leading;
+    uint16_t room;
+    uint8_t *dst;
+
+    if (!OS_MBUF_IS_SHARED(om)) {
+        return 0;
+    }
+
+    buf = _OS_MBUF_BUF(om);
+    leading = om->om_data - (buf->om_databuf + buf->om_pkthdr_len);
+
+    room = om->om_omp->omp_databuf_len - om->om_pkthdr_len;
+    if (om->om_shared != NULL && om->om_refcnt == 1 && room >= om->om_len) {
+        leading = min(leading, room - om->om_len);
+        dst = om->om_databuf + om->om_pkthdr_len + leading;
+        memcpy(dst, om->om_data, om->om_len);
+        n = NULL;
+    } else {
+        room = buf->om_omp->omp_databuf_len;
+        leading = min(leading, room - om->om_len);
+        n = os_mbuf_get(buf->om_omp, leading);
+        if (n == NULL) {
+            return OS_ENOMEM;
+        }
+        dst = n->om_data;
+        memcpy(dst, om->om_data, om->om_len);
+    }
+
+    /* The new buffer, if any, is owned by a header that is in no chain; it
+     * goes away with the last reference, i.e. when this mbuf is freed.
+     */
+    old = om->om_shared;
+    om->om_shared = n;
+    om->om_data = dst;
+
+    if (old != NULL) {
+        return _os_mbuf_release(old);
+    }
+
+    return 0;
+}
+
+int
+os_mbuf_unshare(struct os_mbuf *om)
+{
+    int rc;
+
+    for (; om != NULL; om = SLIST_NEXT(om, om_next)) {
+        rc = _os_mbuf_unshare(om);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    return 0;
+}
+#endif
+
 struct os_mbuf *
 os_mbuf_off(const struct os_mbuf *om, int off, uint16_t *out_off)
 {
@@ -593,6 +1030,56 @@ os_mbuf_copydata(const struct os_mbuf *m, int off, int len, void *dst)
     return (len > 0 ? -1 : 0);
 }
 
+int
+os_mbuf_iter_init(struct os_mbuf_iter *it, const struct os_mbuf *om,
+                  int off, int len)
+{
+    if (off < 0) {
+        return OS_EINVAL;
+    }
+
+    while (om != NULL && off >= om->om_len) {
+        off -= om->om_len;
+        om = SLIST_NEXT(om, om_next);
+    }
+
+    if (om == NULL && off > 0) {
+        return OS_EINVAL;
+    }
+
+    it->omit_om = om;
+    it->omit_off = off;
+    it->omit_left = len;
+
+    return 0;
+}
+
+int
+os_mbuf_iter_next(struct os_mbuf_iter *it, struct os_mbuf_iovec *iov)
+{
+    const struct os_mbuf *om;
+    int len;
+
+    while (it->omit_om != NULL && it->omit_left > 0) {
+        om = it->omit_om;
+
+        len = min(om->om_len - it->omit_off, it->omit_left);
+        iov->omi_base = om->om_data + it->omit_off;
+        iov->omi_len = len;
+
+        it->omit_om = SLIST_NEXT(om, om_next);
+        it->omit_off = 0;
+        it->omit_left -= len;
+
+        /* Skip empty mbufs. */
+        if (len > 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 void
 os_mbuf_adj(struct os_mbuf *mp, int req_len)
 {
@@ -853,6 +1340,12 @@ os_mbuf_copyinto(struct os_mbuf *om, int off, const void *src, int len)
     while (1) {
         copylen = min(cur->om_len - cur_off, len);
         if (copylen > 0) {
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+            rc = _os_mbuf_unshare(cur);
+            if (rc != 0) {
+                return rc;
+            }
+#endif
             memcpy(cur->om_data + cur_off, sptr, copylen);
             sptr += copylen;
             len -= copylen;
@@ -889,6 +1382,92 @@ os_mbuf_copyinto(struct os_mbuf *om, int off, const void *src, int len)
     return 0;
 }
 
+int
+os_mbuf_copyinto_v(struct os_mbuf *om, int off,
+                   const struct os_mbuf_iovec *iov, int iovcnt)
+{
+    struct os_mbuf_iovec rem;
+    struct os_mbuf *next;
+    struct os_mbuf *cur;
+    const uint8_t *sptr;
+    uint16_t cur_off;
+    int copylen;
+    int total;
+    int len;
+    int rc;
+    int i;
+
+    /* Find the mbuf,offset pair for the start of the destination. */
+    cur = os_mbuf_off(om, off, &cur_off);
+    if (cur == NULL) {
+        return -1;
+    }
+
+    total = 0;
+    for (i = 0; i < iovcnt; i++) {
+        total += iov[i].omi_len;
+    }
+
+    /* Overwrite existing data until we reach the end of the chain. */
+    for (i = 0; i < iovcnt; i++) {
+        sptr = iov[i].omi_base;
+        len = iov[i].omi_len;
+
+        while (len > 0) {
+            copylen = min(cur->om_len - cur_off, len);
+            if (copylen > 0) {
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+                rc = _os_mbuf_unshare(cur);
+                if (rc != 0) {
+                    return rc;
+                }
+#endif
+                memcpy(cur->om_data + cur_off, sptr, copylen);
+                sptr += copylen;
+                len -= copylen;
+                cur_off += copylen;
+            }
+
+            if (len == 0) {
+                break;
+            }
+
+            next = SLIST_NEXT(cur, om_next);
+            if (next == NULL) {
+                goto append;
+            }
+
+            cur = next;
+            cur_off = 0;
+        }
+    }
+
+    /* All the source data fit in the existing mbuf chain. */
+    return 0;
+
+append:
+    /* Append the rest of this buffer and all the following ones to the end
+     * of the chain.
+     */
+    rem.omi_base = (void *)sptr;
+    rem.omi_len = len;
+    rc = os_mbuf_appendv(cur, &rem, 1);
+    if (rc == 0) {
+        rc = os_mbuf_appendv(cur, iov + i + 1, iovcnt - i - 1);
+    }
+    if (rc != 0) {
+        return rc;
+    }
+
+    /* Fix up the packet header, if one is present. */
+    if (OS_MBUF_IS_PKTHDR(om)) {
+        OS_MBUF_PKTHDR(om)->omp_len =
+            max(OS_MBUF_PKTHDR(om)->omp_len, off + total);
+    }
+
+    return 0;
+}
+
 void
 os_mbuf_concat(struct os_mbuf *first, struct os_mbuf *second)
 {
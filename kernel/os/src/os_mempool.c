@@ -275,48 +275,250 @@ os_memblock_from(const struct os_mempool *mp, const void *block_addr)
     return 1;
 }
 
-void *
-os_memblock_get(struct os_mempool *mp)
+#if MYNEWT_VAL(OS_MEMPOOL_LOCKFREE)
+#if !defined(__ARM_ARCH_7M__) && !defined(__ARM_ARCH_7EM__) && \
+    !defined(__ARM_ARCH_8M_MAIN__)
+#error "OS_MEMPOOL_LOCKFREE requires LDREX/STREX (Cortex-M3 or later)"
+#endif
+
+/*
+ * The free list is a LIFO updated with LDREX/STREX.  An exception entry or
+ * return clears the local exclusive monitor, so any interrupt or context
+ * switch that touches the list between the load and the store makes the store
+ * fail and the operation is retried; this also rules out ABA, unlike a plain
+ * compare-and-swap on the head pointer.
+ */
+static inline void *
+os_mempool_ldrex(void *volatile *addr)
+{
+    void *val;
+
+    __asm__ volatile ("ldrex %0, [%1]" : "=r" (val) : "r" (addr) : "memory");
+    return val;
+}
+
+static inline int
+os_mempool_strex(void *volatile *addr, void *val)
+{
+    uint32_t rc;
+
+    __asm__ volatile ("strex %0, %2, [%1]"
+                      : "=&r" (rc) : "r" (addr), "r" (val) : "memory");
+    return rc;
+}
+
+static inline void
+os_mempool_clrex(void)
+{
+    __asm__ volatile ("clrex" : : : "memory");
+}
+
+/*
+ * Atomically adjusts the free count.  The count is raised before blocks are
+ * pushed and lowered after they are popped, so it never drops below the
+ * length of the free list.  mp_min_free is statistics only and is updated
+ * without synchronization.
+ */
+static void
+os_mempool_num_free_add(struct os_mempool *mp, int delta)
+{
+    uint32_t val;
+    uint32_t rc;
+
+    do {
+        __asm__ volatile ("ldrexh %0, [%1]"
+                          : "=r" (val) : "r" (&mp->mp_num_free) : "memory");
+        val = (uint16_t)(val + delta);
+        __asm__ volatile ("strexh %0, %2, [%1]"
+                          : "=&r" (rc) : "r" (&mp->mp_num_free), "r" (val)
+                          : "memory");
+    } while (rc != 0);
+
+    if (mp->mp_min_free > val) {
+        mp->mp_min_free = val;
+    }
+}
+
+static int
+os_mempool_pop(struct os_mempool *mp, void **blocks, int n)
+{
+    struct os_memblock *block;
+    struct os_memblock *next;
+    int cnt;
+
+    /* Blocks are popped one at a time; following more than one link between
+     * LDREX and STREX could dereference a block that an interrupt has
+     * already handed out and overwritten.
+     */
+    for (cnt = 0; cnt < n; cnt++) {
+        do {
+            block = os_mempool_ldrex((void *volatile *)&SLIST_FIRST(mp));
+            if (block == NULL) {
+                os_mempool_clrex();
+                break;
+            }
+            next = SLIST_NEXT(block, mb_next);
+        } while (os_mempool_strex((void *volatile *)&SLIST_FIRST(mp), next));
+
+        if (block == NULL) {
+            break;
+        }
+        blocks[cnt] = block;
+    }
+
+    if (cnt > 0) {
+        os_mempool_num_free_add(mp, -cnt);
+    }
+
+    return cnt;
+}
+
+static void
+os_mempool_push(struct os_mempool *mp, struct os_memblock *head,
+                struct os_memblock *tail, int cnt)
+{
+    os_mempool_num_free_add(mp, cnt);
+
+    do {
+        SLIST_NEXT(tail, mb_next) =
+            os_mempool_ldrex((void *volatile *)&SLIST_FIRST(mp));
+    } while (os_mempool_strex((void *volatile *)&SLIST_FIRST(mp), head));
+}
+#else
+static int
+os_mempool_pop(struct os_mempool *mp, void **blocks, int n)
 {
     os_sr_t sr;
+    int cnt;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+
+    cnt = n;
+    if (cnt > mp->mp_num_free) {
+        cnt = mp->mp_num_free;
+    }
+
+    for (i = 0; i < cnt; i++) {
+        blocks[i] = SLIST_FIRST(mp);
+        SLIST_FIRST(mp) = SLIST_NEXT(SLIST_FIRST(mp), mb_next);
+    }
+
+    mp->mp_num_free -= cnt;
+    if (mp->mp_min_free > mp->mp_num_free) {
+        mp->mp_min_free = mp->mp_num_free;
+    }
+
+    OS_EXIT_CRITICAL(sr);
+
+    return cnt;
+}
+
+static void
+os_mempool_push(struct os_mempool *mp, struct os_memblock *head,
+                struct os_memblock *tail, int cnt)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+
+    /* Chain current free list to the tail; make the head the new head */
+    SLIST_NEXT(tail, mb_next) = SLIST_FIRST(mp);
+    SLIST_FIRST(mp) = head;
+
+    /* XXX: Should we check that the number free <= number blocks? */
+    mp->mp_num_free += cnt;
+
+    OS_EXIT_CRITICAL(sr);
+}
+#endif
+
+#if MYNEWT_VAL(OS_MEMPOOL_CHECK)
+static void
+os_mempool_check_put(struct os_mempool *mp, void *block_addr)
+{
     struct os_memblock *block;
 
+    /* Check that the block we are freeing is a valid block! */
+    assert(os_memblock_from(mp, block_addr));
+
+    /*
+     * Check for duplicate free.
+     */
+    SLIST_FOREACH(block, mp, mb_next) {
+        assert(block != (struct os_memblock *)block_addr);
+    }
+}
+#else
+#define os_mempool_check_put(mp, block_addr)
+#endif
+
+void *
+os_memblock_get(struct os_mempool *mp)
+{
+    void *block;
+
     os_trace_api_u32(OS_TRACE_ID_MEMBLOCK_GET, (uint32_t)mp);
 
     /* Check to make sure they passed in a memory pool (or something) */
     block = NULL;
     if (mp) {
-        OS_ENTER_CRITICAL(sr);
-        /* Check for any free */
-        if (mp->mp_num_free) {
-            /* Get a free block */
-            block = SLIST_FIRST(mp);
-
-            /* Set new free list head */
-            SLIST_FIRST(mp) = SLIST_NEXT(block, mb_next);
-
-            /* Decrement number free by 1 */
-            mp->mp_num_free--;
-            if (mp->mp_min_free > mp->mp_num_free) {
-                mp->mp_min_free = mp->mp_num_free;
-            }
-        }
-        OS_EXIT_CRITICAL(sr);
-
-        if (block) {
+        if (os_mempool_pop(mp, &block, 1)) {
             os_mempool_poison_check(block, OS_MEMPOOL_TRUE_BLOCK_SIZE(mp));
+            OS_ALLOC_TRACE(OS_ALLOC_TRACE_MEMBLOCK_GET, block,
+                           mp->mp_block_size);
         }
     }
 
     os_trace_api_ret_u32(OS_TRACE_ID_MEMBLOCK_GET, (uint32_t)block);
 
-    return (void *)block;
+    return block;
+}
+
+/*
+ * Takes up to n blocks.  The blocks are traced as taken by caller, or not
+ * at all if caller is NULL.
+ */
+static int
+os_mempool_get_n(struct os_mempool *mp, void **blocks, int n,
+                 const void *caller)
+{
+    int cnt;
+    int i;
+
+    if ((mp == NULL) || (blocks == NULL) || (n <= 0)) {
+        return 0;
+    }
+
+    cnt = os_mempool_pop(mp, blocks, n);
+    for (i = 0; i < cnt; i++) {
+        os_mempool_poison_check(blocks[i], OS_MEMPOOL_TRUE_BLOCK_SIZE(mp));
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+        if (caller != NULL) {
+            os_alloc_trace_record(OS_ALLOC_TRACE_MEMBLOCK_GET, blocks[i],
+                                  mp->mp_block_size, caller);
+        }
+#endif
+    }
+
+    return cnt;
+}
+
+int
+os_memblock_get_n(struct os_mempool *mp, void **blocks, int n)
+{
+    return os_mempool_get_n(mp, blocks, n, __builtin_return_address(0));
+}
+
+int
+os_memblock_get_n_untraced(struct os_mempool *mp, void **blocks, int n)
+{
+    return os_mempool_get_n(mp, blocks, n, NULL);
 }
 
 os_error_t
 os_memblock_put_from_cb(struct os_mempool *mp, void *block_addr)
 {
-    os_sr_t sr;
     struct os_memblock *block;
 
     os_trace_api_u32x2(OS_TRACE_ID_MEMBLOCK_PUT_FROM_CB, (uint32_t)mp,
@@ -325,17 +527,7 @@ os_memblock_put_from_cb(struct os_mempool *mp, void *block_addr)
     os_mempool_poison(block_addr, OS_MEMPOOL_TRUE_BLOCK_SIZE(mp));
 
     block = (struct os_memblock *)block_addr;
-    OS_ENTER_CRITICAL(sr);
-
-    /* Chain current free list pointer to this block; make this block head */
-    SLIST_NEXT(block, mb_next) = SLIST_FIRST(mp);
-    SLIST_FIRST(mp) = block;
-
-    /* XXX: Should we check that the number free <= number blocks? */
-    /* Increment number free */
-    mp->mp_num_free++;
-
-    OS_EXIT_CRITICAL(sr);
+    os_mempool_push(mp, block, block, 1);
 
     os_trace_api_ret_u32(OS_TRACE_ID_MEMBLOCK_PUT_FROM_CB, (uint32_t)OS_OK);
 
@@ -347,9 +539,6 @@ os_memblock_put(struct os_mempool *mp, void *block_addr)
 {
     struct os_mempool_ext *mpe;
     os_error_t ret;
-#if MYNEWT_VAL(OS_MEMPOOL_CHECK)
-    struct os_memblock *block;
-#endif
 
     os_trace_api_u32x2(OS_TRACE_ID_MEMBLOCK_PUT, (uint32_t)mp,
                        (uint32_t)block_addr);
@@ -360,17 +549,8 @@ os_memblock_put(struct os_mempool *mp, void *block_addr)
         goto done;
     }
 
-#if MYNEWT_VAL(OS_MEMPOOL_CHECK)
-    /* Check that the block we are freeing is a valid block! */
-    assert(os_memblock_from(mp, block_addr));
-
-    /*
-     * Check for duplicate free.
-     */
-    SLIST_FOREACH(block, mp, mb_next) {
-        assert(block != (struct os_memblock *)block_addr);
-    }
-#endif
+    os_mempool_check_put(mp, block_addr);
+    OS_ALLOC_TRACE(OS_ALLOC_TRACE_MEMBLOCK_PUT, block_addr, 0);
 
     /* If this is an extended mempool with a put callback, call the callback
      * instead of freeing the block directly.
@@ -391,6 +571,84 @@ done:
     return ret;
 }
 
+/*
+ * Frees n blocks.  The blocks are traced as freed by caller, or not at all
+ * if caller is NULL.
+ */
+static os_error_t
+os_mempool_put_n(struct os_mempool *mp, void **blocks, int n,
+                 const void *caller)
+{
+    struct os_memblock *block;
+    struct os_mempool_ext *mpe;
+    os_error_t ret;
+    os_error_t rc;
+    int i;
+
+    if ((mp == NULL) || (blocks == NULL) || (n < 0)) {
+        return OS_INVALID_PARM;
+    }
+    if (n == 0) {
+        return OS_OK;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (blocks[i] == NULL) {
+            return OS_INVALID_PARM;
+        }
+        os_mempool_check_put(mp, blocks[i]);
+    }
+
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+    if (caller != NULL) {
+        for (i = 0; i < n; i++) {
+            os_alloc_trace_record(OS_ALLOC_TRACE_MEMBLOCK_PUT, blocks[i], 0,
+                                  caller);
+        }
+    }
+#endif
+
+    /* A put callback has to see every block; free them one by one. */
+    if (mp->mp_flags & OS_MEMPOOL_F_EXT) {
+        mpe = (struct os_mempool_ext *)mp;
+        if (mpe->mpe_put_cb != NULL) {
+            ret = OS_OK;
+            for (i = 0; i < n; i++) {
+                rc = mpe->mpe_put_cb(mpe, blocks[i], mpe->mpe_put_arg);
+                if (rc != OS_OK && ret == OS_OK) {
+                    ret = rc;
+                }
+            }
+            return ret;
+        }
+    }
+
+    /* Chain the blocks outside of the critical section. */
+    for (i = 0; i < n; i++) {
+        os_mempool_poison(blocks[i], OS_MEMPOOL_TRUE_BLOCK_SIZE(mp));
+        block = blocks[i];
+        if (i + 1 < n) {
+            SLIST_NEXT(block, mb_next) = blocks[i + 1];
+        }
+    }
+
+    os_mempool_push(mp, blocks[0], blocks[n - 1], n);
+
+    return OS_OK;
+}
+
+os_error_t
+os_memblock_put_n(struct os_mempool *mp, void **blocks, int n)
+{
+    return os_mempool_put_n(mp, blocks, n, __builtin_return_address(0));
+}
+
+os_error_t
+os_memblock_put_n_untraced(struct os_mempool *mp, void **blocks, int n)
+{
+    return os_mempool_put_n(mp, blocks, n, NULL);
+}
+
 struct os_mempool *
 os_mempool_info_get_next(struct os_mempool *mp, struct os_mempool_info *omi)
 {
@@ -24,10 +24,131 @@
 #endif
 #include "os/mynewt.h"
 
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+#include <string.h>
+
+static STAILQ_HEAD(, os_mutex) os_mutex_list =
+    STAILQ_HEAD_INITIALIZER(os_mutex_list);
+
+static int
+os_mutex_is_registered(const struct os_mutex *mu)
+{
+    struct os_mutex *cur;
+
+    STAILQ_FOREACH(cur, &os_mutex_list, mu_next) {
+        if (cur == mu) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Must be called with interrupts disabled */
+static void
+os_mutex_stats_acquired(struct os_mutex *mu)
+{
+    mu->mu_stats.oms_acquired++;
+    mu->mu_stats.oms_hold_start = os_cputime_get32();
+}
+
+/* Must be called with interrupts disabled */
+static void
+os_mutex_stats_released(struct os_mutex *mu)
+{
+    uint32_t held;
+
+    held = os_cputime_get32() - mu->mu_stats.oms_hold_start;
+    if (held > mu->mu_stats.oms_max_hold) {
+        mu->mu_stats.oms_max_hold = held;
+    }
+}
+
+static void
+os_mutex_stats_waited(struct os_mutex *mu, uint32_t start)
+{
+    uint32_t waited;
+    os_sr_t sr;
+
+    waited = os_cputime_get32() - start;
+
+    OS_ENTER_CRITICAL(sr);
+    mu->mu_stats.oms_contended++;
+    mu->mu_stats.oms_wait_total += waited;
+    if (waited > mu->mu_stats.oms_max_wait) {
+        mu->mu_stats.oms_max_wait = waited;
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+#else
+#define os_mutex_stats_acquired(mu)
+#define os_mutex_stats_released(mu)
+#endif
+
+/*
+ * Adds a task to the wait list of a mutex, which is kept in priority order.
+ * Must be called with interrupts disabled.
+ */
+static void
+os_mutex_waiter_insert(struct os_mutex *mu, struct os_task *t)
+{
+    struct os_task *entry;
+    struct os_task *last;
+
+    last = NULL;
+    SLIST_FOREACH(entry, &mu->mu_head, t_obj_list) {
+        if (t->t_prio < entry->t_prio) {
+            break;
+        }
+        last = entry;
+    }
+
+    if (last) {
+        SLIST_INSERT_AFTER(last, t, t_obj_list);
+    } else {
+        SLIST_INSERT_HEAD(&mu->mu_head, t, t_obj_list);
+    }
+}
+
+/*
+ * Raises the owner of a mutex to the given priority.  If the owner is
+ * waiting on another mutex in turn, it is requeued there at its new priority
+ * and the boost is passed on to that mutex's owner, and so on down the
+ * chain.  The walk stops at the first owner that already runs at the
+ * priority, so it also ends on a deadlock cycle.  Must be called with
+ * interrupts disabled.
+ */
+static void
+os_mutex_inherit(struct os_mutex *mu, uint8_t prio)
+{
+    struct os_task *owner;
+
+    while (1) {
+        owner = mu->mu_owner;
+        if (owner == NULL || owner->t_prio <= prio) {
+            break;
+        }
+
+        owner->t_prio = prio;
+        os_sched_resort(owner);
+
+        if (!(owner->t_flags & OS_TASK_FLAG_MUTEX_WAIT) ||
+            owner->t_obj == NULL) {
+            break;
+        }
+
+        mu = owner->t_obj;
+        SLIST_REMOVE(&mu->mu_head, owner, os_task, t_obj_list);
+        os_mutex_waiter_insert(mu, owner);
+    }
+}
+
 os_error_t
 os_mutex_init(struct os_mutex *mu)
 {
     os_error_t ret;
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    const char *name;
+#endif
 
     if (!mu) {
         ret = OS_INVALID_PARM;
@@ -42,6 +163,20 @@ os_mutex_init(struct os_mutex *mu)
     mu->mu_owner = NULL;
     SLIST_FIRST(&mu->mu_head) = NULL;
 
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    /* Keep the mutex registered across re-initialization. */
+    name = NULL;
+    if (os_mutex_is_registered(mu)) {
+        name = mu->mu_name;
+        STAILQ_REMOVE(&os_mutex_list, mu, os_mutex, mu_next);
+    }
+    memset(&mu->mu_stats, 0, sizeof mu->mu_stats);
+    mu->mu_name = NULL;
+    if (name != NULL) {
+        os_mutex_register(mu, name);
+    }
+#endif
+
     ret = OS_OK;
 
 done:
@@ -88,6 +223,8 @@ os_mutex_release(struct os_mutex *mu)
 
     OS_ENTER_CRITICAL(sr);
 
+    os_mutex_stats_released(mu);
+
     /* Restore owner task's priority; resort list if different  */
     if (current->t_prio != mu->mu_prio) {
         current->t_prio = mu->mu_prio;
@@ -104,6 +241,7 @@ os_mutex_release(struct os_mutex *mu)
         /* Set mutex internals */
         mu->mu_level = 1;
         mu->mu_prio = rdy->t_prio;
+        os_mutex_stats_acquired(mu);
     }
 
     /* Set new owner of mutex (or NULL if not owned) */
@@ -139,8 +277,9 @@ os_mutex_pend(struct os_mutex *mu, os_time_t timeout)
     os_sr_t sr;
     os_error_t ret;
     struct os_task *current;
-    struct os_task *entry;
-    struct os_task *last;
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    uint32_t wait_start;
+#endif
 
     os_trace_api_u32x2(OS_TRACE_ID_MUTEX_PEND, (uint32_t)mu, (uint32_t)timeout);
 
@@ -165,6 +304,7 @@ os_mutex_pend(struct os_mutex *mu, os_time_t timeout)
         mu->mu_prio  = current->t_prio;
         current->t_lockcnt++;
         mu->mu_level = 1;
+        os_mutex_stats_acquired(mu);
         OS_EXIT_CRITICAL(sr);
         ret = OS_OK;
         goto done;
@@ -185,29 +325,15 @@ os_mutex_pend(struct os_mutex *mu, os_time_t timeout)
         goto done;
     }
 
-    /* Change priority of owner if needed */
-    if (mu->mu_owner->t_prio > current->t_prio) {
-        mu->mu_owner->t_prio = current->t_prio;
-        os_sched_resort(mu->mu_owner);
-    }
+    /* Raise the priority of the owner, and of whoever it waits on. */
+    os_mutex_inherit(mu, current->t_prio);
 
     /* Link current task to tasks waiting for mutex */
-    last = NULL;
-    if (!SLIST_EMPTY(&mu->mu_head)) {
-        /* Insert in priority order */
-        SLIST_FOREACH(entry, &mu->mu_head, t_obj_list) {
-            if (current->t_prio < entry->t_prio) {
-                break;
-            }
-            last = entry;
-        }
-    }
+    os_mutex_waiter_insert(mu, current);
 
-    if (last) {
-        SLIST_INSERT_AFTER(last, current, t_obj_list);
-    } else {
-        SLIST_INSERT_HEAD(&mu->mu_head, current, t_obj_list);
-    }
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    wait_start = os_cputime_get32();
+#endif
 
     /* Set mutex pointer in task */
     current->t_obj = mu;
@@ -221,6 +347,10 @@ os_mutex_pend(struct os_mutex *mu, os_time_t timeout)
     current->t_flags &= ~OS_TASK_FLAG_MUTEX_WAIT;
     OS_EXIT_CRITICAL(sr);
 
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    os_mutex_stats_waited(mu, wait_start);
+#endif
+
     /* If we are owner we did not time out. */
     if (mu->mu_owner == current) {
         ret = OS_OK;
@@ -233,3 +363,72 @@ done:
     return ret;
 }
 
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+int
+os_mutex_register(struct os_mutex *mu, const char *name)
+{
+    os_sr_t sr;
+
+    if (mu == NULL || name == NULL) {
+        return OS_INVALID_PARM;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    mu->mu_name = name;
+    if (!os_mutex_is_registered(mu)) {
+        STAILQ_INSERT_TAIL(&os_mutex_list, mu, mu_next);
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return 0;
+}
+
+void
+os_mutex_stats_clear(struct os_mutex *mu)
+{
+    uint32_t hold_start;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    hold_start = mu->mu_stats.oms_hold_start;
+    memset(&mu->mu_stats, 0, sizeof mu->mu_stats);
+    mu->mu_stats.oms_hold_start = hold_start;
+    OS_EXIT_CRITICAL(sr);
+}
+
+struct os_mutex *
+os_mutex_info_get_next(const struct os_mutex *prev, struct os_mutex_info *omi)
+{
+    struct os_mutex_stats stats;
+    struct os_mutex *cur;
+    struct os_task *owner;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (prev != NULL) {
+        cur = STAILQ_NEXT(prev, mu_next);
+    } else {
+        cur = STAILQ_FIRST(&os_mutex_list);
+    }
+    if (cur != NULL) {
+        stats = cur->mu_stats;
+        owner = cur->mu_level != 0 ? cur->mu_owner : NULL;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    if (cur == NULL) {
+        return NULL;
+    }
+
+    omi->omi_name = cur->mu_name;
+    omi->omi_owner = owner != NULL ? owner->t_name : NULL;
+    omi->omi_acquired = stats.oms_acquired;
+    omi->omi_contended = stats.oms_contended;
+    omi->omi_max_wait_us = os_cputime_ticks_to_usecs(stats.oms_max_wait);
+    omi->omi_max_hold_us = os_cputime_ticks_to_usecs(stats.oms_max_hold);
+    omi->omi_wait_total_us = stats.oms_wait_total * 1000000 /
+                             MYNEWT_VAL(OS_CPUTIME_FREQ);
+
+    return cur;
+}
+#endif
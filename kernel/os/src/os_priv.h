@@ -31,9 +31,29 @@ extern struct os_task g_idle_task;
 extern struct os_task_list g_os_run_list;
 extern struct os_task_list g_os_sleep_list;
 extern struct os_task_stailq g_os_task_list;
+#if !MYNEWT_VAL(OS_CALLOUT_WHEEL)
 extern struct os_callout_list g_callout_list;
+#endif
 
 void os_msys_init(void);
+#if MYNEWT_VAL(OS_MSYS_STATS)
+void os_msys_stats_init(void);
+#endif
+void os_callout_list_init(void);
+
+/*
+ * os_memblock_get_n() and os_memblock_put_n() without allocation trace
+ * records, for allocators that keep blocks cached and trace them as they
+ * hand them out and take them back.
+ */
+int os_memblock_get_n_untraced(struct os_mempool *mp, void **blocks, int n);
+os_error_t os_memblock_put_n_untraced(struct os_mempool *mp, void **blocks,
+                                      int n);
+
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+void os_malloc_cache_init(void);
+void os_malloc_cache_stats_init(void);
+#endif
 
 /**
  * Prints information about a crash to the console.  This functionality is
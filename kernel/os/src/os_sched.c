@@ -18,17 +18,344 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include "os/mynewt.h"
 #include "os_priv.h"
 
+#if MYNEWT_VAL(OS_SCHED_BITMAP)
+/*
+ * Ready queue is kept as one FIFO list per priority level, plus a two level
+ * bitmap of non-empty levels.  Lists are initialized lazily when their bit
+ * gets set, so an all-zero bitmap is a valid empty ready queue.
+ */
+#define OS_SCHED_PRIO_CNT       (OS_IDLE_PRIO + 1)
+#define OS_SCHED_PRIO_GRP_CNT   (OS_SCHED_PRIO_CNT / 32)
+
+static struct os_task_list os_sched_rdy_list[OS_SCHED_PRIO_CNT];
+static uint32_t os_sched_rdy_map[OS_SCHED_PRIO_GRP_CNT];
+static uint32_t os_sched_rdy_grp;
+#endif
+/*
+ * With OS_SCHED_BITMAP only the head of g_os_run_list is maintained: it
+ * points at the highest priority ready task, which is what the port context
+ * switch code loads.  The list links belong to the per-priority lists.
+ */
 struct os_task_list g_os_run_list = TAILQ_HEAD_INITIALIZER(g_os_run_list);
 struct os_task_list g_os_sleep_list = TAILQ_HEAD_INITIALIZER(g_os_sleep_list);
 
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+/*
+ * Tasks sleeping with a timeout are kept in a pairing heap keyed by
+ * t_next_wakeup; g_os_sleep_list then only holds tasks which sleep forever.
+ */
+static struct os_task *os_sched_sleep_heap;
+#endif
+
 struct os_task *g_current_task;
 
 extern os_time_t g_os_time;
 os_time_t g_os_last_ctx_sw_time;
 
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+/* os_cputime when time was last charged to the current task */
+static uint32_t os_sched_acct_last;
+/* os_cputime when the outermost interrupt was entered */
+static uint32_t os_sched_acct_isr_start;
+static uint8_t os_sched_acct_isr_nesting;
+#endif
+
+#if MYNEWT_VAL(OS_SCHED_BITMAP)
+
+static void
+os_sched_runq_update_head(void)
+{
+    int grp;
+    int prio;
+
+    if (!os_sched_rdy_grp) {
+        TAILQ_FIRST(&g_os_run_list) = NULL;
+        return;
+    }
+    grp = __builtin_ctz(os_sched_rdy_grp);
+    prio = (grp << 5) + __builtin_ctz(os_sched_rdy_map[grp]);
+
+    TAILQ_FIRST(&g_os_run_list) = TAILQ_FIRST(&os_sched_rdy_list[prio]);
+}
+
+static void
+os_sched_runq_insert(struct os_task *t)
+{
+    uint8_t prio;
+    uint8_t grp;
+    uint32_t bit;
+
+    prio = t->t_prio;
+    grp = prio >> 5;
+    bit = 1UL << (prio & 31);
+
+    if (!(os_sched_rdy_map[grp] & bit)) {
+        TAILQ_INIT(&os_sched_rdy_list[prio]);
+        os_sched_rdy_map[grp] |= bit;
+        os_sched_rdy_grp |= 1UL << grp;
+    }
+    TAILQ_INSERT_TAIL(&os_sched_rdy_list[prio], t, t_os_list);
+    t->t_rdy_prio = prio;
+    os_sched_runq_update_head();
+}
+
+static void
+os_sched_runq_remove(struct os_task *t)
+{
+    uint8_t prio;
+    uint8_t grp;
+
+    /* Task priority may have changed since insertion; see os_sched_resort() */
+    prio = t->t_rdy_prio;
+    TAILQ_REMOVE(&os_sched_rdy_list[prio], t, t_os_list);
+    if (TAILQ_EMPTY(&os_sched_rdy_list[prio])) {
+        grp = prio >> 5;
+        os_sched_rdy_map[grp] &= ~(1UL << (prio & 31));
+        if (!os_sched_rdy_map[grp]) {
+            os_sched_rdy_grp &= ~(1UL << grp);
+        }
+    }
+    os_sched_runq_update_head();
+}
+
+#else
+
+static void
+os_sched_runq_insert(struct os_task *t)
+{
+    struct os_task *entry;
+
+    TAILQ_FOREACH(entry, &g_os_run_list, t_os_list) {
+        if (t->t_prio < entry->t_prio) {
+            break;
+        }
+    }
+    if (entry) {
+        TAILQ_INSERT_BEFORE(entry, t, t_os_list);
+    } else {
+        TAILQ_INSERT_TAIL(&g_os_run_list, t, t_os_list);
+    }
+}
+
+static void
+os_sched_runq_remove(struct os_task *t)
+{
+    TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+}
+
+#endif
+
+static struct os_task *
+os_sched_runq_first(void)
+{
+    return TAILQ_FIRST(&g_os_run_list);
+}
+
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+
+/*
+ * Pairing heap of sleeping tasks.  Each node points to its first child and
+ * next sibling; t_heap_prev points to the left sibling, or to the parent for
+ * a first child.
+ */
+static struct os_task *
+os_sched_heap_meld(struct os_task *a, struct os_task *b)
+{
+    struct os_task *tmp;
+
+    if (a == NULL) {
+        return b;
+    }
+    if (b == NULL) {
+        return a;
+    }
+    if (OS_TIME_TICK_LT(b->t_next_wakeup, a->t_next_wakeup)) {
+        tmp = a;
+        a = b;
+        b = tmp;
+    }
+
+    b->t_heap_prev = a;
+    b->t_heap_next = a->t_heap_child;
+    if (b->t_heap_next) {
+        b->t_heap_next->t_heap_prev = b;
+    }
+    a->t_heap_child = b;
+    a->t_heap_next = NULL;
+    a->t_heap_prev = NULL;
+
+    return a;
+}
+
+/*
+ * Standard two-pass merge of a list of siblings, done iteratively to keep
+ * stack use bounded.
+ */
+static struct os_task *
+os_sched_heap_merge_pairs(struct os_task *first)
+{
+    struct os_task *pairs;
+    struct os_task *a;
+    struct os_task *b;
+    struct os_task *next;
+
+    /* Left to right, meld pairs and push results on a stack via t_heap_next */
+    pairs = NULL;
+    while (first) {
+        a = first;
+        b = a->t_heap_next;
+        next = b ? b->t_heap_next : NULL;
+        a->t_heap_next = NULL;
+        if (b) {
+            b->t_heap_next = NULL;
+        }
+        a = os_sched_heap_meld(a, b);
+        a->t_heap_next = pairs;
+        pairs = a;
+        first = next;
+    }
+
+    /* Right to left, meld everything into one tree */
+    a = NULL;
+    while (pairs) {
+        next = pairs->t_heap_next;
+        pairs->t_heap_next = NULL;
+        a = os_sched_heap_meld(a, pairs);
+        pairs = next;
+    }
+
+    return a;
+}
+
+static void
+os_sched_heap_insert(struct os_task *t)
+{
+    t->t_heap_child = NULL;
+    t->t_heap_next = NULL;
+    t->t_heap_prev = NULL;
+    os_sched_sleep_heap = os_sched_heap_meld(os_sched_sleep_heap, t);
+}
+
+static void
+os_sched_heap_remove(struct os_task *t)
+{
+    struct os_task *sub;
+
+    sub = os_sched_heap_merge_pairs(t->t_heap_child);
+    if (t == os_sched_sleep_heap) {
+        os_sched_sleep_heap = sub;
+    } else {
+        if (t->t_heap_prev->t_heap_child == t) {
+            t->t_heap_prev->t_heap_child = t->t_heap_next;
+        } else {
+            t->t_heap_prev->t_heap_next = t->t_heap_next;
+        }
+        if (t->t_heap_next) {
+            t->t_heap_next->t_heap_prev = t->t_heap_prev;
+        }
+        os_sched_sleep_heap = os_sched_heap_meld(os_sched_sleep_heap, sub);
+    }
+}
+
+static void
+os_sched_sleepq_insert(struct os_task *t)
+{
+    if (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT) {
+        TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
+    } else {
+        os_sched_heap_insert(t);
+    }
+}
+
+static void
+os_sched_sleepq_remove(struct os_task *t)
+{
+    if (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT) {
+        TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+    } else {
+        os_sched_heap_remove(t);
+    }
+}
+
+static struct os_task *
+os_sched_sleepq_first(void)
+{
+    return os_sched_sleep_heap;
+}
+
+#else
+
+static void
+os_sched_sleepq_insert(struct os_task *t)
+{
+    struct os_task *entry;
+
+    if (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT) {
+        TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
+        return;
+    }
+
+    TAILQ_FOREACH(entry, &g_os_sleep_list, t_os_list) {
+        if ((entry->t_flags & OS_TASK_FLAG_NO_TIMEOUT) ||
+                OS_TIME_TICK_GT(entry->t_next_wakeup, t->t_next_wakeup)) {
+            break;
+        }
+    }
+    if (entry) {
+        TAILQ_INSERT_BEFORE(entry, t, t_os_list);
+    } else {
+        TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
+    }
+}
+
+static void
+os_sched_sleepq_remove(struct os_task *t)
+{
+    TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+}
+
+/*
+ * Returns the sleeping task with the earliest wakeup time, or NULL if no
+ * task is sleeping with a timeout.
+ */
+static struct os_task *
+os_sched_sleepq_first(void)
+{
+    struct os_task *t;
+
+    t = TAILQ_FIRST(&g_os_sleep_list);
+    if (t != NULL && (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT)) {
+        t = NULL;
+    }
+    return t;
+}
+
+#endif
+
+/**
+ * os sched init
+ *
+ * Empties the run and sleep lists.  Only needed when the OS is
+ * re-initialized without a reset (e.g. in the sim environment).
+ */
+void
+os_sched_init(void)
+{
+#if MYNEWT_VAL(OS_SCHED_BITMAP)
+    memset(os_sched_rdy_map, 0, sizeof(os_sched_rdy_map));
+    os_sched_rdy_grp = 0;
+#endif
+    TAILQ_INIT(&g_os_run_list);
+    TAILQ_INIT(&g_os_sleep_list);
+#if MYNEWT_VAL(OS_SCHED_SLEEP_HEAP)
+    os_sched_sleep_heap = NULL;
+#endif
+}
+
 /**
  * os sched insert
  *
@@ -43,7 +370,6 @@ os_time_t g_os_last_ctx_sw_time;
 os_error_t
 os_sched_insert(struct os_task *t)
 {
-    struct os_task *entry;
     os_sr_t sr;
     os_error_t rc;
 
@@ -52,18 +378,8 @@ os_sched_insert(struct os_task *t)
         goto err;
     }
 
-    entry = NULL;
     OS_ENTER_CRITICAL(sr);
-    TAILQ_FOREACH(entry, &g_os_run_list, t_os_list) {
-        if (t->t_prio < entry->t_prio) {
-            break;
-        }
-    }
-    if (entry) {
-        TAILQ_INSERT_BEFORE(entry, (struct os_task *) t, t_os_list);
-    } else {
-        TAILQ_INSERT_TAIL(&g_os_run_list, (struct os_task *) t, t_os_list);
-    }
+    os_sched_runq_insert(t);
     OS_EXIT_CRITICAL(sr);
 
     return (0);
@@ -86,8 +402,66 @@ os_sched_ctx_sw_hook(struct os_task *next_t)
     next_t->t_ctx_sw_cnt++;
     g_current_task->t_run_time += g_os_time - g_os_last_ctx_sw_time;
     g_os_last_ctx_sw_time = g_os_time;
+
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    /*
+     * If switching from within an interrupt, the task was already charged
+     * when the interrupt was entered; the interrupt time is charged on exit.
+     */
+    if (!os_sched_acct_isr_nesting) {
+        uint32_t now;
+
+        now = os_cputime_get32();
+        g_current_task->t_run_cputime += now - os_sched_acct_last;
+        os_sched_acct_last = now;
+    }
+#endif
 }
 
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+void
+os_sched_isr_enter(void)
+{
+    uint32_t now;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    if (os_sched_acct_isr_nesting++ == 0) {
+        now = os_cputime_get32();
+        if (g_current_task) {
+            g_current_task->t_run_cputime += now - os_sched_acct_last;
+        }
+        os_sched_acct_isr_start = now;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+#if MYNEWT_VAL(OS_SYSVIEW)
+    SEGGER_SYSVIEW_RecordEnterISR();
+#endif
+}
+
+void
+os_sched_isr_exit(void)
+{
+    uint32_t now;
+    os_sr_t sr;
+
+#if MYNEWT_VAL(OS_SYSVIEW)
+    SEGGER_SYSVIEW_RecordExitISR();
+#endif
+
+    OS_ENTER_CRITICAL(sr);
+    if (--os_sched_acct_isr_nesting == 0) {
+        now = os_cputime_get32();
+        if (g_current_task) {
+            g_current_task->t_isr_cputime += now - os_sched_acct_isr_start;
+        }
+        os_sched_acct_last = now;
+    }
+    OS_EXIT_CRITICAL(sr);
+}
+#endif
+
 struct os_task *
 os_sched_get_current_task(void)
 {
@@ -141,29 +515,13 @@ os_sched(struct os_task *next_t)
 int
 os_sched_sleep(struct os_task *t, os_time_t nticks)
 {
-    struct os_task *entry;
-
-    entry = NULL;
-
-    TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+    os_sched_runq_remove(t);
     t->t_state = OS_TASK_SLEEP;
     t->t_next_wakeup = os_time_get() + nticks;
     if (nticks == OS_TIMEOUT_NEVER) {
         t->t_flags |= OS_TASK_FLAG_NO_TIMEOUT;
-        TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
-    } else {
-        TAILQ_FOREACH(entry, &g_os_sleep_list, t_os_list) {
-            if ((entry->t_flags & OS_TASK_FLAG_NO_TIMEOUT) ||
-                    OS_TIME_TICK_GT(entry->t_next_wakeup, t->t_next_wakeup)) {
-                break;
-            }
-        }
-        if (entry) {
-            TAILQ_INSERT_BEFORE(entry, t, t_os_list);
-        } else {
-            TAILQ_INSERT_TAIL(&g_os_sleep_list, t, t_os_list);
-        }
     }
+    os_sched_sleepq_insert(t);
 
     os_trace_task_stop_ready(t, OS_TASK_SLEEP);
     return (0);
@@ -187,9 +545,9 @@ os_sched_remove(struct os_task *t)
 {
 
     if (t->t_state == OS_TASK_SLEEP) {
-        TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
+        os_sched_sleepq_remove(t);
     } else if (t->t_state == OS_TASK_READY) {
-        TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+        os_sched_runq_remove(t);
     }
     t->t_next_wakeup = 0;
     t->t_flags |= OS_TASK_FLAG_NO_TIMEOUT;
@@ -229,10 +587,10 @@ os_sched_wakeup(struct os_task *t)
     }
 
     /* Remove task from sleep list */
+    os_sched_sleepq_remove(t);
     t->t_state = OS_TASK_READY;
     t->t_next_wakeup = 0;
     t->t_flags &= ~OS_TASK_FLAG_NO_TIMEOUT;
-    TAILQ_REMOVE(&g_os_sleep_list, t, t_os_list);
     os_sched_insert(t);
 
     os_trace_task_start_ready(t);
@@ -253,7 +611,6 @@ void
 os_sched_os_timer_exp(void)
 {
     struct os_task *t;
-    struct os_task *next;
     os_time_t now;
     os_sr_t sr;
 
@@ -264,19 +621,12 @@ os_sched_os_timer_exp(void)
     /*
      * Wakeup any tasks that have their sleep timer expired
      */
-    t = TAILQ_FIRST(&g_os_sleep_list);
-    while (t) {
-        /* If task waiting forever, do not check next wakeup time */
-        if (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT) {
-            break;
-        }
-        next = TAILQ_NEXT(t, t_os_list);
+    while ((t = os_sched_sleepq_first()) != NULL) {
         if (OS_TIME_TICK_GEQ(now, t->t_next_wakeup)) {
             os_sched_wakeup(t);
         } else {
             break;
         }
-        t = next;
     }
 
     OS_EXIT_CRITICAL(sr);
@@ -294,8 +644,8 @@ os_sched_wakeup_ticks(os_time_t now)
 
     OS_ASSERT_CRITICAL();
 
-    t = TAILQ_FIRST(&g_os_sleep_list);
-    if (t == NULL || (t->t_flags & OS_TASK_FLAG_NO_TIMEOUT)) {
+    t = os_sched_sleepq_first();
+    if (t == NULL) {
         rt = OS_TIMEOUT_NEVER;
     } else if (OS_TIME_TICK_GEQ(t->t_next_wakeup, now)) {
         rt = t->t_next_wakeup - now;
@@ -319,7 +669,7 @@ os_sched_wakeup_ticks(os_time_t now)
 struct os_task *
 os_sched_next_task(void)
 {
-    return (TAILQ_FIRST(&g_os_run_list));
+    return (os_sched_runq_first());
 }
 
 /**
@@ -339,7 +689,7 @@ void
 os_sched_resort(struct os_task *t)
 {
     if (t->t_state == OS_TASK_READY) {
-        TAILQ_REMOVE(&g_os_run_list, t, t_os_list);
+        os_sched_runq_remove(t);
         os_sched_insert(t);
     }
 }
@@ -50,6 +50,20 @@ os_task_next_id(void)
     return (rc);
 }
 
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+/*
+ * Converts accumulated os_cputime ticks to microseconds.  Whole seconds are
+ * split off first so the multiplication cannot overflow.
+ */
+static uint64_t
+os_task_cputime_to_usecs(uint64_t ticks)
+{
+    return (ticks / MYNEWT_VAL(OS_CPUTIME_FREQ)) * 1000000 +
+           (ticks % MYNEWT_VAL(OS_CPUTIME_FREQ)) * 1000000 /
+           MYNEWT_VAL(OS_CPUTIME_FREQ);
+}
+#endif
+
 uint8_t
 os_task_count(void)
 {
@@ -95,6 +109,9 @@ os_task_init(struct os_task *t, const char *name, os_task_func_t func,
     _clear_stack(stack_bottom, stack_size);
     t->t_stacktop = &stack_bottom[stack_size];
     t->t_stacksize = stack_size;
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+    t->t_stack_hwm = 0;
+#endif
     t->t_stackptr = os_arch_task_stack_init(t, t->t_stacktop,
             t->t_stacksize);
 
@@ -165,16 +182,70 @@ os_task_remove(struct os_task *t)
     OS_ENTER_CRITICAL(sr);
     rc = os_sched_remove(t);
     OS_EXIT_CRITICAL(sr);
+
+    /* The task will not run again; give its cached heap blocks back. */
+    if (rc == OS_OK) {
+        os_malloc_task_flush(t);
+    }
     return rc;
 }
 
 
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+uint16_t
+os_task_stack_usage(struct os_task *t, int full)
+{
+    os_stack_t *bottom;
+    os_stack_t *low;
+    os_stack_t *p;
+    int gap;
+
+    bottom = t->t_stacktop - t->t_stacksize;
+    low = t->t_stacktop - t->t_stack_hwm;
+
+    /* Everything above the watermark is known to be used; look below it. */
+    gap = 0;
+    for (p = low; p > bottom; p--) {
+        if (p[-1] != OS_STACK_PATTERN) {
+            low = p - 1;
+            gap = 0;
+        } else if (!full &&
+                   ++gap >= MYNEWT_VAL(OS_TASK_STACK_WATERMARK_GAP)) {
+            break;
+        }
+    }
+
+    t->t_stack_hwm = t->t_stacktop - low;
+    return t->t_stack_hwm;
+}
+
+uint16_t
+os_task_stack_recommend(uint16_t usage)
+{
+    uint32_t size;
+
+    size = usage + (usage * MYNEWT_VAL(OS_TASK_STACK_MARGIN) + 99) / 100;
+#if MYNEWT_VAL(OS_CTX_SW_STACK_CHECK)
+    size += MYNEWT_VAL(OS_CTX_SW_STACK_GUARD);
+#endif
+    /* Not OS_STACK_ALIGN(): sim scales stack sizes up with it. */
+    size = OS_ALIGN(size, 8);
+    if (size > UINT16_MAX) {
+        size = UINT16_MAX;
+    }
+
+    return size;
+}
+#endif
+
 struct os_task *
 os_task_info_get_next(const struct os_task *prev, struct os_task_info *oti)
 {
     struct os_task *next;
+#if !MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
     os_stack_t *top;
     os_stack_t *bottom;
+#endif
 
     if (prev != NULL) {
         next = STAILQ_NEXT(prev, t_os_task_list);
@@ -193,6 +264,9 @@ os_task_info_get_next(const struct os_task *prev, struct os_task_info *oti)
     oti->oti_taskid = next->t_taskid;
     oti->oti_state = next->t_state;
 
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+    oti->oti_stkusage = os_task_stack_usage(next, 0);
+#else
     top = next->t_stacktop;
     bottom = next->t_stacktop - next->t_stacksize;
     while (bottom < top) {
@@ -203,9 +277,14 @@ os_task_info_get_next(const struct os_task *prev, struct os_task_info *oti)
     }
 
     oti->oti_stkusage = (uint16_t) (next->t_stacktop - bottom);
+#endif
     oti->oti_stksize = next->t_stacksize;
     oti->oti_cswcnt = next->t_ctx_sw_cnt;
     oti->oti_runtime = next->t_run_time;
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    oti->oti_runtime_us = os_task_cputime_to_usecs(next->t_run_cputime);
+    oti->oti_isr_time_us = os_task_cputime_to_usecs(next->t_isr_cputime);
+#endif
     oti->oti_last_checkin = next->t_sanity_check.sc_checkin_last;
     oti->oti_next_checkin = next->t_sanity_check.sc_checkin_last +
         next->t_sanity_check.sc_checkin_itvl;
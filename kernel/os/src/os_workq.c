@@ -0,0 +1,296 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <string.h>
+#include "os/mynewt.h"
+
+/*
+ * Returns the worker of the pool that is running, or NULL if the caller is
+ * not one of the pool's workers.
+ */
+static struct os_workq_worker *
+os_workq_current(struct os_workq *wq)
+{
+    struct os_task *t;
+    int i;
+
+    t = os_sched_get_current_task();
+    for (i = 0; i < wq->owq_num_workers; i++) {
+        if (&wq->owq_workers[i].oww_task == t) {
+            return &wq->owq_workers[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Takes the next work item for a worker: the newest item on its own deque,
+ * or failing that the oldest item of the next worker that has any.
+ */
+static struct os_work *
+os_workq_take(struct os_workq *wq, struct os_workq_worker *self)
+{
+    struct os_workq_worker *victim;
+    struct os_work *work;
+    os_sr_t sr;
+    int idx;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+    work = TAILQ_LAST(&self->oww_deque, os_work_deque);
+    if (work != NULL) {
+        TAILQ_REMOVE(&self->oww_deque, work, ow_next);
+    } else {
+        idx = self - wq->owq_workers;
+        for (i = 1; i < wq->owq_num_workers; i++) {
+            victim = &wq->owq_workers[(idx + i) % wq->owq_num_workers];
+            work = TAILQ_FIRST(&victim->oww_deque);
+            if (work != NULL) {
+                TAILQ_REMOVE(&victim->oww_deque, work, ow_next);
+                self->oww_steals++;
+                break;
+            }
+        }
+    }
+    if (work != NULL) {
+        work->ow_flags &= ~OS_WORK_F_QUEUED;
+        work->ow_flags |= OS_WORK_F_RUNNING;
+        self->oww_runs++;
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return work;
+}
+
+/*
+ * Completion event callback; runs the work item's completion callback once
+ * for every run that finished since the event was last processed.
+ */
+static void
+os_work_done_event(struct os_event *ev)
+{
+    struct os_work *work;
+    os_sr_t sr;
+
+    work = ev->ev_arg;
+    while (1) {
+        OS_ENTER_CRITICAL(sr);
+        if (work->ow_done_pending == 0) {
+            OS_EXIT_CRITICAL(sr);
+            break;
+        }
+        work->ow_done_pending--;
+        OS_EXIT_CRITICAL(sr);
+
+        work->ow_done_cb(ev);
+    }
+}
+
+static void
+os_workq_worker_main(void *arg)
+{
+    struct os_workq_worker *self;
+    struct os_eventq *evq;
+    struct os_workq *wq;
+    struct os_work *work;
+    uint8_t requeue;
+    os_sr_t sr;
+
+    self = arg;
+    wq = self->oww_wq;
+
+    while (1) {
+        os_sem_pend(&wq->owq_sem, OS_TIMEOUT_NEVER);
+
+        /* Nothing to take if the item was cancelled. */
+        work = os_workq_take(wq, self);
+        if (work == NULL) {
+            continue;
+        }
+
+        work->ow_fn(work);
+
+        OS_ENTER_CRITICAL(sr);
+        work->ow_flags &= ~OS_WORK_F_RUNNING;
+        evq = work->ow_done_evq;
+        if (evq != NULL && work->ow_done_cb != NULL) {
+            work->ow_done_pending++;
+        }
+
+        /* Queue the run that was submitted while this one was going on. */
+        requeue = work->ow_flags & OS_WORK_F_REQUEUE;
+        if (requeue) {
+            work->ow_flags &= ~OS_WORK_F_REQUEUE;
+            work->ow_flags |= OS_WORK_F_QUEUED;
+            work->ow_done_evq = work->ow_requeue_evq;
+            TAILQ_INSERT_TAIL(&self->oww_deque, work, ow_next);
+        }
+        OS_EXIT_CRITICAL(sr);
+
+        /*
+         * The event may still be queued from an earlier run of a resubmitted
+         * item; the put is then a no-op and that delivery covers this one.
+         */
+        if (evq != NULL && work->ow_done_cb != NULL) {
+            os_eventq_put(evq, &work->ow_done_ev);
+        }
+        if (requeue) {
+            os_sem_release(&wq->owq_sem);
+        }
+    }
+}
+
+int
+os_workq_init(struct os_workq *wq, const char *name,
+              struct os_workq_worker *workers, int num_workers,
+              uint8_t prio, os_stack_t *stacks, uint16_t stack_size)
+{
+    struct os_workq_worker *w;
+    int rc;
+    int i;
+
+    if (wq == NULL || workers == NULL || stacks == NULL ||
+        num_workers <= 0 || prio + num_workers > OS_IDLE_PRIO) {
+        return OS_INVALID_PARM;
+    }
+
+    wq->owq_workers = workers;
+    wq->owq_num_workers = 0;
+    wq->owq_next = 0;
+    os_sem_init(&wq->owq_sem, 0);
+
+    for (i = 0; i < num_workers; i++) {
+        w = &workers[i];
+        w->oww_wq = wq;
+        TAILQ_INIT(&w->oww_deque);
+        w->oww_runs = 0;
+        w->oww_steals = 0;
+
+        /* Count the worker before it can run and look for victims. */
+        wq->owq_num_workers++;
+        rc = os_task_init(&w->oww_task, name, os_workq_worker_main, w,
+                          prio + i, OS_WAIT_FOREVER, stacks + i * stack_size,
+                          stack_size);
+        if (rc != 0) {
+            wq->owq_num_workers--;
+            return rc;
+        }
+    }
+
+    return 0;
+}
+
+void
+os_work_init(struct os_work *work, os_work_fn *fn, os_event_fn *done_cb,
+             void *arg)
+{
+    memset(work, 0, sizeof *work);
+    work->ow_fn = fn;
+    work->ow_arg = arg;
+    work->ow_done_cb = done_cb;
+    work->ow_done_ev.ev_cb = os_work_done_event;
+    work->ow_done_ev.ev_arg = work;
+}
+
+int
+os_workq_submit(struct os_workq *wq, struct os_work *work,
+                struct os_eventq *done_evq)
+{
+    struct os_workq_worker *w;
+    os_sr_t sr;
+
+    if (wq == NULL || work == NULL || work->ow_fn == NULL ||
+        wq->owq_num_workers == 0) {
+        return OS_INVALID_PARM;
+    }
+
+    w = os_workq_current(wq);
+
+    OS_ENTER_CRITICAL(sr);
+    if (work->ow_flags & (OS_WORK_F_QUEUED | OS_WORK_F_REQUEUE)) {
+        OS_EXIT_CRITICAL(sr);
+        return OS_EBUSY;
+    }
+
+    /*
+     * Items are not reentrant: an item submitted while it runs is queued
+     * again by its worker once the current run returns.
+     */
+    if (work->ow_flags & OS_WORK_F_RUNNING) {
+        work->ow_flags |= OS_WORK_F_REQUEUE;
+        work->ow_requeue_evq = done_evq;
+        OS_EXIT_CRITICAL(sr);
+        return 0;
+    }
+
+    if (w == NULL) {
+        w = &wq->owq_workers[wq->owq_next];
+        wq->owq_next = (wq->owq_next + 1) % wq->owq_num_workers;
+    }
+    work->ow_flags |= OS_WORK_F_QUEUED;
+    work->ow_done_evq = done_evq;
+    TAILQ_INSERT_TAIL(&w->oww_deque, work, ow_next);
+    OS_EXIT_CRITICAL(sr);
+
+    os_sem_release(&wq->owq_sem);
+
+    return 0;
+}
+
+int
+os_work_cancel(struct os_workq *wq, struct os_work *work)
+{
+    struct os_workq_worker *w;
+    struct os_work *cur;
+    os_sr_t sr;
+    int i;
+
+    OS_ENTER_CRITICAL(sr);
+    if (work->ow_flags & OS_WORK_F_REQUEUE) {
+        /* Drop the resubmission; the current run carries on. */
+        work->ow_flags &= ~OS_WORK_F_REQUEUE;
+        OS_EXIT_CRITICAL(sr);
+        return 0;
+    }
+
+    if (!(work->ow_flags & OS_WORK_F_QUEUED)) {
+        OS_EXIT_CRITICAL(sr);
+        return (work->ow_flags & OS_WORK_F_RUNNING) ? OS_EBUSY : OS_ENOENT;
+    }
+
+    for (i = 0; i < wq->owq_num_workers; i++) {
+        w = &wq->owq_workers[i];
+        TAILQ_FOREACH(cur, &w->oww_deque, ow_next) {
+            if (cur == work) {
+                TAILQ_REMOVE(&w->oww_deque, work, ow_next);
+                work->ow_flags &= ~OS_WORK_F_QUEUED;
+                OS_EXIT_CRITICAL(sr);
+
+                /*
+                 * The semaphore keeps the token; the worker it wakes finds
+                 * nothing to take and goes back to waiting.
+                 */
+                return 0;
+            }
+        }
+    }
+    OS_EXIT_CRITICAL(sr);
+
+    return OS_ENOENT;
+}
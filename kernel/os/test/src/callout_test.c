@@ -59,6 +59,9 @@ os_stack_t callout_task_stack_listen[CALLOUT_STACK_SIZE];
 
 struct os_callout callout_speak;
 
+/* Declaring variables for callout stress test */
+struct os_callout callout_stress_c[CALLOUT_STRESS_MAX];
+
 /* Global variables to be used by the callout functions */
 int p;
 int q;
@@ -228,10 +231,12 @@ callout_task_stop_listen(void *arg)
 TEST_CASE_DECL(callout_test_speak)
 TEST_CASE_DECL(callout_test_stop)
 TEST_CASE_DECL(callout_test)
+TEST_CASE_DECL(callout_test_stress)
 
 TEST_SUITE(os_callout_test_suite)
 {
     callout_test();
     callout_test_stop();
     callout_test_speak();
+    callout_test_stress();
 }
@@ -73,6 +73,11 @@ extern os_stack_t callout_task_stack_listen[CALLOUT_STACK_SIZE];
 extern struct os_callout callout_speak;
 extern struct os_callout callout_test_c;
 
+/* Declaring variables for callout stress test */
+#define CALLOUT_STRESS_MAX              (1000)
+#define CALLOUT_STRESS_BASE_TICKS       (10 * OS_TICKS_PER_SEC)
+extern struct os_callout callout_stress_c[CALLOUT_STRESS_MAX];
+
 /* Global variables to be used by the callout functions */
 extern int p;
 extern int q;
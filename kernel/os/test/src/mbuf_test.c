@@ -102,6 +102,12 @@ TEST_CASE_DECL(os_mbuf_test_extend)
 TEST_CASE_DECL(os_mbuf_test_adj)
 TEST_CASE_DECL(os_mbuf_test_get_pkthdr)
 TEST_CASE_DECL(os_mbuf_test_widen)
+TEST_CASE_DECL(os_mbuf_test_msys)
+TEST_CASE_DECL(os_mbuf_test_iovec)
+TEST_CASE_DECL(os_mbuf_test_usrhdr)
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+TEST_CASE_DECL(os_mbuf_test_clone)
+#endif
 
 TEST_SUITE(os_mbuf_test_suite)
 {
@@ -113,4 +119,10 @@ TEST_SUITE(os_mbuf_test_suite)
     os_mbuf_test_adj();
     os_mbuf_test_get_pkthdr();
     os_mbuf_test_widen();
+    os_mbuf_test_msys();
+    os_mbuf_test_iovec();
+    os_mbuf_test_usrhdr();
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+    os_mbuf_test_clone();
+#endif
 }
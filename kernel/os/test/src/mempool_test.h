@@ -43,6 +43,13 @@ extern "C" {
 #define NUM_MEM_BLOCKS  (10)
 #endif
 
+/* Pool size for the batch get/put test */
+#define MEMPOOL_TEST_BATCH_BLOCKS   (64)
+
+/* Helper task for the os_malloc() task cache test; runs before the test task */
+#define MEMPOOL_TEST_CACHE_TASK_PRIO    (MYNEWT_VAL(OS_MAIN_TASK_PRIO) - 1)
+#define MEMPOOL_TEST_CACHE_STACK_SIZE   (1024)
+
 extern int alignment;
 
 /* Test memory pool structure */
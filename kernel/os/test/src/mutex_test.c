@@ -309,10 +309,12 @@ mutex_task4_handler(void *arg)
 TEST_CASE_DECL(os_mutex_test_basic)
 TEST_CASE_DECL(os_mutex_test_case_1)
 TEST_CASE_DECL(os_mutex_test_case_2)
+TEST_CASE_DECL(os_mutex_test_chain)
 
 TEST_SUITE(os_mutex_test_suite)
 {
     os_mutex_test_basic();
     os_mutex_test_case_1();
     os_mutex_test_case_2();
+    os_mutex_test_chain();
 }
@@ -70,6 +70,8 @@ os_test_all(void)
     os_mbuf_test_suite();
     os_eventq_test_suite();
     os_callout_test_suite();
+    os_sched_test_suite();
+    os_workq_test_suite();
 
     return tu_case_failed;
 }
@@ -30,7 +30,9 @@
 #include "mbuf_test.h"
 #include "mempool_test.h"
 #include "mutex_test.h"
+#include "sched_test.h"
 #include "sem_test.h"
+#include "workq_test.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -53,6 +55,8 @@ int os_mbuf_test_suite(void);
 int os_sem_test_suite(void);
 int os_eventq_test_suite(void);
 int os_callout_test_suite(void);
+int os_sched_test_suite(void);
+int os_workq_test_suite(void);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "os_test_priv.h"
+
+struct os_task sched_test_tasks[SCHED_TEST_MAX_TASKS];
+os_stack_t sched_test_stacks[SCHED_TEST_MAX_TASKS][SCHED_TEST_STACK_SIZE];
+
+void
+sched_test_filler_handler(void *arg)
+{
+    while (1) {
+        os_time_delay(OS_TICKS_PER_SEC);
+    }
+}
+
+TEST_CASE_DECL(os_sched_test_run_list)
+TEST_CASE_DECL(os_sched_test_sleep_order)
+TEST_CASE_DECL(os_sched_test_stack_watermark)
+TEST_CASE_DECL(os_sched_test_virtual_time)
+
+TEST_SUITE(os_sched_test_suite)
+{
+    os_sched_test_run_list();
+    os_sched_test_sleep_order();
+    os_sched_test_stack_watermark();
+    os_sched_test_virtual_time();
+}
@@ -0,0 +1,51 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _SCHED_TEST_H
+#define _SCHED_TEST_H
+
+#include <stdio.h>
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "os_test_priv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of extra tasks the scheduler tests make ready or put to sleep */
+#define SCHED_TEST_MAX_TASKS    (64)
+#define SCHED_TEST_STACK_SIZE   (OS_STACK_ALIGN(64))
+
+/* Filler tasks put to sleep by the tests stay asleep at least this long */
+#define SCHED_TEST_SLEEP_TICKS  (60 * OS_TICKS_PER_SEC)
+
+/* Filler tasks sit below the test task; they never get to run. */
+#define SCHED_TEST_TASK_PRIO    (MYNEWT_VAL(OS_MAIN_TASK_PRIO) + 2)
+
+extern struct os_task sched_test_tasks[SCHED_TEST_MAX_TASKS];
+extern os_stack_t
+    sched_test_stacks[SCHED_TEST_MAX_TASKS][SCHED_TEST_STACK_SIZE];
+
+void sched_test_filler_handler(void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SCHED_TEST_H */
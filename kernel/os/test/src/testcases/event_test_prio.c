@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+/**
+ * Tests that events are pulled highest priority first and in FIFO order
+ * within a priority level.
+ */
+TEST_CASE(event_test_prio)
+{
+    struct os_event ev[OS_EVENTQ_PRIO_LEVELS * 2];
+    struct os_event *evp;
+    struct os_eventq evq;
+    int prio;
+    int i;
+
+    os_eventq_init(&evq);
+    memset(ev, 0, sizeof ev);
+
+    /* Queue two events per level, lowest priority first. */
+    for (i = 0; i < OS_EVENTQ_PRIO_LEVELS * 2; i++) {
+        prio = OS_EVENTQ_PRIO_DFLT - i / 2;
+        ev[i].ev_arg = (void *)(intptr_t)prio;
+        os_eventq_put_prio(&evq, &ev[i], prio);
+    }
+
+    /* An already queued event keeps its position. */
+    os_eventq_put_prio(&evq, &ev[0], OS_EVENTQ_PRIO_HIGHEST);
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    TEST_ASSERT(evq.evq_stats.oes_depth == OS_EVENTQ_PRIO_LEVELS * 2);
+    TEST_ASSERT(evq.evq_stats.oes_max_depth == OS_EVENTQ_PRIO_LEVELS * 2);
+#endif
+
+    /* Drop the second event of the highest level. */
+    os_eventq_remove(&evq, &ev[OS_EVENTQ_PRIO_LEVELS * 2 - 1]);
+    TEST_ASSERT(!OS_EVENT_QUEUED(&ev[OS_EVENTQ_PRIO_LEVELS * 2 - 1]));
+
+    evp = os_eventq_get_no_wait(&evq);
+    TEST_ASSERT(evp == &ev[OS_EVENTQ_PRIO_LEVELS * 2 - 2]);
+
+    for (prio = OS_EVENTQ_PRIO_HIGHEST + 1; prio <= OS_EVENTQ_PRIO_DFLT;
+         prio++) {
+        i = (OS_EVENTQ_PRIO_DFLT - prio) * 2;
+        evp = os_eventq_get_no_wait(&evq);
+        TEST_ASSERT(evp == &ev[i]);
+        evp = os_eventq_get_no_wait(&evq);
+        TEST_ASSERT(evp == &ev[i + 1]);
+        TEST_ASSERT(!OS_EVENT_QUEUED(evp));
+    }
+
+    TEST_ASSERT(os_eventq_get_no_wait(&evq) == NULL);
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    TEST_ASSERT(evq.evq_stats.oes_depth == 0);
+    os_eventq_stats_clear(&evq);
+    TEST_ASSERT(evq.evq_stats.oes_max_depth == 0);
+#endif
+}
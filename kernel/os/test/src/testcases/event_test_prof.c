@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+
+/* Time the slow callback runs for, and the times its events wait queued */
+#define PROF_TEST_RUN_TICKS     (3)
+#define PROF_TEST_WAIT_TICKS_1  (2)
+#define PROF_TEST_WAIT_TICKS_2  (5)
+#define PROF_TEST_QUICK_RUNS    (4)
+
+#define PROF_TEST_US(ticks)     ((ticks) * (1000000 / OS_TICKS_PER_SEC))
+
+static struct os_eventq prof_test_evq;
+static struct os_event prof_test_quick_ev;
+static struct os_event prof_test_slow_ev;
+
+static void
+prof_test_quick_cb(struct os_event *ev)
+{
+}
+
+static void
+prof_test_slow_cb(struct os_event *ev)
+{
+    os_time_delay(PROF_TEST_RUN_TICKS);
+}
+
+static void
+prof_test_run(struct os_event *ev, os_time_t wait)
+{
+    os_eventq_put(&prof_test_evq, ev);
+    if (wait != 0) {
+        os_time_delay(wait);
+    }
+    os_eventq_run(&prof_test_evq);
+}
+#endif
+
+/**
+ * Runs events through known callbacks and checks the profile recorded for
+ * each.  In virtual time every delay takes exactly the ticks asked for, so
+ * the recorded times are exact.
+ */
+TEST_CASE_TASK(event_test_prof)
+{
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+    struct os_eventq_prof_info info;
+    int found;
+    int i;
+
+#if MYNEWT_VAL(BSP_SIMULATED)
+    /* The native BSP leaves cputime unconfigured. */
+    os_cputime_init(MYNEWT_VAL(OS_CPUTIME_FREQ));
+#endif
+
+    os_eventq_init(&prof_test_evq);
+    memset(&prof_test_quick_ev, 0, sizeof prof_test_quick_ev);
+    prof_test_quick_ev.ev_cb = prof_test_quick_cb;
+    memset(&prof_test_slow_ev, 0, sizeof prof_test_slow_ev);
+    prof_test_slow_ev.ev_cb = prof_test_slow_cb;
+
+    os_eventq_prof_clear();
+
+    for (i = 0; i < PROF_TEST_QUICK_RUNS; i++) {
+        prof_test_run(&prof_test_quick_ev, 0);
+    }
+    prof_test_run(&prof_test_slow_ev, PROF_TEST_WAIT_TICKS_1);
+    prof_test_run(&prof_test_slow_ev, PROF_TEST_WAIT_TICKS_2);
+
+    /* Other tasks may have run callbacks of their own meanwhile. */
+    found = 0;
+    i = -1;
+    while ((i = os_eventq_prof_info_get_next(i, &info)) >= 0) {
+        if (info.oepi_cb == prof_test_quick_cb) {
+            TEST_ASSERT(info.oepi_count == PROF_TEST_QUICK_RUNS);
+            TEST_ASSERT(info.oepi_run_total_us == 0);
+            TEST_ASSERT(info.oepi_run_max_us == 0);
+            TEST_ASSERT(info.oepi_wait_total_us == 0);
+            TEST_ASSERT(info.oepi_wait_max_us == 0);
+            found++;
+        } else if (info.oepi_cb == prof_test_slow_cb) {
+            TEST_ASSERT(info.oepi_count == 2);
+            TEST_ASSERT(info.oepi_run_total_us ==
+                        PROF_TEST_US(2 * PROF_TEST_RUN_TICKS));
+            TEST_ASSERT(info.oepi_run_max_us ==
+                        PROF_TEST_US(PROF_TEST_RUN_TICKS));
+            TEST_ASSERT(info.oepi_wait_total_us ==
+                        PROF_TEST_US(PROF_TEST_WAIT_TICKS_1 +
+                                     PROF_TEST_WAIT_TICKS_2));
+            TEST_ASSERT(info.oepi_wait_max_us ==
+                        PROF_TEST_US(PROF_TEST_WAIT_TICKS_2));
+            found++;
+        }
+    }
+    TEST_ASSERT(found == 2);
+    TEST_ASSERT(os_eventq_prof_overflow() == 0);
+
+    /*** Clearing empties the table. */
+    os_eventq_prof_clear();
+    TEST_ASSERT(os_eventq_prof_info_get_next(-1, &info) == -1);
+    TEST_ASSERT(os_eventq_prof_overflow() == 0);
+#endif
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+/*
+ * Arms 'num' callouts with spread out expiry times, then re-arms each one.
+ * Checks that the next expiry reported for tickless idle is correct, and
+ * that stopping everything leaves no callout pending.
+ */
+static void
+callout_test_stress_run(int num)
+{
+    os_time_t min_ticks;
+    os_time_t ticks;
+    os_time_t now;
+    os_sr_t sr;
+    int rc;
+    int i;
+
+    for (i = 0; i < num; i++) {
+        os_callout_init(&callout_stress_c[i], &callout_evq, my_callout, NULL);
+        rc = os_callout_reset(&callout_stress_c[i],
+                              CALLOUT_STRESS_BASE_TICKS + (i * 37) % 1000);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+
+    min_ticks = OS_TIMEOUT_NEVER;
+    for (i = 0; i < num; i++) {
+        ticks = CALLOUT_STRESS_BASE_TICKS + (i * 53) % 1000;
+
+        rc = os_callout_reset(&callout_stress_c[i], ticks);
+        TEST_ASSERT_FATAL(rc == 0);
+
+        now = os_time_get();
+        ticks = os_callout_remaining_ticks(&callout_stress_c[i], now);
+        if (ticks < min_ticks) {
+            min_ticks = ticks;
+        }
+    }
+
+    /* Ticks may have passed while re-arming; allow for that. */
+    OS_ENTER_CRITICAL(sr);
+    now = os_time_get();
+    ticks = os_callout_wakeup_ticks(now);
+    OS_EXIT_CRITICAL(sr);
+    TEST_ASSERT(ticks <= min_ticks);
+    TEST_ASSERT(ticks + CALLOUT_STRESS_BASE_TICKS / 2 > min_ticks);
+
+    for (i = 0; i < num; i++) {
+        os_callout_stop(&callout_stress_c[i]);
+        TEST_ASSERT(!os_callout_queued(&callout_stress_c[i]));
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    now = os_time_get();
+    ticks = os_callout_wakeup_ticks(now);
+    OS_EXIT_CRITICAL(sr);
+    TEST_ASSERT(ticks == OS_TIMEOUT_NEVER);
+}
+
+TEST_CASE_TASK(callout_test_stress)
+{
+    struct os_event *ev;
+    os_time_t fired;
+
+    os_eventq_init(&callout_evq);
+
+    callout_test_stress_run(10);
+    callout_test_stress_run(100);
+    callout_test_stress_run(CALLOUT_STRESS_MAX);
+
+    /*
+     * Two callouts which are a couple hundred ticks apart must still fire in
+     * order and on time.
+     */
+    os_callout_init(&callout_stress_c[0], &callout_evq, my_callout, NULL);
+    os_callout_init(&callout_stress_c[1], &callout_evq, my_callout, NULL);
+    os_callout_reset(&callout_stress_c[1], 257);
+    os_callout_reset(&callout_stress_c[0], 1);
+    fired = os_time_get();
+
+    ev = os_eventq_get(&callout_evq);
+    TEST_ASSERT(ev == &callout_stress_c[0].c_ev);
+    TEST_ASSERT(os_callout_queued(&callout_stress_c[1]));
+
+    ev = os_eventq_get(&callout_evq);
+    TEST_ASSERT(ev == &callout_stress_c[1].c_ev);
+    TEST_ASSERT(OS_TIME_TICK_GEQ(os_time_get(), fired + 257));
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+
+#define MBUF_TEST_CLONE_LEN     (300)
+
+TEST_CASE(os_mbuf_test_clone)
+{
+    uint8_t zeros[20] = { 0 };
+    struct os_mbuf *om;
+    struct os_mbuf *c1;
+    struct os_mbuf *c2;
+    int used;
+    int rc;
+
+    os_mbuf_test_setup();
+
+    om = os_mbuf_get_pkthdr(&os_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(om != NULL);
+    rc = os_mbuf_append(om, os_mbuf_test_data, MBUF_TEST_CLONE_LEN);
+    TEST_ASSERT_FATAL(rc == 0);
+    used = MBUF_TEST_POOL_BUF_COUNT - os_mbuf_mempool.mp_num_free;
+
+    /*** Clone; data is shared, not copied. */
+    c1 = os_mbuf_clone(NULL, om);
+    TEST_ASSERT_FATAL(c1 != NULL);
+    TEST_ASSERT(OS_MBUF_PKTLEN(c1) == MBUF_TEST_CLONE_LEN);
+    TEST_ASSERT(c1->om_data == om->om_data);
+    TEST_ASSERT(os_mbuf_cmpf(c1, 0, os_mbuf_test_data,
+                             MBUF_TEST_CLONE_LEN) == 0);
+    TEST_ASSERT(OS_MBUF_IS_SHARED(om));
+    TEST_ASSERT(OS_MBUF_IS_SHARED(c1));
+    TEST_ASSERT(OS_MBUF_LEADINGSPACE(c1) == 0);
+    TEST_ASSERT(OS_MBUF_TRAILINGSPACE(om) == 0);
+
+    /* A clone of a clone refers to the original buffers. */
+    c2 = os_mbuf_clone(NULL, c1);
+    TEST_ASSERT_FATAL(c2 != NULL);
+    TEST_ASSERT(c2->om_shared == om);
+    TEST_ASSERT(om->om_refcnt == 3);
+
+    /*** The data outlives the original chain. */
+    rc = os_mbuf_free_chain(om);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(os_mbuf_cmpf(c1, 0, os_mbuf_test_data,
+                             MBUF_TEST_CLONE_LEN) == 0);
+    TEST_ASSERT(MBUF_TEST_POOL_BUF_COUNT - os_mbuf_mempool.mp_num_free ==
+                3 * used);
+
+    /*** Appending to a clone does not touch the shared buffers. */
+    rc = os_mbuf_append(c1, os_mbuf_test_data + MBUF_TEST_CLONE_LEN, 10);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(os_mbuf_cmpf(c1, 0, os_mbuf_test_data,
+                             MBUF_TEST_CLONE_LEN + 10) == 0);
+    TEST_ASSERT(OS_MBUF_PKTLEN(c2) == MBUF_TEST_CLONE_LEN);
+
+    /*** Copy on write. */
+    rc = os_mbuf_copyinto(c1, 5, zeros, sizeof zeros);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(os_mbuf_cmpf(c1, 5, zeros, sizeof zeros) == 0);
+    TEST_ASSERT(os_mbuf_cmpf(c2, 0, os_mbuf_test_data,
+                             MBUF_TEST_CLONE_LEN) == 0);
+
+    /*** Prepend, trim and pull up a clone. */
+    c2 = os_mbuf_prepend(c2, 8);
+    TEST_ASSERT_FATAL(c2 != NULL);
+    TEST_ASSERT(OS_MBUF_PKTLEN(c2) == MBUF_TEST_CLONE_LEN + 8);
+    os_mbuf_adj(c2, 8);
+    os_mbuf_adj(c2, -50);
+    TEST_ASSERT(OS_MBUF_PKTLEN(c2) == MBUF_TEST_CLONE_LEN - 50);
+    c2 = os_mbuf_pullup(c2, 60);
+    TEST_ASSERT_FATAL(c2 != NULL);
+    TEST_ASSERT(c2->om_len >= 60);
+    TEST_ASSERT(os_mbuf_cmpf(c2, 0, os_mbuf_test_data,
+                             MBUF_TEST_CLONE_LEN - 50) == 0);
+
+    rc = os_mbuf_unshare(c2);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(!OS_MBUF_IS_SHARED(c2));
+    TEST_ASSERT(os_mbuf_cmpf(c2, 0, os_mbuf_test_data,
+                             MBUF_TEST_CLONE_LEN - 50) == 0);
+    TEST_ASSERT(os_mbuf_cmpf(c1, 25, os_mbuf_test_data + 25,
+                             MBUF_TEST_CLONE_LEN - 15) == 0);
+
+    /*** Buffers go back to the pool with the last reference. */
+    os_mbuf_free_chain(c2);
+    os_mbuf_free_chain(c1);
+    TEST_ASSERT(os_mbuf_mempool.mp_num_free == MBUF_TEST_POOL_BUF_COUNT);
+}
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define MBUF_TEST_IOVEC_LEN     (1000)
+
+static uint8_t os_mbuf_test_iovec_flat[MBUF_TEST_IOVEC_LEN];
+
+static uint32_t
+os_mbuf_test_iovec_sum(const uint8_t *data, int len)
+{
+    uint32_t sum;
+    int i;
+
+    sum = 0;
+    for (i = 0; i < len; i++) {
+        sum += data[i];
+    }
+
+    return sum;
+}
+
+/*
+ * Checks the mbuf iterator and the vectored append / copy calls, then
+ * checks that summing a packet in place through the iterator sees the same
+ * bytes as summing a flat os_mbuf_copydata() copy.
+ */
+TEST_CASE(os_mbuf_test_iovec)
+{
+    struct os_mbuf_iovec iov[3];
+    struct os_mbuf_iovec seg;
+    struct os_mbuf_iter it;
+    struct os_mbuf *om;
+    uint32_t copy_sum;
+    uint32_t iter_sum;
+    int total;
+    int nsegs;
+    int rc;
+
+    os_mbuf_test_setup();
+
+    om = os_mbuf_get_pkthdr(&os_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(om != NULL);
+
+    /*** Vectored append. */
+    iov[0].omi_base = os_mbuf_test_data;
+    iov[0].omi_len = 100;
+    iov[1].omi_base = os_mbuf_test_data + 100;
+    iov[1].omi_len = 500;
+    iov[2].omi_base = os_mbuf_test_data + 600;
+    iov[2].omi_len = MBUF_TEST_IOVEC_LEN - 600;
+    rc = os_mbuf_appendv(om, iov, 3);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(OS_MBUF_PKTLEN(om) == MBUF_TEST_IOVEC_LEN);
+    TEST_ASSERT(os_mbuf_cmpf(om, 0, os_mbuf_test_data,
+                             MBUF_TEST_IOVEC_LEN) == 0);
+
+    /*** Iterate over a range spanning several mbufs. */
+    rc = os_mbuf_iter_init(&it, om, 50, 700);
+    TEST_ASSERT_FATAL(rc == 0);
+    total = 0;
+    nsegs = 0;
+    while (os_mbuf_iter_next(&it, &seg)) {
+        TEST_ASSERT(memcmp(seg.omi_base, os_mbuf_test_data + 50 + total,
+                           seg.omi_len) == 0);
+        total += seg.omi_len;
+        nsegs++;
+    }
+    TEST_ASSERT(total == 700);
+    TEST_ASSERT(nsegs > 1);
+
+    /*** Range past the end of the chain is truncated. */
+    rc = os_mbuf_iter_init(&it, om, MBUF_TEST_IOVEC_LEN - 10, 100);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(os_mbuf_iter_next(&it, &seg) == 1);
+    TEST_ASSERT(seg.omi_len == 10);
+    TEST_ASSERT(os_mbuf_iter_next(&it, &seg) == 0);
+
+    rc = os_mbuf_iter_init(&it, om, MBUF_TEST_IOVEC_LEN, 1);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(os_mbuf_iter_next(&it, &seg) == 0);
+
+    rc = os_mbuf_iter_init(&it, om, MBUF_TEST_IOVEC_LEN + 1, 1);
+    TEST_ASSERT(rc == OS_EINVAL);
+
+    /*** Vectored copy, overwriting the tail and extending the chain. */
+    iov[0].omi_base = os_mbuf_test_data + 900;
+    iov[0].omi_len = 100;
+    iov[1].omi_base = os_mbuf_test_data + 1000;
+    iov[1].omi_len = MBUF_TEST_DATA_LEN - 1000;
+    rc = os_mbuf_copyinto_v(om, 900, iov, 2);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(OS_MBUF_PKTLEN(om) == MBUF_TEST_DATA_LEN);
+    TEST_ASSERT(os_mbuf_cmpf(om, 0, os_mbuf_test_data,
+                             MBUF_TEST_DATA_LEN) == 0);
+
+    /*** Flat copy versus in place iteration. */
+    rc = os_mbuf_copydata(om, 0, MBUF_TEST_IOVEC_LEN,
+                          os_mbuf_test_iovec_flat);
+    TEST_ASSERT_FATAL(rc == 0);
+    copy_sum = os_mbuf_test_iovec_sum(os_mbuf_test_iovec_flat,
+                                      MBUF_TEST_IOVEC_LEN);
+
+    iter_sum = 0;
+    nsegs = 0;
+    rc = os_mbuf_iter_init(&it, om, 0, MBUF_TEST_IOVEC_LEN);
+    TEST_ASSERT_FATAL(rc == 0);
+    while (os_mbuf_iter_next(&it, &seg)) {
+        iter_sum += os_mbuf_test_iovec_sum(seg.omi_base, seg.omi_len);
+        nsegs++;
+    }
+    TEST_ASSERT(nsegs > 1);
+    TEST_ASSERT(copy_sum == iter_sum);
+
+    os_mbuf_free_chain(om);
+}
@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define MSYS_TEST_SMALL_SIZE    (64)
+#define MSYS_TEST_SMALL_COUNT   (2)
+
+static os_membuf_t msys_test_small_buf[
+    OS_MEMPOOL_SIZE(MSYS_TEST_SMALL_COUNT, MSYS_TEST_SMALL_SIZE)];
+static struct os_mempool msys_test_small_mempool;
+static struct os_mbuf_pool msys_test_small_pool;
+
+TEST_CASE(os_mbuf_test_msys)
+{
+    struct os_mbuf *small[MSYS_TEST_SMALL_COUNT];
+    struct os_mbuf *m;
+    int rc;
+    int i;
+
+    os_mbuf_test_setup();
+
+    rc = os_mempool_init(&msys_test_small_mempool, MSYS_TEST_SMALL_COUNT,
+                         MSYS_TEST_SMALL_SIZE, msys_test_small_buf,
+                         "msys_test_small");
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_mbuf_pool_init(&msys_test_small_pool, &msys_test_small_mempool,
+                           MSYS_TEST_SMALL_SIZE, MSYS_TEST_SMALL_COUNT);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    os_msys_reset();
+    rc = os_msys_register(&msys_test_small_pool);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_msys_register(&os_mbuf_pool);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /*** Best fit. */
+    for (i = 0; i < MSYS_TEST_SMALL_COUNT; i++) {
+        small[i] = os_msys_get(16, 0);
+        TEST_ASSERT_FATAL(small[i] != NULL);
+        TEST_ASSERT(small[i]->om_omp == &msys_test_small_pool);
+    }
+
+    m = os_msys_get(MSYS_TEST_SMALL_SIZE * 2, 0);
+    TEST_ASSERT_FATAL(m != NULL);
+    TEST_ASSERT(m->om_omp == &os_mbuf_pool);
+    os_mbuf_free_chain(m);
+
+    /*** Larger than any pool; the largest one is used. */
+    m = os_msys_get(MBUF_TEST_POOL_BUF_SIZE * 2, 0);
+    TEST_ASSERT_FATAL(m != NULL);
+    TEST_ASSERT(m->om_omp == &os_mbuf_pool);
+    os_mbuf_free_chain(m);
+
+#if MYNEWT_VAL(OS_MSYS_SIZE_CLASS)
+    /*** Small class exhausted; falls back to the next larger one. */
+    m = os_msys_get(16, 0);
+    TEST_ASSERT_FATAL(m != NULL);
+    TEST_ASSERT(m->om_omp == &os_mbuf_pool);
+    os_mbuf_free_chain(m);
+
+    m = os_msys_get_pkthdr(16, 0);
+    TEST_ASSERT_FATAL(m != NULL);
+    TEST_ASSERT(m->om_omp == &os_mbuf_pool);
+    os_mbuf_free_chain(m);
+#endif
+
+    for (i = 0; i < MSYS_TEST_SMALL_COUNT; i++) {
+        os_mbuf_free_chain(small[i]);
+    }
+
+    TEST_ASSERT(os_msys_num_free() ==
+                MSYS_TEST_SMALL_COUNT + MBUF_TEST_POOL_BUF_COUNT);
+
+    os_msys_reset();
+    os_mempool_unregister(&msys_test_small_mempool);
+}
@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define MBUF_TEST_USRHDR_LEN    (4)
+
+/**
+ * Writes payload into a packet header mbuf with a user header, then checks
+ * that the payload does not overlap either header.
+ */
+TEST_CASE(os_mbuf_test_usrhdr)
+{
+    static const uint8_t usrhdr[MBUF_TEST_USRHDR_LEN] = { 1, 2, 3, 4 };
+    struct os_mbuf_pkthdr *omp;
+    struct os_mbuf *om;
+    int rc;
+
+    os_mbuf_test_setup();
+
+    om = os_mbuf_get_pkthdr(&os_mbuf_pool, MBUF_TEST_USRHDR_LEN);
+    TEST_ASSERT_FATAL(om != NULL);
+    TEST_ASSERT(om->om_data == om->om_databuf + om->om_pkthdr_len);
+    TEST_ASSERT((uint8_t *)OS_MBUF_USRHDR(om) + MBUF_TEST_USRHDR_LEN ==
+                om->om_data);
+    memcpy(OS_MBUF_USRHDR(om), usrhdr, sizeof usrhdr);
+
+    rc = os_mbuf_append(om, os_mbuf_test_data, 16);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(memcmp(OS_MBUF_USRHDR(om), usrhdr, sizeof usrhdr) == 0);
+
+    /* What an mqueue does with a queued packet. */
+    omp = OS_MBUF_PKTHDR(om);
+    STAILQ_NEXT(omp, omp_next) = (void *)omp;
+    TEST_ASSERT(memcmp(om->om_data, os_mbuf_test_data, 16) == 0);
+    TEST_ASSERT(memcmp(OS_MBUF_USRHDR(om), usrhdr, sizeof usrhdr) == 0);
+    TEST_ASSERT(OS_MBUF_PKTLEN(om) == 16);
+    STAILQ_NEXT(omp, omp_next) = NULL;
+
+    os_mbuf_test_misc_assert_sane(om, os_mbuf_test_data, 16, 16,
+                                  sizeof(struct os_mbuf_pkthdr) +
+                                  MBUF_TEST_USRHDR_LEN);
+
+    rc = os_mbuf_free_chain(om);
+    TEST_ASSERT(rc == 0);
+}
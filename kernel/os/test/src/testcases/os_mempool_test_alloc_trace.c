@@ -0,0 +1,176 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+
+#define TRACE_TEST_MAX_SITES    8
+#define TRACE_TEST_BLOCK_SIZE   (sizeof(struct os_mbuf) + 32)
+
+static struct os_alloc_trace_site trace_sites[TRACE_TEST_MAX_SITES];
+static int trace_num_sites;
+
+static os_membuf_t trace_buf[OS_MEMPOOL_SIZE(4, TRACE_TEST_BLOCK_SIZE)];
+static struct os_mempool trace_mp;
+static struct os_mbuf_pool trace_mbuf_pool;
+
+static int
+trace_site_collect(const struct os_alloc_trace_site *oats, void *arg)
+{
+    TEST_ASSERT_FATAL(trace_num_sites < TRACE_TEST_MAX_SITES);
+    trace_sites[trace_num_sites++] = *oats;
+    return 0;
+}
+
+/* Number of sites seen with the given type, and the last one of them */
+static int
+trace_sites_of_type(uint8_t type, struct os_alloc_trace_site **oats)
+{
+    int cnt;
+    int i;
+
+    cnt = 0;
+    for (i = 0; i < trace_num_sites; i++) {
+        if (trace_sites[i].oats_type == type) {
+            *oats = &trace_sites[i];
+            cnt++;
+        }
+    }
+    return cnt;
+}
+
+static void
+trace_collect(void)
+{
+    int rc;
+
+    trace_num_sites = 0;
+    rc = os_alloc_trace_sites(trace_site_collect, NULL);
+    TEST_ASSERT(rc == 0);
+}
+
+static void * __attribute__((noinline))
+trace_alloc_a(size_t size)
+{
+    return os_malloc(size);
+}
+
+static void * __attribute__((noinline))
+trace_alloc_b(size_t size)
+{
+    return os_malloc(size);
+}
+#endif
+
+/*
+ * Runs in a task, so that small os_malloc() requests go through the task
+ * cache when OS_MALLOC_TASK_CACHE is enabled.
+ */
+TEST_CASE_TASK(os_mempool_test_alloc_trace)
+{
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+    struct os_alloc_trace_site *oats;
+    struct os_mbuf *om;
+    uintptr_t site_a;
+    void *a[3];
+    void *b;
+    void *blk;
+    int rc;
+    int i;
+
+    os_alloc_trace_clear();
+
+    trace_collect();
+    TEST_ASSERT(trace_num_sites == 0);
+
+    /* Two of three allocations from site a outstanding, one from site b. */
+    for (i = 0; i < 3; i++) {
+        a[i] = trace_alloc_a(300);
+        TEST_ASSERT_FATAL(a[i] != NULL);
+    }
+    b = trace_alloc_b(200);
+    TEST_ASSERT_FATAL(b != NULL);
+    os_free(a[1]);
+
+    trace_collect();
+    TEST_ASSERT(trace_sites_of_type(OS_ALLOC_TRACE_MALLOC, &oats) == 2);
+    TEST_ASSERT(trace_sites[0].oats_count == 2);
+    TEST_ASSERT(trace_sites[0].oats_bytes == 600);
+    TEST_ASSERT(trace_sites[1].oats_count == 1);
+    TEST_ASSERT(trace_sites[1].oats_bytes == 200);
+    TEST_ASSERT(trace_sites[0].oats_caller != trace_sites[1].oats_caller);
+    site_a = trace_sites[0].oats_caller;
+
+    os_free(a[0]);
+    os_free(a[2]);
+    os_free(b);
+    trace_collect();
+    TEST_ASSERT(trace_num_sites == 0);
+
+    /*
+     * A small allocation may be served by the task cache, which takes
+     * several blocks from its pool at once.  Only the block handed out is
+     * outstanding, and none once it is freed.
+     */
+    a[0] = trace_alloc_a(64);
+    TEST_ASSERT_FATAL(a[0] != NULL);
+    trace_collect();
+    TEST_ASSERT(trace_num_sites == 1);
+    TEST_ASSERT(trace_sites[0].oats_type == OS_ALLOC_TRACE_MALLOC);
+    TEST_ASSERT(trace_sites[0].oats_caller == site_a);
+    TEST_ASSERT(trace_sites[0].oats_count == 1);
+    TEST_ASSERT(trace_sites[0].oats_bytes == 64);
+
+    os_free(a[0]);
+    trace_collect();
+    TEST_ASSERT(trace_num_sites == 0);
+
+    /* An mbuf is one allocation, not an mbuf and a memory block. */
+    rc = os_mempool_init(&trace_mp, 4, TRACE_TEST_BLOCK_SIZE, trace_buf,
+                         "trace_mp");
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_mbuf_pool_init(&trace_mbuf_pool, &trace_mp,
+                           TRACE_TEST_BLOCK_SIZE, 4);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    om = os_mbuf_get(&trace_mbuf_pool, 0);
+    TEST_ASSERT_FATAL(om != NULL);
+    blk = os_memblock_get(&trace_mp);
+    TEST_ASSERT_FATAL(blk != NULL);
+
+    trace_collect();
+    TEST_ASSERT(trace_num_sites == 2);
+    TEST_ASSERT(trace_sites_of_type(OS_ALLOC_TRACE_MBUF_GET, &oats) == 1);
+    TEST_ASSERT(oats->oats_count == 1);
+    TEST_ASSERT(trace_sites_of_type(OS_ALLOC_TRACE_MEMBLOCK_GET, &oats) == 1);
+    TEST_ASSERT(oats->oats_bytes == TRACE_TEST_BLOCK_SIZE);
+
+    os_mbuf_free(om);
+    os_memblock_put(&trace_mp, blk);
+    trace_collect();
+    TEST_ASSERT(trace_num_sites == 0);
+
+    os_mempool_unregister(&trace_mp);
+    os_alloc_trace_clear();
+#endif
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
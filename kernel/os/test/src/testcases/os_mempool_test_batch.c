@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+static os_membuf_t batch_buf[OS_MEMPOOL_SIZE(MEMPOOL_TEST_BATCH_BLOCKS,
+                                             MEM_BLOCK_SIZE)];
+static void *batch_blocks[MEMPOOL_TEST_BATCH_BLOCKS];
+
+/*
+ * Checks os_memblock_get_n() / os_memblock_put_n() with partial results,
+ * invalid arguments and bursts of 1 to MEMPOOL_TEST_BATCH_BLOCKS blocks.
+ */
+TEST_CASE(os_mempool_test_batch)
+{
+    struct os_mempool pool;
+    int burst;
+    int rc;
+    int i;
+    int j;
+
+    rc = os_mempool_init(&pool, MEMPOOL_TEST_BATCH_BLOCKS, MEM_BLOCK_SIZE,
+                         batch_buf, "test_batch");
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /*** Get more than the pool holds; only what is free is returned. */
+    rc = os_memblock_get_n(&pool, batch_blocks, 4);
+    TEST_ASSERT_FATAL(rc == 4);
+    rc = os_memblock_get_n(&pool, batch_blocks + 4,
+                           MEMPOOL_TEST_BATCH_BLOCKS);
+    TEST_ASSERT_FATAL(rc == MEMPOOL_TEST_BATCH_BLOCKS - 4);
+    TEST_ASSERT(pool.mp_num_free == 0);
+    TEST_ASSERT(pool.mp_min_free == 0);
+    TEST_ASSERT(os_memblock_get_n(&pool, batch_blocks, 1) == 0);
+    TEST_ASSERT(os_memblock_get(&pool) == NULL);
+
+    for (i = 0; i < MEMPOOL_TEST_BATCH_BLOCKS; i++) {
+        TEST_ASSERT(os_memblock_from(&pool, batch_blocks[i]));
+    }
+
+    /*** Put everything back, in two chunks. */
+    rc = os_memblock_put_n(&pool, batch_blocks, 10);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(pool.mp_num_free == 10);
+    rc = os_memblock_put_n(&pool, batch_blocks + 10,
+                           MEMPOOL_TEST_BATCH_BLOCKS - 10);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(pool.mp_num_free == MEMPOOL_TEST_BATCH_BLOCKS);
+    TEST_ASSERT(os_mempool_is_sane(&pool));
+
+    /*** Invalid arguments. */
+    TEST_ASSERT(os_memblock_get_n(NULL, batch_blocks, 1) == 0);
+    TEST_ASSERT(os_memblock_get_n(&pool, batch_blocks, 0) == 0);
+    TEST_ASSERT(os_memblock_put_n(NULL, batch_blocks, 1) == OS_INVALID_PARM);
+    TEST_ASSERT(os_memblock_put_n(&pool, batch_blocks, 0) == OS_OK);
+
+    /*** Bursts: distinct blocks out, all of them back. */
+    for (burst = 1; burst <= MEMPOOL_TEST_BATCH_BLOCKS; burst *= 2) {
+        rc = os_memblock_get_n(&pool, batch_blocks, burst);
+        TEST_ASSERT_FATAL(rc == burst);
+        TEST_ASSERT(pool.mp_num_free == MEMPOOL_TEST_BATCH_BLOCKS - burst);
+        for (i = 0; i < burst; i++) {
+            TEST_ASSERT(os_memblock_from(&pool, batch_blocks[i]));
+            for (j = 0; j < i; j++) {
+                TEST_ASSERT(batch_blocks[i] != batch_blocks[j]);
+            }
+        }
+
+        rc = os_memblock_put_n(&pool, batch_blocks, burst);
+        TEST_ASSERT_FATAL(rc == 0);
+        TEST_ASSERT(pool.mp_num_free == MEMPOOL_TEST_BATCH_BLOCKS);
+    }
+
+    TEST_ASSERT(os_mempool_is_sane(&pool));
+
+    os_mempool_unregister(&pool);
+}
@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+
+static struct os_task cache_task;
+static os_stack_t cache_task_stack[MEMPOOL_TEST_CACHE_STACK_SIZE];
+
+/* Number of free blocks in the shared pool for the given block size */
+static int
+cache_pool_free(int block_size)
+{
+    struct os_mempool_info omi;
+    struct os_mempool *mp;
+    char name[OS_MEMPOOL_INFO_NAME_LEN];
+
+    snprintf(name, sizeof name, "os_malloc_%d", block_size);
+
+    mp = NULL;
+    while ((mp = os_mempool_info_get_next(mp, &omi)) != NULL) {
+        if (strcmp(omi.omi_name, name) == 0) {
+            return omi.omi_num_free;
+        }
+    }
+
+    TEST_ASSERT_FATAL(0, "pool %s not found", name);
+    return -1;
+}
+
+static void
+cache_task_handler(void *arg)
+{
+    void *p;
+
+    /* Leave blocks in this task's cache, then sleep until removed. */
+    p = os_malloc(48);
+    TEST_ASSERT(p != NULL);
+    os_free(p);
+
+    os_time_delay(OS_TIMEOUT_NEVER);
+}
+#endif
+
+TEST_CASE_TASK(os_mempool_test_malloc_cache)
+{
+#if MYNEWT_VAL(OS_MALLOC_TASK_CACHE)
+    void *blocks[MYNEWT_VAL(OS_MALLOC_TASK_CACHE_HWM) + 2];
+    uint8_t *p;
+    void *q;
+    int free32;
+    int free128;
+    int n;
+    int i;
+    int rc;
+
+    free32 = cache_pool_free(32);
+    free128 = cache_pool_free(128);
+
+    /* A miss takes a batch from the pool; the next hit reuses the block. */
+    p = os_malloc(20);
+    TEST_ASSERT_FATAL(p != NULL);
+    TEST_ASSERT(cache_pool_free(32) < free32);
+    n = cache_pool_free(32);
+    os_free(p);
+    q = os_malloc(32);
+    TEST_ASSERT(q == p);
+    TEST_ASSERT(cache_pool_free(32) == n);
+
+    /* Large requests come from the heap. */
+    q = os_malloc(200);
+    TEST_ASSERT_FATAL(q != NULL);
+    os_free(q);
+    TEST_ASSERT(cache_pool_free(128) == free128);
+
+    /* Realloc stays in place within the class and moves between classes. */
+    for (i = 0; i < 20; i++) {
+        p[i] = i;
+    }
+    q = os_realloc(p, 30);
+    TEST_ASSERT(q == p);
+    p = os_realloc(p, 100);
+    TEST_ASSERT_FATAL(p != NULL);
+    TEST_ASSERT(cache_pool_free(128) < free128);
+    for (i = 0; i < 20; i++) {
+        TEST_ASSERT(p[i] == i);
+    }
+    os_free(p);
+
+    /* Freeing past the high watermark returns blocks to the pool. */
+    for (i = 0; i < (int)(sizeof blocks / sizeof blocks[0]); i++) {
+        blocks[i] = os_malloc(32);
+        TEST_ASSERT_FATAL(blocks[i] != NULL);
+    }
+    for (i = 0; i < (int)(sizeof blocks / sizeof blocks[0]); i++) {
+        os_free(blocks[i]);
+    }
+    TEST_ASSERT(cache_pool_free(32) >=
+                free32 - MYNEWT_VAL(OS_MALLOC_TASK_CACHE_HWM));
+
+    os_malloc_task_flush(os_sched_get_current_task());
+    TEST_ASSERT(cache_pool_free(32) == free32);
+    TEST_ASSERT(cache_pool_free(128) == free128);
+
+    /* Removing a task flushes its cache. */
+    n = cache_pool_free(64);
+    rc = os_task_init(&cache_task, "cache", cache_task_handler, NULL,
+                      MEMPOOL_TEST_CACHE_TASK_PRIO, OS_WAIT_FOREVER,
+                      cache_task_stack, MEMPOOL_TEST_CACHE_STACK_SIZE);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(cache_pool_free(64) < n);
+
+    rc = os_task_remove(&cache_task);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cache_pool_free(64) == n);
+#endif
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
@@ -0,0 +1,152 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os/mynewt.h"
+#include "runtest/runtest.h"
+#include "os_test_priv.h"
+
+#define MUTEX_TEST_CHAIN_STACK_SIZE     OS_STACK_ALIGN(1024)
+#define MUTEX_TEST_CHAIN_HOLD_TICKS     (OS_TICKS_PER_SEC / 10)
+
+static struct os_task chain_low_task;
+static struct os_task chain_mid_task;
+static os_stack_t chain_low_stack[MUTEX_TEST_CHAIN_STACK_SIZE];
+static os_stack_t chain_mid_stack[MUTEX_TEST_CHAIN_STACK_SIZE];
+
+/* Holds g_mutex2 for a while. */
+static void
+chain_low_handler(void *arg)
+{
+    os_error_t err;
+
+    err = os_mutex_pend(&g_mutex2, OS_TIMEOUT_NEVER);
+    TEST_ASSERT(err == OS_OK);
+    os_time_delay(MUTEX_TEST_CHAIN_HOLD_TICKS);
+    err = os_mutex_release(&g_mutex2);
+    TEST_ASSERT(err == OS_OK);
+
+    os_time_delay(OS_TIMEOUT_NEVER);
+}
+
+/* Takes g_mutex1, then waits for g_mutex2 while holding it. */
+static void
+chain_mid_handler(void *arg)
+{
+    os_error_t err;
+
+    /* Let the low task take g_mutex2 first. */
+    os_time_delay(1);
+
+    err = os_mutex_pend(&g_mutex1, OS_TIMEOUT_NEVER);
+    TEST_ASSERT(err == OS_OK);
+    err = os_mutex_pend(&g_mutex2, OS_TIMEOUT_NEVER);
+    TEST_ASSERT(err == OS_OK);
+    err = os_mutex_release(&g_mutex2);
+    TEST_ASSERT(err == OS_OK);
+    err = os_mutex_release(&g_mutex1);
+    TEST_ASSERT(err == OS_OK);
+
+    os_time_delay(OS_TIMEOUT_NEVER);
+}
+
+TEST_CASE_TASK(os_mutex_test_chain)
+{
+    struct os_task *cur;
+    os_error_t err;
+    uint8_t prio;
+    int rc;
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    struct os_mutex_info omi;
+    struct os_mutex *mu;
+    int found;
+#endif
+
+    cur = os_sched_get_current_task();
+    prio = cur->t_prio;
+
+    os_mutex_init(&g_mutex1);
+    os_mutex_init(&g_mutex2);
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    os_mutex_register(&g_mutex2, "chain2");
+#endif
+
+    rc = os_task_init(&chain_low_task, "chain_low", chain_low_handler, NULL,
+                      prio + 2, OS_WAIT_FOREVER, chain_low_stack,
+                      MUTEX_TEST_CHAIN_STACK_SIZE);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = os_task_init(&chain_mid_task, "chain_mid", chain_mid_handler, NULL,
+                      prio + 1, OS_WAIT_FOREVER, chain_mid_stack,
+                      MUTEX_TEST_CHAIN_STACK_SIZE);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* The mid task now waits for g_mutex2 and boosts the low task. */
+    os_time_delay(3);
+    TEST_ASSERT_FATAL(g_mutex1.mu_owner == &chain_mid_task);
+    TEST_ASSERT_FATAL(g_mutex2.mu_owner == &chain_low_task);
+    TEST_ASSERT(chain_mid_task.t_prio == prio + 1);
+    TEST_ASSERT(chain_low_task.t_prio == prio + 1);
+
+    /* Waiting on g_mutex1 boosts both the mid and the low task. */
+    err = os_mutex_pend(&g_mutex1, 2);
+    TEST_ASSERT(err == OS_TIMEOUT);
+    TEST_ASSERT(chain_mid_task.t_prio == prio);
+    TEST_ASSERT(chain_low_task.t_prio == prio);
+
+    /* Once both mutexes are released all priorities are restored. */
+    os_time_delay(MUTEX_TEST_CHAIN_HOLD_TICKS * 2);
+    TEST_ASSERT(g_mutex1.mu_level == 0);
+    TEST_ASSERT(g_mutex2.mu_level == 0);
+    TEST_ASSERT(chain_mid_task.t_prio == prio + 1);
+    TEST_ASSERT(chain_low_task.t_prio == prio + 2);
+
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    TEST_ASSERT(g_mutex1.mu_stats.oms_acquired == 1);
+    TEST_ASSERT(g_mutex1.mu_stats.oms_contended == 1);
+    TEST_ASSERT(g_mutex2.mu_stats.oms_acquired == 2);
+    TEST_ASSERT(g_mutex2.mu_stats.oms_contended == 1);
+    TEST_ASSERT(g_mutex2.mu_stats.oms_max_hold >=
+                g_mutex2.mu_stats.oms_max_wait);
+
+    found = 0;
+    mu = NULL;
+    while ((mu = os_mutex_info_get_next(mu, &omi)) != NULL) {
+        if (mu == &g_mutex2) {
+            TEST_ASSERT(strcmp(omi.omi_name, "chain2") == 0);
+            TEST_ASSERT(omi.omi_owner == NULL);
+            TEST_ASSERT(omi.omi_acquired == 2);
+            TEST_ASSERT(omi.omi_max_wait_us > 0);
+            found = 1;
+        }
+        TEST_ASSERT(mu != &g_mutex1);
+    }
+    TEST_ASSERT(found);
+
+    os_mutex_stats_clear(&g_mutex2);
+    TEST_ASSERT(g_mutex2.mu_stats.oms_acquired == 0);
+#endif
+
+    rc = os_task_remove(&chain_mid_task);
+    TEST_ASSERT(rc == 0);
+    rc = os_task_remove(&chain_low_task);
+    TEST_ASSERT(rc == 0);
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
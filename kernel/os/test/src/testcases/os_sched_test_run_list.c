@@ -0,0 +1,94 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+/* Spreads the filler priorities so they are not made ready in order */
+#define SCHED_TEST_PRIO(i) \
+    (SCHED_TEST_TASK_PRIO + ((i) * 37) % SCHED_TEST_MAX_TASKS)
+
+/*
+ * Checks that the ready queue hands out tasks by priority however they were
+ * made ready, and that the head of g_os_run_list, which the ports load on a
+ * context switch, always matches os_sched_next_task().
+ */
+TEST_CASE_TASK(os_sched_test_run_list)
+{
+    struct os_task *cur;
+    struct os_task *t;
+    os_sr_t sr;
+    int i;
+    int rc;
+
+    cur = os_sched_get_current_task();
+
+    for (i = 0; i < SCHED_TEST_MAX_TASKS; i++) {
+        rc = os_task_init(&sched_test_tasks[i], "filler",
+                          sched_test_filler_handler, NULL, SCHED_TEST_PRIO(i),
+                          OS_WAIT_FOREVER, sched_test_stacks[i],
+                          SCHED_TEST_STACK_SIZE);
+        TEST_ASSERT_FATAL(rc == 0);
+
+        TEST_ASSERT(os_sched_next_task() == cur);
+        TEST_ASSERT(TAILQ_FIRST(&g_os_run_list) == cur);
+    }
+
+    OS_ENTER_CRITICAL(sr);
+
+    /* With the test task out of the way, the fillers come up in order. */
+    os_sched_sleep(cur, OS_TIMEOUT_NEVER);
+    for (i = 0; i < SCHED_TEST_MAX_TASKS; i++) {
+        t = os_sched_next_task();
+        TEST_ASSERT(t->t_prio == SCHED_TEST_TASK_PRIO + i);
+        TEST_ASSERT(TAILQ_FIRST(&g_os_run_list) == t);
+        os_sched_sleep(t, OS_TIMEOUT_NEVER);
+    }
+    TEST_ASSERT(os_sched_next_task()->t_prio == OS_IDLE_PRIO);
+
+    /* Woken in reverse, the highest priority one is still picked. */
+    for (i = SCHED_TEST_MAX_TASKS - 1; i >= 0; i--) {
+        os_sched_wakeup(&sched_test_tasks[i]);
+        TEST_ASSERT(os_sched_next_task() == &sched_test_tasks[i] ||
+                    os_sched_next_task()->t_prio < SCHED_TEST_PRIO(i));
+    }
+    t = os_sched_next_task();
+    TEST_ASSERT(t->t_prio == SCHED_TEST_TASK_PRIO);
+
+    /* A task whose priority is raised moves to the front once resorted. */
+    sched_test_tasks[1].t_prio = SCHED_TEST_TASK_PRIO - 1;
+    os_sched_resort(&sched_test_tasks[1]);
+    TEST_ASSERT(os_sched_next_task() == &sched_test_tasks[1]);
+    TEST_ASSERT(TAILQ_FIRST(&g_os_run_list) == &sched_test_tasks[1]);
+    sched_test_tasks[1].t_prio = SCHED_TEST_PRIO(1);
+    os_sched_resort(&sched_test_tasks[1]);
+    TEST_ASSERT(os_sched_next_task() == t);
+
+    os_sched_wakeup(cur);
+    TEST_ASSERT(os_sched_next_task() == cur);
+
+    OS_EXIT_CRITICAL(sr);
+
+    for (i = 0; i < SCHED_TEST_MAX_TASKS; i++) {
+        rc = os_task_remove(&sched_test_tasks[i]);
+        TEST_ASSERT(rc == 0);
+    }
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
@@ -0,0 +1,101 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+/* Order in which filler i is due to wake up; 37 is coprime with the count. */
+#define SCHED_TEST_RANK(i)  (((i) * 37) % SCHED_TEST_MAX_TASKS)
+
+static struct os_task *
+sched_test_task_by_rank(int rank)
+{
+    int i;
+
+    for (i = 0; i < SCHED_TEST_MAX_TASKS; i++) {
+        if (SCHED_TEST_RANK(i) == rank) {
+            return &sched_test_tasks[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Puts tasks to sleep with scattered timeouts, then checks that the next
+ * wakeup reported for tickless idle is always the earliest one, as tasks
+ * are woken up both in and out of order.
+ */
+TEST_CASE_TASK(os_sched_test_sleep_order)
+{
+    struct os_task *t;
+    os_time_t now;
+    os_sr_t sr;
+    int rank;
+    int i;
+    int rc;
+
+    for (i = 0; i < SCHED_TEST_MAX_TASKS; i++) {
+        rc = os_task_init(&sched_test_tasks[i], "filler",
+                          sched_test_filler_handler, NULL,
+                          SCHED_TEST_TASK_PRIO + i, OS_WAIT_FOREVER,
+                          sched_test_stacks[i], SCHED_TEST_STACK_SIZE);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+
+    OS_ENTER_CRITICAL(sr);
+    now = os_time_get();
+
+    for (i = 0; i < SCHED_TEST_MAX_TASKS; i++) {
+        os_sched_sleep(&sched_test_tasks[i],
+                       SCHED_TEST_SLEEP_TICKS + SCHED_TEST_RANK(i) * 3);
+    }
+    TEST_ASSERT(os_sched_wakeup_ticks(now) == SCHED_TEST_SLEEP_TICKS);
+
+    /* A tick with nothing due wakes nobody. */
+    os_sched_os_timer_exp();
+    for (i = 0; i < SCHED_TEST_MAX_TASKS; i++) {
+        TEST_ASSERT(sched_test_tasks[i].t_state == OS_TASK_SLEEP);
+    }
+
+    /* Out of order: every third one, starting with the latest. */
+    for (rank = SCHED_TEST_MAX_TASKS - 1; rank >= 0; rank -= 3) {
+        os_sched_wakeup(sched_test_task_by_rank(rank));
+    }
+
+    /* In order: the earliest one is always reported next. */
+    for (rank = 0; rank < SCHED_TEST_MAX_TASKS; rank++) {
+        t = sched_test_task_by_rank(rank);
+        if (t->t_state != OS_TASK_SLEEP) {
+            continue;
+        }
+        TEST_ASSERT(os_sched_wakeup_ticks(now) ==
+                    SCHED_TEST_SLEEP_TICKS + rank * 3);
+        os_sched_wakeup(t);
+    }
+    TEST_ASSERT(os_sched_wakeup_ticks(now) == OS_TIMEOUT_NEVER);
+
+    OS_EXIT_CRITICAL(sr);
+
+    for (i = 0; i < SCHED_TEST_MAX_TASKS; i++) {
+        rc = os_task_remove(&sched_test_tasks[i]);
+        TEST_ASSERT(rc == 0);
+    }
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
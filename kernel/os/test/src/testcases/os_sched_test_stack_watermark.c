@@ -0,0 +1,104 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+#define WM_STACK_SIZE   OS_STACK_ALIGN(256)
+#define WM_GAP          MYNEWT_VAL(OS_TASK_STACK_WATERMARK_GAP)
+
+static struct os_task wm_task;
+static os_stack_t wm_stack[WM_STACK_SIZE];
+
+/* Marks the stack word at the given depth from the top as used. */
+static void
+wm_touch(int depth)
+{
+    wm_stack[WM_STACK_SIZE - depth] = 0;
+}
+#endif
+
+/*
+ * Checks that the stack watermark follows deeper use of a task's stack, and
+ * that the incremental scan stops at a large enough unused hole while a full
+ * scan does not.  The task never runs; its stack is written directly.
+ */
+TEST_CASE_TASK(os_sched_test_stack_watermark)
+{
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+    struct os_task_info oti;
+    struct os_task *t;
+    uint16_t base;
+    uint16_t usage;
+    uint16_t rec;
+    int depth;
+    int rc;
+
+    rc = os_task_init(&wm_task, "wm", sched_test_filler_handler, NULL,
+                      SCHED_TEST_TASK_PRIO, OS_WAIT_FOREVER, wm_stack,
+                      WM_STACK_SIZE);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Only the initial frame is in use. */
+    base = os_task_stack_usage(&wm_task, 1);
+    TEST_ASSERT_FATAL(base < WM_STACK_SIZE / 4);
+
+    /*** Deeper use below the watermark. */
+    depth = base + 10;
+    wm_touch(depth);
+    TEST_ASSERT(os_task_stack_usage(&wm_task, 0) == depth);
+
+    /*** A hole smaller than the gap is crossed. */
+    depth += WM_GAP;
+    wm_touch(depth);
+    TEST_ASSERT(os_task_stack_usage(&wm_task, 0) == depth);
+
+    /*** A larger hole needs a full scan. */
+    usage = depth;
+    depth += WM_GAP + 5;
+    wm_touch(depth);
+    TEST_ASSERT(os_task_stack_usage(&wm_task, 0) == usage);
+    TEST_ASSERT(os_task_stack_usage(&wm_task, 1) == depth);
+
+    /*** The watermark never goes back up. */
+    wm_stack[WM_STACK_SIZE - depth] = OS_STACK_PATTERN;
+    TEST_ASSERT(os_task_stack_usage(&wm_task, 1) == depth);
+
+    t = NULL;
+    while ((t = os_task_info_get_next(t, &oti)) != NULL) {
+        if (t == &wm_task) {
+            break;
+        }
+    }
+    TEST_ASSERT_FATAL(t == &wm_task);
+    TEST_ASSERT(oti.oti_stkusage == depth);
+    TEST_ASSERT(oti.oti_stksize == WM_STACK_SIZE);
+
+    /*** Recommendations add the margin and are multiples of 8. */
+    rec = os_task_stack_recommend(100);
+    TEST_ASSERT(rec >= 100 + MYNEWT_VAL(OS_TASK_STACK_MARGIN));
+    TEST_ASSERT(rec % 8 == 0);
+
+    rc = os_task_remove(&wm_task);
+    TEST_ASSERT(rc == 0);
+#endif
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
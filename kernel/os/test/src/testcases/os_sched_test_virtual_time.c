@@ -0,0 +1,75 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#if MYNEWT_VAL(SIM_VIRTUAL_TIME) && MYNEWT_VAL(SELFTEST)
+#include <time.h>
+
+#define VT_TEST_DELAY   (2 * 60 * 60 * OS_TICKS_PER_SEC)  /* 2 hours */
+
+static struct os_callout vt_test_callout;
+static os_time_t vt_test_fired;
+
+static void
+vt_test_callout_cb(struct os_event *ev)
+{
+    vt_test_fired = os_time_get();
+}
+#endif
+
+/*
+ * Sleeps for two hours of OS time with a callout due halfway through.  In
+ * virtual time both must land on exactly the tick they were due on, and the
+ * whole sleep must take well under a second of host time.
+ */
+TEST_CASE_TASK(os_sched_test_virtual_time)
+{
+#if MYNEWT_VAL(SIM_VIRTUAL_TIME) && MYNEWT_VAL(SELFTEST)
+    struct timespec start_ts;
+    struct timespec end_ts;
+    os_time_t start;
+    int64_t elapsed_ms;
+    int rc;
+
+    os_callout_init(&vt_test_callout, os_eventq_dflt_get(),
+                    vt_test_callout_cb, NULL);
+    vt_test_fired = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start_ts);
+    start = os_time_get();
+
+    rc = os_callout_reset(&vt_test_callout, VT_TEST_DELAY / 2);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    os_time_delay(VT_TEST_DELAY);
+    TEST_ASSERT(os_time_get() - start == VT_TEST_DELAY);
+
+    /* The callout event is processed by the main task at the expiry tick. */
+    TEST_ASSERT(vt_test_fired - start == VT_TEST_DELAY / 2);
+
+    clock_gettime(CLOCK_MONOTONIC, &end_ts);
+    elapsed_ms = (end_ts.tv_sec - start_ts.tv_sec) * 1000 +
+                 (end_ts.tv_nsec - start_ts.tv_nsec) / 1000000;
+    TEST_ASSERT(elapsed_ms < 1000);
+#endif
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
@@ -0,0 +1,174 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define WORKQ_TEST_ITEMS        (8)
+#define WORKQ_TEST_CHILDREN     (6)
+#define WORKQ_TEST_RESUBMITS    (4)
+
+static struct os_workq basic_wq;
+static struct os_eventq basic_evq;
+static struct os_work basic_work[WORKQ_TEST_ITEMS];
+static struct os_work basic_children[WORKQ_TEST_CHILDREN];
+static struct os_work basic_parent;
+static int basic_runs;
+static int basic_done;
+
+static void
+basic_work_fn(struct os_work *work)
+{
+    basic_runs++;
+}
+
+static void
+basic_child_fn(struct os_work *work)
+{
+    /* Block, so that idle workers get to steal the remaining children. */
+    os_time_delay(1);
+    basic_runs++;
+}
+
+static void
+basic_parent_fn(struct os_work *work)
+{
+    int rc;
+    int i;
+
+    for (i = 0; i < WORKQ_TEST_CHILDREN; i++) {
+        rc = os_workq_submit(&basic_wq, &basic_children[i], &basic_evq);
+        TEST_ASSERT(rc == 0);
+    }
+    basic_runs++;
+}
+
+static void
+basic_resubmit_fn(struct os_work *work)
+{
+    int rc;
+
+    if (++basic_runs < WORKQ_TEST_RESUBMITS) {
+        rc = os_workq_submit(&basic_wq, work, &basic_evq);
+        TEST_ASSERT(rc == 0);
+    }
+}
+
+static void
+basic_done_cb(struct os_event *ev)
+{
+    struct os_work *work;
+
+    work = ev->ev_arg;
+    TEST_ASSERT(os_work_arg(work) == &basic_wq);
+    basic_done++;
+}
+
+static void
+basic_wait(int done)
+{
+    while (basic_done < done) {
+        os_eventq_run(&basic_evq);
+    }
+}
+
+TEST_CASE_TASK(os_workq_test_basic)
+{
+    uint32_t steals;
+    uint32_t runs;
+    int rc;
+    int i;
+
+    os_eventq_init(&basic_evq);
+    basic_runs = 0;
+    basic_done = 0;
+
+    rc = os_workq_init(&basic_wq, "workq", workq_test_workers, 3,
+                       WORKQ_TEST_PRIO, workq_test_stacks[0],
+                       WORKQ_TEST_STACK_SIZE);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /*** Submit, resubmit and cancel. */
+    for (i = 0; i < WORKQ_TEST_ITEMS; i++) {
+        os_work_init(&basic_work[i], basic_work_fn, basic_done_cb, &basic_wq);
+        rc = os_workq_submit(&basic_wq, &basic_work[i], &basic_evq);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+    TEST_ASSERT(os_workq_submit(&basic_wq, &basic_work[0], &basic_evq) ==
+                OS_EBUSY);
+    TEST_ASSERT(os_work_cancel(&basic_wq, &basic_work[1]) == 0);
+    TEST_ASSERT(os_work_cancel(&basic_wq, &basic_work[1]) == OS_ENOENT);
+
+    /* Nothing runs until the test task waits. */
+    TEST_ASSERT(basic_runs == 0);
+    basic_wait(WORKQ_TEST_ITEMS - 1);
+    TEST_ASSERT(basic_runs == WORKQ_TEST_ITEMS - 1);
+    TEST_ASSERT(os_work_cancel(&basic_wq, &basic_work[0]) == OS_ENOENT);
+
+    /* Submissions from outside the pool are spread over the workers. */
+    for (i = 0; i < 3; i++) {
+        TEST_ASSERT(workq_test_workers[i].oww_runs > 0);
+    }
+
+    /*** Work submitted by a worker is stolen by the idle ones. */
+    basic_runs = 0;
+    basic_done = 0;
+    steals = 0;
+    for (i = 0; i < 3; i++) {
+        steals += workq_test_workers[i].oww_steals;
+    }
+    for (i = 0; i < WORKQ_TEST_CHILDREN; i++) {
+        os_work_init(&basic_children[i], basic_child_fn, basic_done_cb,
+                     &basic_wq);
+    }
+    os_work_init(&basic_parent, basic_parent_fn, basic_done_cb, &basic_wq);
+    rc = os_workq_submit(&basic_wq, &basic_parent, &basic_evq);
+    TEST_ASSERT_FATAL(rc == 0);
+    basic_wait(WORKQ_TEST_CHILDREN + 1);
+    TEST_ASSERT(basic_runs == WORKQ_TEST_CHILDREN + 1);
+
+    runs = 0;
+    for (i = 0; i < 3; i++) {
+        runs += workq_test_workers[i].oww_runs;
+        steals -= workq_test_workers[i].oww_steals;
+    }
+    TEST_ASSERT(runs == WORKQ_TEST_ITEMS - 1 + WORKQ_TEST_CHILDREN + 1);
+    TEST_ASSERT(steals != 0);
+
+    /*** Every run of an item that resubmits itself is reported. */
+    basic_runs = 0;
+    basic_done = 0;
+    os_work_init(&basic_parent, basic_resubmit_fn, basic_done_cb, &basic_wq);
+    rc = os_workq_submit(&basic_wq, &basic_parent, &basic_evq);
+    TEST_ASSERT_FATAL(rc == 0);
+    /* Let all runs finish while the first completion event is queued. */
+    while (basic_runs < WORKQ_TEST_RESUBMITS) {
+        os_time_delay(1);
+    }
+    basic_wait(WORKQ_TEST_RESUBMITS);
+    TEST_ASSERT(basic_done == WORKQ_TEST_RESUBMITS);
+
+    /*** Bad arguments. */
+    TEST_ASSERT(os_workq_submit(&basic_wq, NULL, NULL) == OS_INVALID_PARM);
+    TEST_ASSERT(os_workq_init(&basic_wq, "workq", workq_test_workers, 0,
+                              WORKQ_TEST_PRIO, workq_test_stacks[0],
+                              WORKQ_TEST_STACK_SIZE) == OS_INVALID_PARM);
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
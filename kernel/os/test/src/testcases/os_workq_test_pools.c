@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+static struct os_eventq pools_evq;
+static struct os_work pools_work[WORKQ_TEST_POOL_ITEMS];
+static uint8_t pools_runs[WORKQ_TEST_POOL_ITEMS];
+static uint8_t pools_done[WORKQ_TEST_POOL_ITEMS];
+static int pools_num_done;
+
+static void
+pools_work_fn(struct os_work *work)
+{
+    pools_runs[work - pools_work]++;
+}
+
+static void
+pools_done_cb(struct os_event *ev)
+{
+    struct os_work *work;
+
+    work = ev->ev_arg;
+    pools_done[work - pools_work]++;
+    pools_num_done++;
+}
+
+/*
+ * Runs the same batch of work items on pools of 1, 2 and 4 workers.  Every
+ * item must run exactly once and report completion exactly once, and the
+ * batch must be spread over all of the pool's workers.
+ */
+TEST_CASE_TASK(os_workq_test_pools)
+{
+    struct os_workq wq;
+    uint32_t runs;
+    int num_workers;
+    int first;
+    int rc;
+    int i;
+
+    os_eventq_init(&pools_evq);
+
+    first = 0;
+    for (num_workers = 1; num_workers <= 4; num_workers *= 2) {
+        rc = os_workq_init(&wq, "pools", &workq_test_workers[first],
+                           num_workers, WORKQ_TEST_PRIO + first,
+                           workq_test_stacks[first], WORKQ_TEST_STACK_SIZE);
+        TEST_ASSERT_FATAL(rc == 0);
+
+        memset(pools_runs, 0, sizeof pools_runs);
+        memset(pools_done, 0, sizeof pools_done);
+        pools_num_done = 0;
+        for (i = 0; i < WORKQ_TEST_POOL_ITEMS; i++) {
+            os_work_init(&pools_work[i], pools_work_fn, pools_done_cb, NULL);
+            rc = os_workq_submit(&wq, &pools_work[i], &pools_evq);
+            TEST_ASSERT_FATAL(rc == 0);
+        }
+        while (pools_num_done < WORKQ_TEST_POOL_ITEMS) {
+            os_eventq_run(&pools_evq);
+        }
+
+        for (i = 0; i < WORKQ_TEST_POOL_ITEMS; i++) {
+            TEST_ASSERT(pools_runs[i] == 1);
+            TEST_ASSERT(pools_done[i] == 1);
+        }
+
+        runs = 0;
+        for (i = first; i < first + num_workers; i++) {
+            TEST_ASSERT(workq_test_workers[i].oww_runs > 0);
+            runs += workq_test_workers[i].oww_runs;
+        }
+        TEST_ASSERT(runs == WORKQ_TEST_POOL_ITEMS);
+
+        first += num_workers;
+    }
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
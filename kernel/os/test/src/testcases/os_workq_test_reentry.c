@@ -0,0 +1,96 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "os_test_priv.h"
+
+#define REENTRY_TEST_WORKERS    (3)
+#define REENTRY_TEST_RUNS       (8)
+
+static struct os_workq reentry_wq;
+static struct os_eventq reentry_evq;
+static struct os_work reentry_work;
+static int reentry_active;
+static int reentry_overlap;
+static int reentry_runs;
+static int reentry_done;
+
+static void
+reentry_work_fn(struct os_work *work)
+{
+    int rc;
+
+    if (reentry_active) {
+        reentry_overlap = 1;
+    }
+    reentry_active = 1;
+
+    if (++reentry_runs < REENTRY_TEST_RUNS) {
+        rc = os_workq_submit(&reentry_wq, work, &reentry_evq);
+        TEST_ASSERT(rc == 0);
+        rc = os_workq_submit(&reentry_wq, work, &reentry_evq);
+        TEST_ASSERT(rc == OS_EBUSY);
+    }
+
+    /* Block, so that the idle workers above this one get to run. */
+    os_time_delay(1);
+    reentry_active = 0;
+}
+
+static void
+reentry_done_cb(struct os_event *ev)
+{
+    reentry_done++;
+}
+
+/*
+ * An item that resubmits itself from its function, on a pool of workers of
+ * different priorities.  The resubmission must not run until the current
+ * run has returned, even though an idle worker would preempt the running
+ * one to take it.
+ */
+TEST_CASE_TASK(os_workq_test_reentry)
+{
+    int rc;
+
+    os_eventq_init(&reentry_evq);
+    reentry_active = 0;
+    reentry_overlap = 0;
+    reentry_runs = 0;
+    reentry_done = 0;
+
+    rc = os_workq_init(&reentry_wq, "reentry", workq_test_workers,
+                       REENTRY_TEST_WORKERS, WORKQ_TEST_PRIO,
+                       workq_test_stacks[0], WORKQ_TEST_STACK_SIZE);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    os_work_init(&reentry_work, reentry_work_fn, reentry_done_cb, NULL);
+    rc = os_workq_submit(&reentry_wq, &reentry_work, &reentry_evq);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    while (reentry_done < REENTRY_TEST_RUNS) {
+        os_eventq_run(&reentry_evq);
+    }
+
+    TEST_ASSERT(reentry_runs == REENTRY_TEST_RUNS);
+    TEST_ASSERT(reentry_overlap == 0);
+    TEST_ASSERT(os_work_cancel(&reentry_wq, &reentry_work) == OS_ENOENT);
+
+#if MYNEWT_VAL(SELFTEST)
+    os_test_restart();
+#endif
+}
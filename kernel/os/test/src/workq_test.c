@@ -0,0 +1,36 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "os_test_priv.h"
+
+struct os_workq_worker workq_test_workers[WORKQ_TEST_MAX_WORKERS];
+os_stack_t workq_test_stacks[WORKQ_TEST_MAX_WORKERS][WORKQ_TEST_STACK_SIZE];
+
+TEST_CASE_DECL(os_workq_test_basic)
+TEST_CASE_DECL(os_workq_test_pools)
+TEST_CASE_DECL(os_workq_test_reentry)
+
+TEST_SUITE(os_workq_test_suite)
+{
+    os_workq_test_basic();
+    os_workq_test_pools();
+    os_workq_test_reentry();
+}
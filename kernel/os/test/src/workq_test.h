@@ -0,0 +1,49 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _WORKQ_TEST_H
+#define _WORKQ_TEST_H
+
+#include <stdio.h>
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "os_test_priv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Enough workers for os_workq_test_pools' pools of 1, 2 and 4 workers */
+#define WORKQ_TEST_MAX_WORKERS  (7)
+#define WORKQ_TEST_STACK_SIZE   (OS_STACK_ALIGN(1024))
+
+/* Workers sit below the test task, so they only run while it waits. */
+#define WORKQ_TEST_PRIO         (MYNEWT_VAL(OS_MAIN_TASK_PRIO) + 2)
+
+/* Number of work items run on each of os_workq_test_pools' pools */
+#define WORKQ_TEST_POOL_ITEMS   (64)
+
+extern struct os_workq_worker workq_test_workers[WORKQ_TEST_MAX_WORKERS];
+extern os_stack_t
+    workq_test_stacks[WORKQ_TEST_MAX_WORKERS][WORKQ_TEST_STACK_SIZE];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _WORKQ_TEST_H */
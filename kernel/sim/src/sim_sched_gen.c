@@ -121,6 +121,27 @@ sim_tick(void)
     }
 }
 
+/**
+ * Advances OS time straight to the next wakeup.  Used in place of the tick
+ * timer when SIM_VIRTUAL_TIME is enabled; only called from the idle task, so
+ * no task can observe the jump.
+ */
+void
+sim_tick_virtual(os_time_t ticks)
+{
+    OS_ASSERT_CRITICAL();
+
+    /*
+     * Something is due already (e.g., a callout reset with zero ticks).  Move
+     * on by one tick as the periodic timer would have.
+     */
+    if (ticks == 0) {
+        ticks = 1;
+    }
+
+    os_time_advance(ticks);
+}
+
 static void
 sim_start_timer(void)
 {
@@ -211,7 +232,9 @@ sim_os_start(void)
     assert(sr == 0);
 
     /* Enable the interrupt sources */
-    sim_start_timer();
+    if (!MYNEWT_VAL(SIM_VIRTUAL_TIME)) {
+        sim_start_timer();
+    }
 
     t = os_sched_next_task();
     os_sched_set_current_task(t);
@@ -243,8 +266,7 @@ sim_os_init(void)
     g_current_task = NULL;
 
     STAILQ_INIT(&g_os_task_list);
-    TAILQ_INIT(&g_os_run_list);
-    TAILQ_INIT(&g_os_sleep_list);
+    os_sched_init();
 
     sim_signals_init();
 
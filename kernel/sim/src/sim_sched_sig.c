@@ -171,6 +171,11 @@ sim_tick_idle(os_time_t ticks)
 
     OS_ASSERT_CRITICAL();
 
+    if (MYNEWT_VAL(SIM_VIRTUAL_TIME)) {
+        sim_tick_virtual(ticks);
+        return;
+    }
+
     if (ticks > 0) {
         /*
          * Enter tickless regime and set the timer to fire after 'ticks'
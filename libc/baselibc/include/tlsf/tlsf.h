@@ -0,0 +1,93 @@
+/*
+ * tlsf.h
+ *
+ * Two-level segregated fit allocator.  Free blocks are kept in one list per
+ * size class; a first level splits sizes by power of two and a second level
+ * splits each power of two linearly.  Bitmaps of non-empty classes make
+ * allocation and free constant time.
+ *
+ * malloc() uses a tlsf heap when BASELIBC_MALLOC_TLSF is set.  The
+ * functions here let other code run private heaps.
+ */
+
+#ifndef _TLSF_H
+#define _TLSF_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Log2 of the number of second level lists per power of two */
+#define TLSF_SL_LOG2    MYNEWT_VAL(BASELIBC_TLSF_SL_LOG2)
+#define TLSF_SL_COUNT   (1 << TLSF_SL_LOG2)
+
+/* Blocks are aligned to, and a multiple of, two words */
+#define TLSF_ALIGN_LOG2 (sizeof(size_t) == 8 ? 4 : 3)
+#define TLSF_ALIGN      (1 << TLSF_ALIGN_LOG2)
+
+/* Blocks smaller than this all live in first level list 0 */
+#define TLSF_FL_SHIFT   (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_COUNT   (MYNEWT_VAL(BASELIBC_TLSF_FL_MAX) - TLSF_FL_SHIFT + 1)
+
+/* Largest block, including its header */
+#define TLSF_BLOCK_MAX  (((size_t)1 << MYNEWT_VAL(BASELIBC_TLSF_FL_MAX)) - \
+                         TLSF_ALIGN)
+
+struct tlsf_block;
+
+struct tlsf {
+    /* Bit N set when sl_map[N] is non-zero */
+    uint32_t fl_map;
+    /* Bit M of sl_map[N] set when blocks[N][M] is non-empty */
+    uint32_t sl_map[TLSF_FL_COUNT];
+    struct tlsf_block *blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+    /* End marker of the most recently added pool */
+    struct tlsf_block *last_pool_end;
+    /* Bytes in free blocks, including block headers */
+    size_t free_bytes;
+};
+
+/*
+ * Initialize an empty heap.  A zero filled struct tlsf is also a valid
+ * empty heap.
+ */
+void tlsf_init(struct tlsf *t);
+
+/*
+ * Give the heap memory to allocate from.  Memory directly following the
+ * previously added pool is merged with it.  Pools larger than
+ * TLSF_BLOCK_MAX are split into several blocks.
+ */
+void tlsf_add_pool(struct tlsf *t, void *mem, size_t size);
+
+void *tlsf_malloc(struct tlsf *t, size_t size);
+void tlsf_free(struct tlsf *t, void *ptr);
+
+/*
+ * Resize an allocation, in place when shrinking or when the following block
+ * is free and large enough.
+ */
+void *tlsf_realloc(struct tlsf *t, void *ptr, size_t size);
+
+/*
+ * Smallest pool that tlsf_malloc() can satisfy a request of the given size
+ * from.  Used to size memory requested from _sbrk().
+ */
+size_t tlsf_pool_size(size_t size);
+
+/*
+ * Report the number of free bytes and the size of the largest free block,
+ * both including block headers as get_malloc_memory_status() does.
+ */
+void tlsf_status(const struct tlsf *t, size_t *free_bytes,
+                 size_t *largest_block);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,6 +9,9 @@
 #include <assert.h>
 #include <stdint.h>
 #include "malloc.h"
+#include "syscfg/syscfg.h"
+
+#if !MYNEWT_VAL(BASELIBC_MALLOC_TLSF)
 
 /* Both the arena list and the free memory list are double linked
    list with head node.  This the head node. Note that the arena list
@@ -274,3 +277,5 @@ void set_malloc_locking(malloc_lock_t lock, malloc_unlock_t unlock)
     else
         malloc_unlock = &malloc_unlock_nop;
 }
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * malloc_tlsf.c
+ *
+ * malloc()/free() on a two-level segregated fit heap, used instead of
+ * malloc.c when BASELIBC_MALLOC_TLSF is set.  Allocation and free take
+ * constant time regardless of heap fragmentation.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "tlsf/tlsf.h"
+
+#if MYNEWT_VAL(BASELIBC_MALLOC_TLSF)
+
+/* A zero filled heap is empty and needs no initialization */
+static struct tlsf __malloc_tlsf;
+
+static bool malloc_lock_nop() {return true;}
+static void malloc_unlock_nop() {}
+
+static malloc_lock_t malloc_lock = &malloc_lock_nop;
+static malloc_unlock_t malloc_unlock = &malloc_unlock_nop;
+
+/* Get more memory for a request of the given size from _sbrk() */
+static bool malloc_grow(size_t size)
+{
+    void *more_mem;
+    size_t pool_size;
+    extern void *_sbrk(int incr);
+
+    pool_size = tlsf_pool_size(size);
+    if (pool_size == 0)
+        return false;
+
+    more_mem = _sbrk(pool_size);
+    if (more_mem == (void *)-1)
+        return false;
+
+    tlsf_add_pool(&__malloc_tlsf, more_mem, pool_size);
+    return true;
+}
+
+void *malloc(size_t size)
+{
+    void *result;
+
+    if (!malloc_lock())
+        return NULL;
+
+    result = tlsf_malloc(&__malloc_tlsf, size);
+    if (result == NULL && malloc_grow(size)) {
+        result = tlsf_malloc(&__malloc_tlsf, size);
+    }
+
+    malloc_unlock();
+    return result;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    void *result;
+
+    if (!malloc_lock())
+        return NULL;
+
+    result = tlsf_realloc(&__malloc_tlsf, ptr, size);
+    if (result == NULL && size != 0 && malloc_grow(size)) {
+        result = tlsf_realloc(&__malloc_tlsf, ptr, size);
+    }
+
+    malloc_unlock();
+    return result;
+}
+
+/* Call this to give malloc some memory to allocate from */
+void add_malloc_block(void *buf, size_t size)
+{
+    if (!malloc_lock())
+        return;
+
+    tlsf_add_pool(&__malloc_tlsf, buf, size);
+
+    malloc_unlock();
+}
+
+void free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    if (!malloc_lock())
+        return;
+
+    tlsf_free(&__malloc_tlsf, ptr);
+
+    malloc_unlock();
+}
+
+void get_malloc_memory_status(size_t *free_bytes, size_t *largest_block)
+{
+    *free_bytes = 0;
+    *largest_block = 0;
+
+    if (!malloc_lock())
+        return;
+
+    tlsf_status(&__malloc_tlsf, free_bytes, largest_block);
+
+    malloc_unlock();
+}
+
+void set_malloc_locking(malloc_lock_t lock, malloc_unlock_t unlock)
+{
+    if (lock)
+        malloc_lock = lock;
+    else
+        malloc_lock = &malloc_lock_nop;
+
+    if (unlock)
+        malloc_unlock = unlock;
+    else
+        malloc_unlock = &malloc_unlock_nop;
+}
+
+#endif
@@ -6,6 +6,9 @@
 #include <string.h>
 
 #include "malloc.h"
+#include "syscfg/syscfg.h"
+
+#if !MYNEWT_VAL(BASELIBC_MALLOC_TLSF)
 
 /* FIXME: This is cheesy, it should be fixed later */
 
@@ -49,3 +52,5 @@ void *realloc(void *ptr, size_t size)
 		return newptr;
 	}
 }
+
+#endif
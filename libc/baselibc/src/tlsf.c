@@ -0,0 +1,419 @@
+/*
+ * tlsf.c
+ *
+ * Two-level segregated fit allocator; see tlsf/tlsf.h.
+ *
+ * Every block starts with a header holding its size and a pointer to the
+ * physically previous block.  Free blocks also hold the free list links,
+ * so the smallest block is a header plus two pointers.  Each pool ends
+ * with a zero sized, in use block so coalescing never runs off the end.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include "tlsf/tlsf.h"
+
+struct tlsf_block {
+    /* Physically previous block, NULL for the first block of a pool */
+    struct tlsf_block *prev_phys;
+    /* Size including this header; low bits hold the flags below */
+    size_t size;
+    /* Free list links, only valid while the block is free */
+    struct tlsf_block *next_free;
+    struct tlsf_block *prev_free;
+};
+
+#define BLOCK_FREE      0x1
+#define BLOCK_PREV_FREE 0x2
+#define BLOCK_FLAGS     (BLOCK_FREE | BLOCK_PREV_FREE)
+
+#define BLOCK_HDR       offsetof(struct tlsf_block, next_free)
+#define BLOCK_MIN       sizeof(struct tlsf_block)
+
+_Static_assert(TLSF_FL_COUNT > 0 && TLSF_FL_COUNT < 32,
+               "BASELIBC_TLSF_FL_MAX out of range");
+_Static_assert(TLSF_SL_LOG2 > 0 && TLSF_SL_LOG2 <= 5,
+               "BASELIBC_TLSF_SL_LOG2 out of range");
+_Static_assert(BLOCK_HDR == TLSF_ALIGN && BLOCK_MIN % TLSF_ALIGN == 0,
+               "block header does not match TLSF_ALIGN");
+
+static inline int tlsf_fls(size_t x)
+{
+    return (int)(sizeof(unsigned long) * 8) - 1 - __builtin_clzl(x);
+}
+
+static inline size_t block_size(const struct tlsf_block *b)
+{
+    return b->size & ~(size_t)BLOCK_FLAGS;
+}
+
+static inline struct tlsf_block *block_at(void *p, size_t off)
+{
+    return (struct tlsf_block *)((char *)p + off);
+}
+
+static inline struct tlsf_block *block_from_ptr(void *ptr)
+{
+    return (struct tlsf_block *)((char *)ptr - BLOCK_HDR);
+}
+
+static inline struct tlsf_block *block_next(struct tlsf_block *b)
+{
+    return block_at(b, block_size(b));
+}
+
+/* Block size needed for a request, or 0 if it can never be satisfied */
+static size_t block_size_for(size_t size)
+{
+    if (size == 0 || size > TLSF_BLOCK_MAX - BLOCK_HDR) {
+        return 0;
+    }
+
+    size = (size + BLOCK_HDR + TLSF_ALIGN - 1) & ~(size_t)(TLSF_ALIGN - 1);
+    if (size < BLOCK_MIN) {
+        size = BLOCK_MIN;
+    }
+    return size;
+}
+
+/* The free list a block of this size belongs to */
+static void mapping_insert(size_t size, int *fl, int *sl)
+{
+    int f;
+
+    if (size < ((size_t)1 << TLSF_FL_SHIFT)) {
+        *fl = 0;
+        *sl = size >> TLSF_ALIGN_LOG2;
+    } else {
+        f = tlsf_fls(size);
+        *sl = (size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = f - TLSF_FL_SHIFT + 1;
+    }
+}
+
+/*
+ * Round a size up to the lower bound of the next size class, so any block
+ * found in that class or above is large enough.
+ */
+static size_t mapping_round(size_t size)
+{
+    size_t step;
+
+    if (size >= ((size_t)1 << TLSF_FL_SHIFT)) {
+        step = (size_t)1 << (tlsf_fls(size) - TLSF_SL_LOG2);
+        size = (size + step - 1) & ~(step - 1);
+    }
+    return size;
+}
+
+static void insert_free(struct tlsf *t, struct tlsf_block *b)
+{
+    struct tlsf_block *head;
+    int fl, sl;
+
+    mapping_insert(block_size(b), &fl, &sl);
+
+    head = t->blocks[fl][sl];
+    b->next_free = head;
+    b->prev_free = NULL;
+    if (head) {
+        head->prev_free = b;
+    }
+    t->blocks[fl][sl] = b;
+    t->sl_map[fl] |= 1UL << sl;
+    t->fl_map |= 1UL << fl;
+    t->free_bytes += block_size(b);
+}
+
+static void remove_free(struct tlsf *t, struct tlsf_block *b)
+{
+    int fl, sl;
+
+    mapping_insert(block_size(b), &fl, &sl);
+
+    if (b->prev_free) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        t->blocks[fl][sl] = b->next_free;
+        if (!b->next_free) {
+            t->sl_map[fl] &= ~(1UL << sl);
+            if (!t->sl_map[fl]) {
+                t->fl_map &= ~(1UL << fl);
+            }
+        }
+    }
+    if (b->next_free) {
+        b->next_free->prev_free = b->prev_free;
+    }
+    t->free_bytes -= block_size(b);
+}
+
+/* A free block of at least size bytes, or NULL */
+static struct tlsf_block *find_free(struct tlsf *t, size_t size)
+{
+    uint32_t map;
+    int fl, sl;
+
+    mapping_insert(mapping_round(size), &fl, &sl);
+    if (fl >= TLSF_FL_COUNT) {
+        return NULL;
+    }
+
+    map = t->sl_map[fl] & (~0UL << sl);
+    if (!map) {
+        map = t->fl_map & (~0UL << (fl + 1));
+        if (!map) {
+            return NULL;
+        }
+        fl = __builtin_ctz(map);
+        map = t->sl_map[fl];
+    }
+    sl = __builtin_ctz(map);
+
+    return t->blocks[fl][sl];
+}
+
+/*
+ * Return an in use block to the heap, coalescing it with free neighbours
+ * as long as the result does not exceed TLSF_BLOCK_MAX.
+ */
+static void release_block(struct tlsf *t, struct tlsf_block *b)
+{
+    struct tlsf_block *n;
+    size_t size;
+
+#ifdef DEBUG_MALLOC
+    assert(!(b->size & BLOCK_FREE));
+#endif
+
+    size = block_size(b);
+    if ((b->size & BLOCK_PREV_FREE) &&
+        block_size(b->prev_phys) + size <= TLSF_BLOCK_MAX) {
+        b = b->prev_phys;
+        remove_free(t, b);
+        size += block_size(b);
+    }
+
+    n = block_at(b, size);
+    if ((n->size & BLOCK_FREE) && size + block_size(n) <= TLSF_BLOCK_MAX) {
+        remove_free(t, n);
+        size += block_size(n);
+    }
+
+    b->size = size | BLOCK_FREE | (b->size & BLOCK_PREV_FREE);
+    n = block_next(b);
+    n->prev_phys = b;
+    n->size |= BLOCK_PREV_FREE;
+
+    insert_free(t, b);
+}
+
+/*
+ * Mark a block that was just taken off its free list as in use, giving any
+ * tail past size bytes back to the heap.
+ */
+static void use_block(struct tlsf *t, struct tlsf_block *b, size_t size)
+{
+    struct tlsf_block *rest;
+    size_t rest_size;
+
+    rest_size = block_size(b) - size;
+    if (rest_size >= BLOCK_MIN) {
+        rest = block_at(b, size);
+        rest->prev_phys = b;
+        rest->size = rest_size | BLOCK_FREE;
+        block_next(rest)->prev_phys = rest;
+        b->size = size | (b->size & BLOCK_PREV_FREE);
+        insert_free(t, rest);
+    } else {
+        block_next(b)->size &= ~(size_t)BLOCK_PREV_FREE;
+        b->size &= ~(size_t)BLOCK_FREE;
+    }
+}
+
+void tlsf_init(struct tlsf *t)
+{
+    memset(t, 0, sizeof(*t));
+}
+
+void tlsf_add_pool(struct tlsf *t, void *mem, size_t size)
+{
+    struct tlsf_block *b;
+    struct tlsf_block *end;
+    uintptr_t start;
+    size_t chunk;
+    size_t flags;
+
+    start = ((uintptr_t)mem + TLSF_ALIGN - 1) & ~(uintptr_t)(TLSF_ALIGN - 1);
+    if (size < start - (uintptr_t)mem) {
+        return;
+    }
+    size = (size - (start - (uintptr_t)mem)) & ~(size_t)(TLSF_ALIGN - 1);
+
+    if (t->last_pool_end &&
+        start == (uintptr_t)t->last_pool_end + BLOCK_HDR) {
+        /* Continues the last pool; its end marker becomes a block */
+        if (size < BLOCK_MIN) {
+            return;
+        }
+        b = t->last_pool_end;
+        flags = b->size & BLOCK_PREV_FREE;
+    } else {
+        if (size < BLOCK_MIN + BLOCK_HDR) {
+            return;
+        }
+        size -= BLOCK_HDR;
+        b = (struct tlsf_block *)start;
+        b->prev_phys = NULL;
+        flags = 0;
+    }
+
+    while (size > 0) {
+        chunk = size > TLSF_BLOCK_MAX ? TLSF_BLOCK_MAX : size;
+        if (size - chunk > 0 && size - chunk < BLOCK_MIN) {
+            chunk -= BLOCK_MIN;
+        }
+        b->size = chunk | flags;
+
+        end = block_at(b, chunk);
+        end->prev_phys = b;
+        end->size = 0;
+
+        release_block(t, b);
+
+        flags = end->size & BLOCK_PREV_FREE;
+        size -= chunk;
+        b = end;
+    }
+
+    t->last_pool_end = b;
+}
+
+void *tlsf_malloc(struct tlsf *t, size_t size)
+{
+    struct tlsf_block *b;
+
+    size = block_size_for(size);
+    if (size == 0) {
+        return NULL;
+    }
+
+    b = find_free(t, size);
+    if (!b) {
+        return NULL;
+    }
+
+    remove_free(t, b);
+    use_block(t, b, size);
+
+    return block_at(b, BLOCK_HDR);
+}
+
+void tlsf_free(struct tlsf *t, void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    release_block(t, block_from_ptr(ptr));
+}
+
+void *tlsf_realloc(struct tlsf *t, void *ptr, size_t size)
+{
+    struct tlsf_block *b;
+    struct tlsf_block *n;
+    struct tlsf_block *rest;
+    size_t bsize;
+    size_t cur;
+    void *newptr;
+
+    if (!ptr) {
+        return tlsf_malloc(t, size);
+    }
+
+    if (size == 0) {
+        tlsf_free(t, ptr);
+        return NULL;
+    }
+
+    bsize = block_size_for(size);
+    if (bsize == 0) {
+        return NULL;
+    }
+
+    b = block_from_ptr(ptr);
+    cur = block_size(b);
+
+    if (bsize > cur) {
+        n = block_next(b);
+        if (!(n->size & BLOCK_FREE) || cur + block_size(n) < bsize) {
+            newptr = tlsf_malloc(t, size);
+            if (newptr) {
+                memcpy(newptr, ptr, cur - BLOCK_HDR);
+                tlsf_free(t, ptr);
+            }
+            return newptr;
+        }
+
+        /* Grow into the following free block */
+        remove_free(t, n);
+        b->size += block_size(n);
+        cur = block_size(b);
+        n = block_next(b);
+        n->prev_phys = b;
+        n->size &= ~(size_t)BLOCK_PREV_FREE;
+    }
+
+    if (cur - bsize >= BLOCK_MIN) {
+        rest = block_at(b, bsize);
+        rest->prev_phys = b;
+        rest->size = cur - bsize;
+        b->size = bsize | (b->size & BLOCK_PREV_FREE);
+        release_block(t, rest);
+    }
+
+    return ptr;
+}
+
+size_t tlsf_pool_size(size_t size)
+{
+    size = block_size_for(size);
+    if (size == 0) {
+        return 0;
+    }
+
+    /* Lower bound of the size class tlsf_malloc() will search from */
+    size = mapping_round(size);
+    if (size > TLSF_BLOCK_MAX) {
+        return 0;
+    }
+
+    /* Room for the pool end marker and for aligning the pool start */
+    return size + BLOCK_HDR + TLSF_ALIGN;
+}
+
+void tlsf_status(const struct tlsf *t, size_t *free_bytes,
+                 size_t *largest_block)
+{
+    const struct tlsf_block *b;
+    int fl, sl;
+
+    *free_bytes = t->free_bytes;
+    *largest_block = 0;
+
+    if (!t->fl_map) {
+        return;
+    }
+
+    /* Only the highest non-empty list can hold the largest block */
+    fl = tlsf_fls(t->fl_map);
+    sl = tlsf_fls(t->sl_map[fl]);
+    for (b = t->blocks[fl][sl]; b; b = b->next_free) {
+        if (block_size(b) > *largest_block) {
+            *largest_block = block_size(b);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef _BASELIBC_TEST_H
+#define _BASELIBC_TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "tlsf/tlsf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * One step of a recorded allocation trace: allocate mto_size bytes into
+ * slot mto_slot, or free the slot when mto_size is 0.
+ */
+struct malloc_trace_op {
+    uint8_t mto_slot;
+    uint16_t mto_size;
+};
+
+#define MALLOC_TRACE_SLOTS      64
+
+extern const struct malloc_trace_op malloc_trace[];
+extern const int malloc_trace_len;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BASELIBC_TEST_H */
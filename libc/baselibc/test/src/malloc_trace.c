@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "baselibc_test.h"
+
+/*
+ * Synthetic trace modelled on a connected sensor node: a few long-lived
+ * configuration and connection objects, bursts of short-lived CBOR encoder
+ * and representation buffers, and the occasional multi-kilobyte image or
+ * log chunk buffer.  Peak live payload is about 27KB.
+ */
+const struct malloc_trace_op malloc_trace[] = {
+    {60,  200}, {29,  300}, {60,    0}, {12,   36}, {10,  256}, {24, 4096},
+    {29,    0}, {45,   64}, {12,    0}, {35,   36}, {11,   16}, {49,   52},
+    {19,  128}, {59,   72}, {19,    0}, {11,    0}, {48,   36}, {60,  300},
+    {19,  160}, {54,   20}, {33,   24}, {19,    0}, {59,    0}, {27,  200},
+    {56,   16}, { 2,  100}, {44,  100}, {63,  160}, { 8,  384}, {39,  140},
+    {63,    0}, {37,   36}, {12,   52}, {37,    0}, { 9,  100}, {44,    0},
+    {57, 3072}, {14,   16}, {36,  256}, {12,    0}, {14,    0}, {36,    0},
+    { 5,  512}, { 5,    0}, { 1,  200}, { 1,    0}, {50,  512}, {16,   72},
+    { 4,  384}, {30, 1024}, {30,    0}, { 0,  160}, {11,   36}, {32,  256},
+    {11,    0}, {15,   16}, {15,    0}, {12,  200}, {12,    0}, {28,  200},
+    {11,   52}, {11,    0}, { 7,   64}, {17,   72}, {53,   20}, { 1,   20},
+    {31,   72}, { 1,    0}, {58,   52}, {41,   36}, {29,  160}, {29,    0},
+    {26,  300}, {33,    0}, {42,   36}, {34,   16}, {58,    0}, {42,    0},
+    {58, 4096}, {33,  384}, {55,   36}, {12, 2048}, {58,    0}, {23,   16},
+    {15,   72}, {38,   72}, {44,  256}, {55,    0}, {23,    0}, {12,    0},
+    {47,   32}, {22,  300}, {25,   36}, {38,    0}, {33,    0}, { 3, 3072},
+    {38, 1024}, { 3,    0}, {38,    0}, {22,    0}, {44,    0}, {34,    0},
+    {58,  512}, {62, 2048}, {15,    0}, {59,   52}, {27,    0}, { 9,    0},
+    { 9,  256}, {25,    0}, {25, 2048}, {59,    0}, {25,    0}, {62,    0},
+    { 9,    0}, {58,    0}, {47,    0}, {46,  300}, { 1,   16}, {62,  300},
+    {25,   72}, {20, 1536}, {29, 4096}, {29,    0}, {25,    0}, { 3,   20},
+    {38,   36}, {23,  140}, {15,   36}, { 3,    0}, {38,    0}, {30,  100},
+    {38,  300}, {55,   72}, {37, 3072}, {47,   36}, {38,    0}, {37,    0},
+    {30,    0}, {55,    0}, { 6, 1536}, { 5,   64}, {38,   72}, { 6,    0},
+    { 9,  140}, {36,   24}, { 4,    0}, {21,  140}, { 9,    0}, {42,   16},
+    {12,   36}, {38,    0}, {12,    0}, {36,    0}, {42,    0}, {25,   32},
+    { 5,    0}, {55,   52}, {47,    0}, {22,  300}, {12, 2048}, {14,  256},
+    {51,   64}, {63,   36}, {58,   20}, {40,  300}, {63,    0}, {13,  100},
+    {27,   16}, {27,    0}, {58,    0}, {44,  300}, { 4,  200}, {20,    0},
+    {38,  200}, {19,   72}, { 4,    0}, {58,  160}, { 5,  140}, { 4,  200},
+    { 5,    0}, { 4,    0}, {13,    0}, {58,    0}, {42,  512}, {61,   16},
+    { 3,   36}, { 6,   20}, {63,  100}, {36,   36}, {59,  256}, { 6,    0},
+    {19,    0}, {19,  128}, {36,    0}, { 6,   36}, { 9,  100}, {19,    0},
+    {52,   20}, { 5,  128}, {18,   24}, {63,    0}, { 6,    0}, {33,  200},
+    {47,   16}, {19,  200}, {33,    0}, {30,   36}, {47,    0}, { 5,    0},
+    {44,    0}, {20,   36}, {18,    0}, {52,    0}, {29,  100}, {30,    0},
+    {36,   36}, {13,  160}, {37, 1024}, { 4,   72}, {30,   36}, {11,   72},
+    { 4,    0}, {13,    0}, {33,  512}, {13,   20}, {18,   36}, {58,   20},
+    {44,   16}, { 5,  300}, {44,    0}, {44,  512}, {43,  160}, {52,   36},
+    {44,    0}, {34,   32}, {27,  512}, {40,    0}, { 4,  140}, {47, 1024},
+    {44,   20}, { 6,  200}, {63,   16}, {50,    0}, { 4,    0}, {63,    0},
+    { 6,    0}, {34,    0}, {63,  384}, {50,   20}, {40, 4096}, { 4,   52},
+    {46,    0}, {34,   16}, {46,   52}, { 6,   16}, { 6,    0}, { 6,  300},
+    { 6,    0}, { 6,   72}, {46,    0}, {46,  100}, {46,    0}, {46,  300},
+    { 6,    0}, {34,    0}, {20,    0}, {46,    0}, {20,   20}, {46,   72},
+    { 6,  200}, {34,  128}, {20,    0}, { 5,    0}, {20,   36}, { 5,   52},
+    {20,    0}, {20,  140}, {33,    0}, {33,   24}, {33,    0}, {33,  300},
+    {20,    0}, {10,    0}, {33,    0}, { 6,    0}, {34,    0}, {34,  200},
+    {20,   52}, { 6,  300}, {10,  160}, {10,    0}, {33,   72}, {10,  256},
+    {10,    0}, {10,  256}, {33,    0}, {10,    0}, {10,  200}, {33,   52},
+    {10,    0}, {10,   32}, {10,    0}, { 1,    0}, {20,    0}, {20,  512},
+    { 1,  384}, {15,    0}, {33,    0}, {15,   72}, {10,   64}, {33,  256},
+    {15,    0}, {15,  140}, {16,    0}, {16,   72}, {24,    0}, {24,  300},
+    {16,    0}, { 8,    0}, {24,    0}, {15,    0}, {33,    0}, {15,  140},
+    {15,    0}, {16,  384}, { 8,  160}, { 8,    0}, {15,  100}, {24,  512},
+    { 8,  256}, {33,  256}, { 8,    0}, { 8,   52}, {15,    0}, {24,    0},
+    {24,  200}, { 8,    0}, {15,   72}, {15,    0}, { 8,   52}, {15,   20},
+    { 8,    0}, { 8,  200}, { 8,    0}, { 8, 1024}, { 8,    0}, {24,    0},
+    {24,  160}, {15,    0}, {20,    0}, {15,  256}, { 8,  300}, {20,  200},
+    {47,    0}, {15,    0}, { 8,    0}, {15,  256}, { 8,   20}, {47,  200},
+    {61,    0}, {15,    0}, {47,    0}, {20,    0}, {47,   16}, {61,  160},
+    {58,    0}, {15,  140}, {58,  300}, {20,   36}, {61,    0}, {61,  300},
+    {58,    0}, {61,    0}, {61,   52}, {58,   36}, {58,    0}, {23,    0},
+    {58,  512}, {23,   64}, {58,    0}, {58,   20}, {23,    0}, {23,   36},
+    {15,    0}, {15,  140}, {58,    0}, {58,   36}, {58,    0}, {58,  200},
+    {15,    0}, {15, 1024}, {15,    0}, {23,    0}, {58,    0}, {61,    0},
+    {15,  100}, {15,    0}, {17,    0}, { 8,    0}, {47,    0}, {15,  384},
+    {23,   16}, {58,  512}, { 8, 1536}, { 8,    0}, {15,    0}, {58,    0},
+    {15,   36}, {15,    0}, {23,    0}, {20,    0}, {61,  140}, {23,  512},
+    { 8,  140}, {17,   64}, {20, 2048}, {15,  140}, {20,    0}, {61,    0},
+    {23,    0}, {23,  256}, {23,    0}, {58,  100}, {61, 4096}, {20,  140},
+    {47,  384}, {23,  384}, {43,    0}, {43, 4096}, {20,    0}, {43,    0},
+    {20,  200}, {43,   16}, {43,    0}, {43,   52}, {43,    0}, {20,    0},
+    {43,   72}, {20,  256}, {43,    0}, {47,    0}, {23,    0}, {47,  200},
+    {23,  140}, {43,  384}, {47,    0}, {43,    0}, {43,   16}, {23,    0},
+    {23,  200}, {23,    0}, {47,   36}, {23,   48}, {23,    0}, {47,    0},
+    {23,   36}, {23,    0}, {23,   16}, {23,    0}, {43,    0}, {61,    0},
+    {23,  512}, {23,    0}, {23,   24}, {23,    0}, {20,    0}, {47,  256},
+    {43,  384}, {23,  160}, {47,    0}, {23,    0}, {23,   96}, {23,    0},
+    {23,   36}, {47,  100}, {61,   16}, {20,   36}, { 8,    0}, { 4,    0},
+    {23,    0}, {53,    0}, { 4,  512}, {20,    0}, {47,    0}, {53,   16},
+    {23,  300}, {47,  512}, { 8,   20}, {20,   48}, {47,    0}, {47,  384},
+    {47,    0}, {47,  200}, {20,    0}, {47,    0}, {20,  256}, { 8,    0},
+    { 8,   52}, {47,  160}, { 8,    0}, {55,    0}, { 8,  300}, {55,   96},
+    {55,    0}, {55,  300}, { 8,    0}, { 8,  200}, { 8,    0}, {20,    0},
+    {20,  300}, {20,    0}, { 8,   16}, {20,  256}, { 8,    0}, { 8,  140},
+    { 8,    0}, { 8,  200}, { 8,    0}, { 8,   16}, { 8,    0}, { 8,  384},
+    { 8,    0}, {20,    0}, {20,  384}, {20,    0}, {20,   72}, {56,    0},
+    { 8, 2048}, {56, 4096}, {56,    0}, {56,  100}, {56,    0}, { 2,    0},
+    { 2, 3072}, {56,   20}, {56,    0}, {56,   20}, {56,    0}, {57,    0},
+    {20,    0}, { 8,    0}, { 9,    0}, {55,    0}, {47,    0}, {56,  384},
+    {57,  140}, {20,   64}, { 9,  140}, {47,  300}, {55,  256}, {15,    0},
+    {52,    0}, {56,    0}, {47,    0}, { 8,   16}, {55,    0}, {15,  512},
+    {15,    0}, { 9,    0}, {20,    0}, {57,    0}, {15,   36}, {57,  256},
+    {47,  200}, { 9,  128}, {55,   20}, {52,  200}, {20,  200}, {56,   20},
+    { 6,    0}, { 6,   72}, {56,    0}, {56, 3072}, {18,    0}, {18,   24},
+    {56,    0}, {56,   36}, {56,    0}, {18,    0}, {56,  300}, {56,    0},
+    { 6,    0}, {56,   52}, {42,    0}, {42,   24}, {18,  512}, { 6,   72},
+    {11,    0}, {11,   16}, {18,    0}, {18,  100}, {11,    0}, { 6,    0},
+    {42,    0}, { 6,  256}, {11,  512}, {42,  200}, {42,    0}, {11,    0},
+    {42,  140}, {11,   72}, {42,    0}, {42,  128}, {11,    0}, {11,  384},
+    {42,    0}, {42,   72}, { 5,    0}, { 5,   72}, {40,    0}, {40,  256},
+    {42,    0}, { 5,    0}, { 5,   16}, {42,  200}, { 5,    0}, { 5,  300},
+    {19,    0}, {45,    0}, {45,  300}, {19,  512}, {45,    0}, { 5,    0},
+    {45,   72}, {19,    0}, { 5,   36}, {19,  100}, {55,    0}, {45,    0},
+    {55,   16}, {45,  140}, {55,    0}, {55,   52}, {45,    0}, {45,   20},
+    {26,    0}, {55,    0}, {26,   64}, {35,    0}, {35,  140}, {55,   20},
+    {18,    0}, {18,   16}, {55,    0}, {55,   36}, {18,    0}, {18, 3072},
+    {18,    0}, {18,  300}, {50,    0}, {50,  300}, {50,    0}, {18,    0},
+    {18,   32}, {50,   32}, {50,    0}, {50, 1536}, {50,    0}, {50,  300},
+    {18,    0}, {18,  200}, { 6,    0}, {50,    0}, { 6,  256}, {18,    0},
+    {55,    0}, {55,  200}, {55,    0}, {32,    0}, {35,    0}, {45,    0},
+    {26,    0}, {26, 2048}, {50,  300}, { 6,    0}, {50,    0}, {26,    0},
+    {32,   20}, { 5,    0}, {19,    0}, {55,  300}, {55,    0}, {55,  384},
+    {55,    0}, {42,    0}, {50,  256}, { 6, 3072}, { 6,    0}, {42,   36},
+    {18,   48}, {35,  512}, {16,    0}, {26,  200}, {35,    0}, {19,  140},
+    {55,   52}, { 6,  256}, {35,  200}, {49,    0}, {48,    0}, {60,    0},
+    {54,    0}, {39,    0}, { 0,    0}, {28,    0}, { 7,    0}, {31,    0},
+    {41,    0}, {62,    0}, {21,    0}, {25,    0}, {22,    0}, {12,    0},
+    {14,    0}, {51,    0}, {38,    0}, { 3,    0}, {59,    0}, {29,    0},
+    {36,    0}, {37,    0}, {30,    0}, {13,    0}, {27,    0}, {44,    0},
+    {63,    0}, {46,    0}, {34,    0}, { 1,    0}, {10,    0}, {33,    0},
+    {24,    0}, {17,    0}, {58,    0}, {43,    0}, {61,    0}, { 4,    0},
+    {53,    0}, {23,    0}, { 2,    0}, { 8,    0}, {15,    0}, {57,    0},
+    {47,    0}, { 9,    0}, {52,    0}, {20,    0}, {56,    0}, {11,    0},
+    {40,    0}, {32,    0}, {50,    0}, {42,    0}, {18,    0}, {26,    0},
+    {19,    0}, {55,    0}, { 6,    0}, {35,    0},
+};
+
+const int malloc_trace_len = sizeof(malloc_trace) / sizeof(malloc_trace[0]);
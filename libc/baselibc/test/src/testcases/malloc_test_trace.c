@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "baselibc_test.h"
+
+#define MALLOC_TRACE_ARENA_SIZE     (40 * 1024)
+#define MALLOC_TRACE_ITERS          4
+
+struct malloc_trace_heap {
+    void *(*alloc)(void *arg, size_t size);
+    void (*release)(void *arg, void *ptr);
+    void *arg;
+};
+
+static uint8_t malloc_trace_tlsf_arena[MALLOC_TRACE_ARENA_SIZE]
+    __attribute__((aligned(16)));
+static uint8_t malloc_trace_libc_arena[MALLOC_TRACE_ARENA_SIZE]
+    __attribute__((aligned(16)));
+static struct tlsf malloc_trace_tlsf;
+
+static void *
+malloc_trace_tlsf_alloc(void *arg, size_t size)
+{
+    return tlsf_malloc(arg, size);
+}
+
+static void
+malloc_trace_tlsf_free(void *arg, void *ptr)
+{
+    tlsf_free(arg, ptr);
+}
+
+static void *
+malloc_trace_libc_alloc(void *arg, size_t size)
+{
+    return malloc(size);
+}
+
+static void
+malloc_trace_libc_free(void *arg, void *ptr)
+{
+    free(ptr);
+}
+
+/**
+ * Replays the trace, filling each block with its slot number and checking
+ * that the fill is intact when the block is freed.  Returns the number of
+ * allocations that failed.
+ */
+static int
+malloc_trace_replay(const struct malloc_trace_heap *heap)
+{
+    uint8_t *slots[MALLOC_TRACE_SLOTS];
+    uint16_t sizes[MALLOC_TRACE_SLOTS];
+    const struct malloc_trace_op *op;
+    uint8_t *p;
+    int failed;
+    int iter;
+    int i;
+    int j;
+
+    memset(slots, 0, sizeof(slots));
+    failed = 0;
+
+    for (iter = 0; iter < MALLOC_TRACE_ITERS; iter++) {
+        for (i = 0; i < malloc_trace_len; i++) {
+            op = &malloc_trace[i];
+
+            if (op->mto_size != 0) {
+                p = heap->alloc(heap->arg, op->mto_size);
+                if (p == NULL) {
+                    failed++;
+                } else {
+                    TEST_ASSERT(((uintptr_t)p & (sizeof(void *) - 1)) == 0);
+                    memset(p, op->mto_slot, op->mto_size);
+                }
+                slots[op->mto_slot] = p;
+                sizes[op->mto_slot] = op->mto_size;
+            } else if (slots[op->mto_slot] != NULL) {
+                p = slots[op->mto_slot];
+                for (j = 0; j < sizes[op->mto_slot]; j++) {
+                    TEST_ASSERT_FATAL(p[j] == op->mto_slot);
+                }
+                heap->release(heap->arg, p);
+                slots[op->mto_slot] = NULL;
+            }
+        }
+    }
+
+    return failed;
+}
+
+/**
+ * Replays the recorded allocation trace against a TLSF heap and against
+ * malloc().  No two live blocks may overlap on either heap.  The trace fits
+ * the TLSF arena, and frees everything it allocates, so the TLSF heap must
+ * satisfy every request and coalesce back into a single block.  malloc()
+ * may grow its heap with _sbrk(), so its failures are not checked.
+ */
+TEST_CASE(malloc_test_trace)
+{
+    const struct malloc_trace_heap tlsf_heap = {
+        .alloc = malloc_trace_tlsf_alloc,
+        .release = malloc_trace_tlsf_free,
+        .arg = &malloc_trace_tlsf,
+    };
+    const struct malloc_trace_heap libc_heap = {
+        .alloc = malloc_trace_libc_alloc,
+        .release = malloc_trace_libc_free,
+    };
+    size_t free0, largest0;
+    size_t free1, largest1;
+
+    tlsf_init(&malloc_trace_tlsf);
+    tlsf_add_pool(&malloc_trace_tlsf, malloc_trace_tlsf_arena,
+                  sizeof(malloc_trace_tlsf_arena));
+    tlsf_status(&malloc_trace_tlsf, &free0, &largest0);
+
+    TEST_ASSERT(malloc_trace_replay(&tlsf_heap) == 0);
+    tlsf_status(&malloc_trace_tlsf, &free1, &largest1);
+    TEST_ASSERT(free1 == free0);
+    TEST_ASSERT(largest1 == largest0);
+
+    add_malloc_block(malloc_trace_libc_arena,
+                     sizeof(malloc_trace_libc_arena));
+    malloc_trace_replay(&libc_heap);
+}
@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ * 
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "baselibc_test.h"
+
+#define TLSF_TEST_PTRS      32
+
+static uint8_t tlsf_test_arena[8192] __attribute__((aligned(16)));
+
+/**
+ * Checks that blocks do not overlap, that realloc keeps contents and that
+ * freeing everything coalesces the heap back into a single block.
+ */
+TEST_CASE(tlsf_test_basic)
+{
+    struct tlsf t;
+    uint8_t *p[TLSF_TEST_PTRS];
+    size_t sz[TLSF_TEST_PTRS];
+    size_t free0, largest0;
+    size_t free1, largest1;
+    size_t j;
+    int i;
+
+    tlsf_init(&t);
+    tlsf_add_pool(&t, tlsf_test_arena, sizeof(tlsf_test_arena) / 2);
+    /* Memory right after the first pool extends it */
+    tlsf_add_pool(&t, tlsf_test_arena + sizeof(tlsf_test_arena) / 2,
+                  sizeof(tlsf_test_arena) / 2);
+    tlsf_status(&t, &free0, &largest0);
+    TEST_ASSERT(free0 == largest0);
+    TEST_ASSERT(free0 > sizeof(tlsf_test_arena) - 64);
+
+    TEST_ASSERT(tlsf_malloc(&t, 0) == NULL);
+    TEST_ASSERT(tlsf_malloc(&t, sizeof(tlsf_test_arena)) == NULL);
+
+    for (i = 0; i < TLSF_TEST_PTRS; i++) {
+        sz[i] = 1 + i * 7;
+        p[i] = tlsf_malloc(&t, sz[i]);
+        TEST_ASSERT_FATAL(p[i] != NULL);
+        TEST_ASSERT(((uintptr_t)p[i] & (sizeof(void *) - 1)) == 0);
+        memset(p[i], i, sz[i]);
+    }
+
+    /* Free every other block, then grow the rest in place or by moving */
+    for (i = 0; i < TLSF_TEST_PTRS; i += 2) {
+        tlsf_free(&t, p[i]);
+    }
+    for (i = 1; i < TLSF_TEST_PTRS; i += 2) {
+        p[i] = tlsf_realloc(&t, p[i], sz[i] * 3);
+        TEST_ASSERT_FATAL(p[i] != NULL);
+        for (j = 0; j < sz[i]; j++) {
+            TEST_ASSERT_FATAL(p[i][j] == i);
+        }
+        sz[i] *= 3;
+        memset(p[i], i, sz[i]);
+    }
+
+    /* Shrink in place */
+    for (i = 1; i < TLSF_TEST_PTRS; i += 2) {
+        TEST_ASSERT(tlsf_realloc(&t, p[i], 1) == p[i]);
+        TEST_ASSERT(p[i][0] == i);
+    }
+
+    for (i = 1; i < TLSF_TEST_PTRS; i += 2) {
+        tlsf_free(&t, p[i]);
+    }
+
+    tlsf_status(&t, &free1, &largest1);
+    TEST_ASSERT(free1 == free0);
+    TEST_ASSERT(largest1 == largest0);
+}
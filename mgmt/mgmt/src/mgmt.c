@@ -20,48 +20,52 @@
 
 #include "os/mynewt.h"
 #include <tinycbor/cbor.h>
+#include "rwlock/rwlock.h"
 #include "mgmt/mgmt.h"
 
-static struct os_mutex mgmt_group_lock;
+/* Zero-filled, the lock is ready for use before sysinit runs. */
+static struct rwlock mgmt_group_lock;
 static STAILQ_HEAD(, mgmt_group) mgmt_group_list =
     STAILQ_HEAD_INITIALIZER(mgmt_group_list);
 
 static int
 mgmt_group_list_lock(void)
 {
-    int rc;
-
     if (!os_started()) {
         return (0);
     }
 
-    rc = os_mutex_pend(&mgmt_group_lock, OS_WAIT_FOREVER);
-    if (rc != 0) {
-        goto err;
-    }
+    rwlock_acquire_write(&mgmt_group_lock);
 
     return (0);
-err:
-    return (rc);
 }
 
 int
 mgmt_group_list_unlock(void)
 {
-    int rc;
-
     if (!os_started()) {
         return (0);
     }
 
-    rc = os_mutex_release(&mgmt_group_lock);
-    if (rc != 0) {
-        goto err;
-    }
+    rwlock_release_write(&mgmt_group_lock);
 
     return (0);
-err:
-    return (rc);
+}
+
+static void
+mgmt_group_list_lock_read(void)
+{
+    if (os_started()) {
+        rwlock_acquire_read(&mgmt_group_lock);
+    }
+}
+
+static void
+mgmt_group_list_unlock_read(void)
+{
+    if (os_started()) {
+        rwlock_release_read(&mgmt_group_lock);
+    }
 }
 
 int
@@ -90,14 +94,8 @@ static struct mgmt_group *
 mgmt_find_group(uint16_t group_id)
 {
     struct mgmt_group *group;
-    int rc;
 
-    group = NULL;
-
-    rc = mgmt_group_list_lock();
-    if (rc != 0) {
-        goto err;
-    }
+    mgmt_group_list_lock_read();
 
     STAILQ_FOREACH(group, &mgmt_group_list, mg_next) {
         if (group->mg_group_id == group_id) {
@@ -105,14 +103,9 @@ mgmt_find_group(uint16_t group_id)
         }
     }
 
-    rc = mgmt_group_list_unlock();
-    if (rc != 0) {
-        goto err;
-    }
+    mgmt_group_list_unlock_read();
 
     return (group);
-err:
-    return (NULL);
 }
 
 const struct mgmt_handler *
@@ -33,6 +33,8 @@ extern "C" {
 #define NMGR_ID_MPSTATS         3
 #define NMGR_ID_DATETIME_STR    4
 #define NMGR_ID_RESET           5
+#define NMGR_ID_EVQPROF         6
+#define NMGR_ID_ALLOCTRACE      7
 
 int nmgr_os_groups_register(void);
 
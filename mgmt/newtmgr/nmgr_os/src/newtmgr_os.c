@@ -48,6 +48,14 @@ static int nmgr_def_mpstat_read(struct mgmt_cbuf *njb);
 static int nmgr_datetime_get(struct mgmt_cbuf *njb);
 static int nmgr_datetime_set(struct mgmt_cbuf *njb);
 static int nmgr_reset(struct mgmt_cbuf *njb);
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+static int nmgr_def_evqprof_read(struct mgmt_cbuf *njb);
+static int nmgr_def_evqprof_clear(struct mgmt_cbuf *njb);
+#endif
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+static int nmgr_def_alloctrace_read(struct mgmt_cbuf *njb);
+static int nmgr_def_alloctrace_clear(struct mgmt_cbuf *njb);
+#endif
 
 static const struct mgmt_handler nmgr_def_group_handlers[] = {
     [NMGR_ID_ECHO] = {
@@ -68,6 +76,16 @@ static const struct mgmt_handler nmgr_def_group_handlers[] = {
     [NMGR_ID_RESET] = {
         NULL, nmgr_reset
     },
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+    [NMGR_ID_EVQPROF] = {
+        nmgr_def_evqprof_read, nmgr_def_evqprof_clear
+    },
+#endif
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+    [NMGR_ID_ALLOCTRACE] = {
+        nmgr_def_alloctrace_read, nmgr_def_alloctrace_clear
+    },
+#endif
 };
 
 #define NMGR_DEF_GROUP_SZ                                               \
@@ -231,6 +249,137 @@ nmgr_def_mpstat_read(struct mgmt_cbuf *cb)
     return (0);
 }
 
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+static int
+nmgr_def_evqprof_read(struct mgmt_cbuf *cb)
+{
+    struct os_eventq_prof_info oepi;
+    CborError g_err = CborNoError;
+    CborEncoder cbs;
+    CborEncoder prof;
+    int idx;
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
+    g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "ovf");
+    g_err |= cbor_encode_uint(&cb->encoder, os_eventq_prof_overflow());
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "cbs");
+    g_err |= cbor_encoder_create_array(&cb->encoder, &cbs,
+                                       CborIndefiniteLength);
+
+    idx = -1;
+    while (1) {
+        idx = os_eventq_prof_info_get_next(idx, &oepi);
+        if (idx < 0) {
+            break;
+        }
+
+        g_err |= cbor_encoder_create_map(&cbs, &prof, CborIndefiniteLength);
+        g_err |= cbor_encode_text_stringz(&prof, "cb");
+        g_err |= cbor_encode_uint(&prof, (uintptr_t)oepi.oepi_cb);
+        g_err |= cbor_encode_text_stringz(&prof, "cnt");
+        g_err |= cbor_encode_uint(&prof, oepi.oepi_count);
+        g_err |= cbor_encode_text_stringz(&prof, "run");
+        g_err |= cbor_encode_uint(&prof, oepi.oepi_run_total_us);
+        g_err |= cbor_encode_text_stringz(&prof, "run_max");
+        g_err |= cbor_encode_uint(&prof, oepi.oepi_run_max_us);
+        g_err |= cbor_encode_text_stringz(&prof, "wait");
+        g_err |= cbor_encode_uint(&prof, oepi.oepi_wait_total_us);
+        g_err |= cbor_encode_text_stringz(&prof, "wait_max");
+        g_err |= cbor_encode_uint(&prof, oepi.oepi_wait_max_us);
+        g_err |= cbor_encoder_close_container(&cbs, &prof);
+    }
+
+    g_err |= cbor_encoder_close_container(&cb->encoder, &cbs);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return (0);
+}
+
+static int
+nmgr_def_evqprof_clear(struct mgmt_cbuf *cb)
+{
+    CborError g_err = CborNoError;
+
+    os_eventq_prof_clear();
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
+    g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return (0);
+}
+#endif
+
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+static int
+nmgr_def_alloctrace_site(const struct os_alloc_trace_site *oats, void *arg)
+{
+    CborError g_err = CborNoError;
+    CborEncoder *sites;
+    CborEncoder site;
+
+    sites = arg;
+
+    g_err |= cbor_encoder_create_map(sites, &site, CborIndefiniteLength);
+    g_err |= cbor_encode_text_stringz(&site, "type");
+    g_err |= cbor_encode_uint(&site, oats->oats_type);
+    g_err |= cbor_encode_text_stringz(&site, "caller");
+    g_err |= cbor_encode_uint(&site, oats->oats_caller);
+    g_err |= cbor_encode_text_stringz(&site, "cnt");
+    g_err |= cbor_encode_uint(&site, oats->oats_count);
+    g_err |= cbor_encode_text_stringz(&site, "bytes");
+    g_err |= cbor_encode_uint(&site, oats->oats_bytes);
+    g_err |= cbor_encode_text_stringz(&site, "age");
+    g_err |= cbor_encode_uint(&site, os_time_get() - oats->oats_oldest);
+    g_err |= cbor_encoder_close_container(sites, &site);
+
+    return g_err;
+}
+
+static int
+nmgr_def_alloctrace_read(struct mgmt_cbuf *cb)
+{
+    CborError g_err = CborNoError;
+    CborEncoder sites;
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
+    g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "drop");
+    g_err |= cbor_encode_uint(&cb->encoder, os_alloc_trace_dropped());
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "sites");
+    g_err |= cbor_encoder_create_array(&cb->encoder, &sites,
+                                       CborIndefiniteLength);
+    g_err |= os_alloc_trace_sites(nmgr_def_alloctrace_site, &sites);
+    g_err |= cbor_encoder_close_container(&cb->encoder, &sites);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return (0);
+}
+
+static int
+nmgr_def_alloctrace_clear(struct mgmt_cbuf *cb)
+{
+    CborError g_err = CborNoError;
+
+    os_alloc_trace_clear();
+
+    g_err |= cbor_encode_text_stringz(&cb->encoder, "rc");
+    g_err |= cbor_encode_int(&cb->encoder, MGMT_ERR_EOK);
+
+    if (g_err) {
+        return MGMT_ERR_ENOMEM;
+    }
+    return (0);
+}
+#endif
+
 static int
 nmgr_datetime_get(struct mgmt_cbuf *cb)
 {
@@ -502,7 +502,15 @@ coap_send_message(struct os_mbuf *m, int dup)
     STATS_INC(coap_stats, oframe);
 
     if (dup) {
+        /*
+         * The transaction keeps the original for retransmission; a clone
+         * shares its data, which the transports only read.
+         */
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+        m = os_mbuf_clone(NULL, m);
+#else
         m = os_mbuf_dup(m);
+#endif
         if (!m) {
             STATS_INC(coap_stats, oerr);
             return;
@@ -1372,7 +1380,15 @@ coap_get_payload(struct coap_packet_rx *pkt, struct os_mbuf **mp, uint16_t *off)
 int
 coap_set_payload(coap_packet_t *pkt, struct os_mbuf *m, size_t length)
 {
+    /*
+     * Observe notifications set the same response as the payload of one
+     * packet per observer; share its data rather than copying it each time.
+     */
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+    pkt->payload_m = os_mbuf_clone(NULL, m);
+#else
     pkt->payload_m = os_mbuf_dup(m);
+#endif
     if (!pkt->payload_m) {
         return -1;
     }
@@ -156,7 +156,12 @@ oc_send_buffer_ip4_int(struct os_mbuf *m, int is_mcast)
                 STATS_INC(oc_ip4_stats, oerr);
                 continue;
             }
+            /* The socket layer only reads the packet; share its data. */
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+            n = os_mbuf_clone(NULL, m);
+#else
             n = os_mbuf_dup(m);
+#endif
             if (!n) {
                 STATS_INC(oc_ip4_stats, oerr);
                 break;
@@ -157,7 +157,12 @@ oc_send_buffer_ip6_int(struct os_mbuf *m, int is_mcast)
                 continue;
             }
 
+            /* The socket layer only reads the packet; share its data. */
+#if MYNEWT_VAL(OS_MBUF_CLONE)
+            n = os_mbuf_clone(NULL, m);
+#else
             n = os_mbuf_dup(m);
+#endif
             if (!n) {
                 STATS_INC(oc_ip_stats, oerr);
                 break;
@@ -19,6 +19,7 @@
 #ifndef __SYS_CONFIG_FCB_H_
 #define __SYS_CONFIG_FCB_H_
 
+#include "os/mynewt.h"
 #include "config/config.h"
 #include "config/config_store.h"
 
@@ -26,9 +27,27 @@
 extern "C" {
 #endif
 
+#if MYNEWT_VAL(CONFIG_FCB_HASH_ENTRIES) > 0
+/*
+ * Location of the latest entry for one config name.
+ */
+struct conf_fcb_hash_entry {
+    uint32_t cfh_hash;		/* hash of the name, 0 if slot is free */
+    uint32_t cfh_data_off;	/* fe_data_off of the entry */
+    uint16_t cfh_data_len;	/* fe_data_len of the entry */
+    uint8_t cfh_sector;		/* index of fe_area in f_sectors */
+};
+#endif
+
 struct conf_fcb {
     struct conf_store cf_store;
     struct fcb cf_fcb;
+
+#if MYNEWT_VAL(CONFIG_FCB_HASH_ENTRIES) > 0
+    /* Internal - built by conf_fcb_src() */
+    struct conf_fcb_hash_entry cf_hash[MYNEWT_VAL(CONFIG_FCB_HASH_ENTRIES)];
+    uint8_t cf_hash_ok;		/* 0 if there were too many names */
+#endif
 };
 
 /**
@@ -65,6 +84,22 @@ void conf_fcb_compress(struct conf_fcb *cf,
                                           void *con_arg),
                        void *con_arg);
 
+#if MYNEWT_VAL(CONFIG_FCB_HASH_ENTRIES) > 0
+/**
+ * Compress the oldest sector if at least dead_pct percent of it is old
+ * values. Unlike conf_fcb_compress(), the latest values are copied to the
+ * active sector, so the FCB does not move on to its scratch sector. Done
+ * after every save if CONFIG_FCB_COMPRESS_DEAD_PCT is set.
+ *
+ * @param cf FCB source to compress.
+ * @param dead_pct Percentage of the oldest sector which must be old values.
+ *
+ * @return 0 if the oldest sector was erased, OS_ENOENT if it was not worth
+ *         it, OS_ENOMEM if the latest values did not fit.
+ */
+int conf_fcb_compress_dead(struct conf_fcb *cf, int dead_pct);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
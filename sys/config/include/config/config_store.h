@@ -39,6 +39,13 @@ struct conf_store;
 typedef void (*conf_store_load_cb)(char *name, char *val, void *cb_arg);
 struct conf_store_itf {
     int (*csi_load)(struct conf_store *cs, conf_store_load_cb cb, void *cb_arg);
+    /*
+     * Optional. Calls cb for the latest value of name only, if the store
+     * has one. Returns non-zero if the store cannot look up single values,
+     * in which case csi_load() is used instead.
+     */
+    int (*csi_load_one)(struct conf_store *cs, const char *name,
+                        conf_store_load_cb cb, void *cb_arg);
     int (*csi_save_start)(struct conf_store *cs);
     int (*csi_save)(struct conf_store *cs, const char *name, const char *value);
     int (*csi_save_end)(struct conf_store *cs);
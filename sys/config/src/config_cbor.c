@@ -0,0 +1,220 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "os/mynewt.h"
+
+#if MYNEWT_VAL(CONFIG_CBOR)
+
+#include <stdio.h>
+#include <string.h>
+
+#include <base64/base64.h>
+#include <tinycbor/cbor.h>
+#include <tinycbor/cbor_buf_reader.h>
+#include <tinycbor/cbor_buf_writer.h>
+
+#include "config/config.h"
+#include "config_priv.h"
+
+/*
+ * A CBOR record is an array of the name, as a text string, and the value.
+ * Values are kept as the most compact type they convert back from exactly:
+ * null for an empty value, an integer for decimal numbers, a byte string
+ * for base64 (as produced by conf_str_from_bytes()), else a text string.
+ */
+
+#define CONF_CBOR_INT_DIGITS	18	/* fits in int64_t */
+
+static int
+conf_cbor_str_to_int(const char *str, int64_t *result)
+{
+    const char *cp;
+    int64_t val;
+    int neg;
+
+    neg = (*str == '-');
+    cp = str + neg;
+
+    /* Only strings which are printed back the same way. */
+    if (*cp < '1' || *cp > '9') {
+        if (!neg && cp[0] == '0' && cp[1] == '\0') {
+            *result = 0;
+            return 1;
+        }
+        return 0;
+    }
+    val = 0;
+    for (; *cp; cp++) {
+        if (*cp < '0' || *cp > '9' || cp - str - neg >= CONF_CBOR_INT_DIGITS) {
+            return 0;
+        }
+        val = val * 10 + (*cp - '0');
+    }
+    *result = neg ? -val : val;
+    return 1;
+}
+
+static int
+conf_cbor_str_to_bytes(const char *str, uint8_t *bytes, int len)
+{
+    char enc[CONF_MAX_VAL_LEN + 1];
+    int slen;
+    int i;
+
+    slen = strlen(str);
+    if (slen == 0 || slen % 4 || slen >= sizeof(enc) ||
+        base64_decode_len(str) > len) {
+        return -1;
+    }
+    for (i = 0; i < slen; i++) {
+        if (!strchr("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                    "0123456789+/=", str[i])) {
+            return -1;
+        }
+    }
+    len = base64_decode(str, bytes);
+    if (len < 0) {
+        return -1;
+    }
+
+    /* Only strings which are printed back the same way. */
+    base64_encode(bytes, len, enc, 1);
+    if (strcmp(enc, str)) {
+        return -1;
+    }
+    return len;
+}
+
+int
+conf_cbor_make(char *dst, int dlen, const char *name, const char *value)
+{
+    struct cbor_buf_writer writer;
+    struct CborEncoder encoder;
+    struct CborEncoder rec;
+    uint8_t bytes[CONF_MAX_VAL_LEN * 3 / 4];
+    int64_t ival;
+    int len;
+    int rc;
+
+    cbor_buf_writer_init(&writer, (uint8_t *)dst, dlen);
+    cbor_encoder_init(&encoder, &writer.enc, 0);
+
+    rc = cbor_encoder_create_array(&encoder, &rec, 2);
+    rc |= cbor_encode_text_stringz(&rec, name);
+    if (!value || value[0] == '\0') {
+        rc |= cbor_encode_null(&rec);
+    } else if (conf_cbor_str_to_int(value, &ival)) {
+        rc |= cbor_encode_int(&rec, ival);
+    } else if ((len = conf_cbor_str_to_bytes(value, bytes,
+                                             sizeof(bytes))) > 0) {
+        rc |= cbor_encode_byte_string(&rec, bytes, len);
+    } else {
+        rc |= cbor_encode_text_stringz(&rec, value);
+    }
+    rc |= cbor_encoder_close_container(&encoder, &rec);
+    if (rc) {
+        return -1;
+    }
+    return cbor_buf_writer_buffer_size(&writer, (uint8_t *)dst);
+}
+
+int
+conf_cbor_len(const char *buf, int len)
+{
+    struct cbor_buf_reader reader;
+    struct CborParser parser;
+    struct CborValue value;
+
+    cbor_buf_reader_init(&reader, (const uint8_t *)buf, len);
+    if (cbor_parser_init(&reader.r, 0, &parser, &value) ||
+        !cbor_value_is_array(&value) || cbor_value_advance(&value)) {
+        return -1;
+    }
+    return value.offset;
+}
+
+int
+conf_cbor_parse(char *buf, int len, int blen, char **namep, char **valp)
+{
+    struct cbor_buf_reader reader;
+    struct CborParser parser;
+    struct CborValue value;
+    struct CborValue rec;
+    char out[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
+    uint8_t bytes[CONF_MAX_VAL_LEN * 3 / 4];
+    size_t name_len;
+    size_t val_len;
+    int64_t ival;
+    char *val;
+    int off;
+
+    cbor_buf_reader_init(&reader, (const uint8_t *)buf, len);
+    if (cbor_parser_init(&reader.r, 0, &parser, &value) ||
+        !cbor_value_is_array(&value) ||
+        cbor_value_enter_container(&value, &rec) ||
+        !cbor_value_is_text_string(&rec)) {
+        return -1;
+    }
+    name_len = CONF_MAX_NAME_LEN;
+    if (cbor_value_copy_text_string(&rec, out, &name_len, &rec)) {
+        return -1;
+    }
+    out[name_len] = '\0';
+    off = name_len + 1;
+    val = out + off;
+
+    switch (cbor_value_get_type(&rec)) {
+    case CborNullType:
+        val = NULL;
+        break;
+    case CborIntegerType:
+        cbor_value_get_int64(&rec, &ival);
+        off += snprintf(val, sizeof(out) - off, "%lld", (long long)ival);
+        break;
+    case CborByteStringType:
+        val_len = sizeof(bytes);
+        if (cbor_value_copy_byte_string(&rec, bytes, &val_len, NULL) ||
+            BASE64_ENCODE_SIZE(val_len) >= sizeof(out) - off) {
+            return -1;
+        }
+        off += base64_encode(bytes, val_len, val, 1);
+        break;
+    case CborTextStringType:
+        val_len = sizeof(out) - off - 1;
+        if (cbor_value_copy_text_string(&rec, val, &val_len, NULL)) {
+            return -1;
+        }
+        val[val_len] = '\0';
+        off += val_len;
+        break;
+    default:
+        return -1;
+    }
+    off++;
+
+    if (off > blen) {
+        return -1;
+    }
+    memcpy(buf, out, off);
+    *namep = buf;
+    *valp = val ? buf + (val - out) : NULL;
+    return 0;
+}
+
+#endif
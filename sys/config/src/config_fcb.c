@@ -32,6 +32,8 @@
 
 #define CONF_FCB_VERS		1
 
+#define CONF_FCB_HASH_CNT	MYNEWT_VAL(CONFIG_FCB_HASH_ENTRIES)
+
 struct conf_fcb_load_cb_arg {
     conf_store_load_cb cb;
     void *cb_arg;
@@ -47,9 +49,17 @@ static int conf_fcb_load(struct conf_store *, conf_store_load_cb cb,
                          void *cb_arg);
 static int conf_fcb_save(struct conf_store *, const char *name,
                          const char *value);
+#if CONF_FCB_HASH_CNT > 0
+static int conf_fcb_load_one(struct conf_store *, const char *name,
+                             conf_store_load_cb cb, void *cb_arg);
+static void conf_fcb_hash_build(struct conf_fcb *cf);
+#endif
 
 static struct conf_store_itf conf_fcb_itf = {
     .csi_load = conf_fcb_load,
+#if CONF_FCB_HASH_CNT > 0
+    .csi_load_one = conf_fcb_load_one,
+#endif
     .csi_save = conf_fcb_save,
 };
 
@@ -83,6 +93,10 @@ conf_fcb_src(struct conf_fcb *cf)
         }
     }
 
+#if CONF_FCB_HASH_CNT > 0
+    conf_fcb_hash_build(cf);
+#endif
+
     cf->cf_store.cs_itf = &conf_fcb_itf;
     conf_src_register(&cf->cf_store);
 
@@ -98,6 +112,238 @@ conf_fcb_dst(struct conf_fcb *cf)
     return OS_OK;
 }
 
+/*
+ * buf must be CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32 bytes.
+ */
+static int
+conf_fcb_var_read(struct fcb_entry *loc, char *buf, char **name, char **val)
+{
+    int blen;
+    int rc;
+
+    blen = CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32;
+    if (loc->fe_data_len >= blen) {
+        return OS_EINVAL;
+    }
+    rc = flash_area_read(loc->fe_area, loc->fe_data_off, buf, loc->fe_data_len);
+    if (rc) {
+        return rc;
+    }
+    rc = conf_record_parse(buf, loc->fe_data_len, blen, name, val);
+    return rc;
+}
+
+#if CONF_FCB_HASH_CNT > 0
+/*
+ * Each name seen in the FCB has a slot in cf_hash, found by open addressing
+ * on a hash of the name, pointing to the latest entry for it. Slots are
+ * told apart by reading the name from flash, so a lookup costs one read.
+ */
+static uint32_t
+conf_fcb_name_hash(const char *name)
+{
+    uint32_t hash;
+
+    /* FNV-1a. */
+    hash = 2166136261UL;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619UL;
+    }
+
+    /* 0 marks a free slot. */
+    if (hash == 0) {
+        hash = 1;
+    }
+    return hash;
+}
+
+static void
+conf_fcb_hash_loc(struct conf_fcb *cf, struct conf_fcb_hash_entry *cfh,
+                  struct fcb_entry *loc)
+{
+    loc->fe_area = &cf->cf_fcb.f_sectors[cfh->cfh_sector];
+    loc->fe_elem_off = 0;
+    loc->fe_data_off = cfh->cfh_data_off;
+    loc->fe_data_len = cfh->cfh_data_len;
+}
+
+static int
+conf_fcb_hash_match(struct conf_fcb *cf, struct conf_fcb_hash_entry *cfh,
+                    const char *name, int name_len)
+{
+    char buf[CONF_MAX_NAME_LEN + 3];
+    int len;
+    int rc;
+
+    /* Enough for the name and what comes before or after it. */
+    len = min(cfh->cfh_data_len, name_len + 3);
+    rc = flash_area_read(&cf->cf_fcb.f_sectors[cfh->cfh_sector],
+                         cfh->cfh_data_off, buf, len);
+    if (rc) {
+        return 0;
+    }
+    return conf_record_name_is(buf, len, name, name_len);
+}
+
+/*
+ * Returns the slot holding name, or the free slot where it would go. NULL
+ * if name is not there and the table is full, or if name is too long.
+ */
+static struct conf_fcb_hash_entry *
+conf_fcb_hash_find(struct conf_fcb *cf, const char *name, uint32_t hash)
+{
+    struct conf_fcb_hash_entry *cfh;
+    int name_len;
+    int i;
+
+    name_len = strlen(name);
+    if (name_len > CONF_MAX_NAME_LEN) {
+        return NULL;
+    }
+    for (i = 0; i < CONF_FCB_HASH_CNT; i++) {
+        cfh = &cf->cf_hash[(hash + i) % CONF_FCB_HASH_CNT];
+        if (cfh->cfh_hash == 0) {
+            return cfh;
+        }
+        if (cfh->cfh_hash == hash &&
+            conf_fcb_hash_match(cf, cfh, name, name_len)) {
+            return cfh;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Records loc as the latest entry for name.
+ */
+static void
+conf_fcb_hash_add(struct conf_fcb *cf, const char *name,
+                  struct fcb_entry *loc)
+{
+    struct conf_fcb_hash_entry *cfh;
+    uint32_t hash;
+
+    if (!cf->cf_hash_ok) {
+        return;
+    }
+    hash = conf_fcb_name_hash(name);
+    cfh = conf_fcb_hash_find(cf, name, hash);
+    if (!cfh) {
+        /* Can't keep track of name; fall back to walking the FCB. */
+        cf->cf_hash_ok = 0;
+        return;
+    }
+    cfh->cfh_hash = hash;
+    cfh->cfh_data_off = loc->fe_data_off;
+    cfh->cfh_data_len = loc->fe_data_len;
+    cfh->cfh_sector = loc->fe_area - cf->cf_fcb.f_sectors;
+}
+
+static int
+conf_fcb_hash_is_latest(struct conf_fcb *cf, const char *name,
+                        struct fcb_entry *loc)
+{
+    struct conf_fcb_hash_entry *cfh;
+
+    cfh = conf_fcb_hash_find(cf, name, conf_fcb_name_hash(name));
+    return cfh && cfh->cfh_hash &&
+      &cf->cf_fcb.f_sectors[cfh->cfh_sector] == loc->fe_area &&
+      cfh->cfh_data_off == loc->fe_data_off;
+}
+
+static int
+conf_fcb_hash_build_cb(struct fcb_entry *loc, void *arg)
+{
+    struct conf_fcb *cf = (struct conf_fcb *)arg;
+    char buf[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
+    char *name_str;
+    char *val_str;
+    int rc;
+
+    rc = conf_fcb_var_read(loc, buf, &name_str, &val_str);
+    if (rc) {
+        return 0;
+    }
+    conf_fcb_hash_add(cf, name_str, loc);
+    return 0;
+}
+
+static void
+conf_fcb_hash_build(struct conf_fcb *cf)
+{
+    memset(cf->cf_hash, 0, sizeof(cf->cf_hash));
+    cf->cf_hash_ok = 1;
+
+    fcb_walk(&cf->cf_fcb, 0, conf_fcb_hash_build_cb, cf);
+}
+
+static void
+conf_fcb_hash_load(struct conf_fcb *cf, struct conf_fcb_hash_entry *cfh,
+                   conf_store_load_cb cb, void *cb_arg)
+{
+    char buf[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
+    struct fcb_entry loc;
+    char *name_str;
+    char *val_str;
+    int rc;
+
+    conf_fcb_hash_loc(cf, cfh, &loc);
+    rc = conf_fcb_var_read(&loc, buf, &name_str, &val_str);
+    if (rc) {
+        return;
+    }
+    cb(name_str, val_str, cb_arg);
+}
+
+static int
+conf_fcb_load_one(struct conf_store *cs, const char *name,
+                  conf_store_load_cb cb, void *cb_arg)
+{
+    struct conf_fcb *cf = (struct conf_fcb *)cs;
+    struct conf_fcb_hash_entry *cfh;
+
+    if (!cf->cf_hash_ok) {
+        return OS_ENOENT;
+    }
+    cfh = conf_fcb_hash_find(cf, name, conf_fcb_name_hash(name));
+    if (cfh && cfh->cfh_hash) {
+        conf_fcb_hash_load(cf, cfh, cb, cb_arg);
+    }
+    return OS_OK;
+}
+
+/*
+ * Compressing early is worth it once enough of the oldest sector is old
+ * values. It copies the latest ones to the active sector rather than to
+ * scratch, so there must be a free sector left for them to spill into;
+ * otherwise the FCB is nearly full and the next save compresses anyway.
+ */
+static int
+conf_fcb_need_compress(struct conf_fcb *cf, int dead_pct)
+{
+    struct fcb *fcb = &cf->cf_fcb;
+    uint32_t live;
+    int sector;
+    int i;
+
+    if (!cf->cf_hash_ok || fcb->f_oldest == fcb->f_active.fe_area ||
+        fcb_free_sector_cnt(fcb) <= fcb->f_scratch_cnt) {
+        return 0;
+    }
+
+    sector = fcb->f_oldest - fcb->f_sectors;
+    live = 0;
+    for (i = 0; i < CONF_FCB_HASH_CNT; i++) {
+        if (cf->cf_hash[i].cfh_hash && cf->cf_hash[i].cfh_sector == sector) {
+            live += cf->cf_hash[i].cfh_data_len;
+        }
+    }
+    return (uint64_t)(fcb->f_oldest->fa_size - live) * 100 >=
+      (uint64_t)fcb->f_oldest->fa_size * dead_pct;
+}
+#endif
+
 static int
 conf_fcb_load_cb(struct fcb_entry *loc, void *arg)
 {
@@ -119,9 +365,7 @@ conf_fcb_load_cb(struct fcb_entry *loc, void *arg)
     if (rc) {
         return 0;
     }
-    buf[len] = '\0';
-
-    rc = conf_line_parse(buf, &name_str, &val_str);
+    rc = conf_record_parse(buf, len, sizeof(buf), &name_str, &val_str);
     if (rc) {
         return 0;
     }
@@ -135,6 +379,21 @@ conf_fcb_load(struct conf_store *cs, conf_store_load_cb cb, void *cb_arg)
     struct conf_fcb *cf = (struct conf_fcb *)cs;
     struct conf_fcb_load_cb_arg arg;
     int rc;
+#if CONF_FCB_HASH_CNT > 0
+    int i;
+#endif
+
+#if CONF_FCB_HASH_CNT > 0
+    if (cf->cf_hash_ok) {
+        /* Only the latest value of each name needs to be read. */
+        for (i = 0; i < CONF_FCB_HASH_CNT; i++) {
+            if (cf->cf_hash[i].cfh_hash) {
+                conf_fcb_hash_load(cf, &cf->cf_hash[i], cb, cb_arg);
+            }
+        }
+        return OS_OK;
+    }
+#endif
 
     arg.cb = cb;
     arg.cb_arg = cb_arg;
@@ -145,22 +404,14 @@ conf_fcb_load(struct conf_store *cs, conf_store_load_cb cb, void *cb_arg)
     return OS_OK;
 }
 
-static int
-conf_fcb_var_read(struct fcb_entry *loc, char *buf, char **name, char **val)
-{
-    int rc;
-
-    rc = flash_area_read(loc->fe_area, loc->fe_data_off, buf, loc->fe_data_len);
-    if (rc) {
-        return rc;
-    }
-    buf[loc->fe_data_len] = '\0';
-    rc = conf_line_parse(buf, name, val);
-    return rc;
-}
-
+/*
+ * cf is NULL when fcb is a generic key-value store. If to_scratch is 0,
+ * values are copied to the active sector instead of starting on the
+ * scratch sector, and the oldest sector is kept if they do not fit.
+ */
 static void
-conf_fcb_compress_internal(struct fcb *fcb,
+conf_fcb_compress_internal(struct fcb *fcb, struct conf_fcb *cf,
+                           int to_scratch,
                            int (*copy_or_not)(const char *name, const char *val,
                                               void *cn_arg),
                            void *cn_arg)
@@ -172,11 +423,17 @@ conf_fcb_compress_internal(struct fcb *fcb,
     struct fcb_entry loc2;
     char *name1, *val1;
     char *name2, *val2;
+    char *rec;
+    int len;
     int copy;
+    int copy_failed;
 
-    rc = fcb_append_to_scratch(fcb);
-    if (rc) {
-        return; /* XXX */
+    copy_failed = 0;
+    if (to_scratch) {
+        rc = fcb_append_to_scratch(fcb);
+        if (rc) {
+            return; /* XXX */
+        }
     }
 
     loc1.fe_area = NULL;
@@ -192,16 +449,23 @@ conf_fcb_compress_internal(struct fcb *fcb,
         if (!val1) {
             continue;
         }
-        loc2 = loc1;
-        copy = 1;
-        while (fcb_getnext(fcb, &loc2) == 0) {
-            rc = conf_fcb_var_read(&loc2, buf2, &name2, &val2);
-            if (rc) {
-                continue;
-            }
-            if (!strcmp(name1, name2)) {
-                copy = 0;
-                break;
+#if CONF_FCB_HASH_CNT > 0
+        if (cf && cf->cf_hash_ok) {
+            copy = conf_fcb_hash_is_latest(cf, name1, &loc1);
+        } else
+#endif
+        {
+            loc2 = loc1;
+            copy = 1;
+            while (fcb_getnext(fcb, &loc2) == 0) {
+                rc = conf_fcb_var_read(&loc2, buf2, &name2, &val2);
+                if (rc) {
+                    continue;
+                }
+                if (!strcmp(name1, name2)) {
+                    copy = 0;
+                    break;
+                }
             }
         }
         if (!copy) {
@@ -217,31 +481,54 @@ conf_fcb_compress_internal(struct fcb *fcb,
         /*
          * Can't find one. Must copy.
          */
-        rc = flash_area_read(loc1.fe_area, loc1.fe_data_off, buf1,
-          loc1.fe_data_len);
+#if MYNEWT_VAL(CONFIG_CBOR)
+        /* Text records are rewritten as CBOR on the way. */
+        rec = buf2;
+        len = conf_cbor_make(rec, sizeof(buf2), name1, val1);
+        if (len < 0) {
+            continue;
+        }
+#else
+        rec = buf1;
+        len = loc1.fe_data_len;
+        rc = flash_area_read(loc1.fe_area, loc1.fe_data_off, rec, len);
         if (rc) {
             continue;
         }
-        rc = fcb_append(fcb, loc1.fe_data_len, &loc2);
+#endif
+        rc = fcb_append(fcb, len, &loc2);
         if (rc) {
+            copy_failed = 1;
             continue;
         }
-        rc = flash_area_write(loc2.fe_area, loc2.fe_data_off, buf1,
-          loc1.fe_data_len);
+        rc = flash_area_write(loc2.fe_area, loc2.fe_data_off, rec, len);
         if (rc) {
+            copy_failed = 1;
             continue;
         }
         fcb_append_finish(fcb, &loc2);
     }
-    rc = fcb_rotate(fcb);
-    if (rc) {
-        /* XXXX */
-        ;
+
+    /* When not short of space, keep values which could not be copied. */
+    if (to_scratch || !copy_failed) {
+        rc = fcb_rotate(fcb);
+        if (rc) {
+            /* XXXX */
+            ;
+        }
     }
+
+#if CONF_FCB_HASH_CNT > 0
+    /* Entries have moved; find them again. */
+    if (cf) {
+        conf_fcb_hash_build(cf);
+    }
+#endif
 }
 
 static int
-conf_fcb_append(struct fcb *fcb, char *buf, int len)
+conf_fcb_append(struct fcb *fcb, struct conf_fcb *cf, const char *name,
+                char *buf, int len)
 {
     int rc;
     int i;
@@ -255,7 +542,7 @@ conf_fcb_append(struct fcb *fcb, char *buf, int len)
         if (fcb->f_scratch_cnt == 0) {
             return OS_ENOMEM;
         }
-        conf_fcb_compress_internal(fcb, NULL, NULL);
+        conf_fcb_compress_internal(fcb, cf, 1, NULL, NULL);
     }
     if (rc) {
         return OS_EINVAL;
@@ -265,15 +552,48 @@ conf_fcb_append(struct fcb *fcb, char *buf, int len)
         return OS_EINVAL;
     }
     fcb_append_finish(fcb, &loc);
+
+#if CONF_FCB_HASH_CNT > 0
+    if (cf) {
+        conf_fcb_hash_add(cf, name, &loc);
+    }
+#else
+    (void)name;
+#endif
     return OS_OK;
 }
 
+static int
+conf_fcb_save_internal(struct fcb *fcb, struct conf_fcb *cf,
+                       const char *name, const char *value)
+{
+    char buf[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
+    int len;
+
+    if (!name) {
+        return OS_INVALID_PARM;
+    }
+
+    len = conf_record_make(buf, sizeof(buf), name, value);
+    if (len < 0 || len + 2 > sizeof(buf)) {
+        return OS_INVALID_PARM;
+    }
+    return conf_fcb_append(fcb, cf, name, buf, len);
+}
+
 static int
 conf_fcb_save(struct conf_store *cs, const char *name, const char *value)
 {
     struct conf_fcb *cf = (struct conf_fcb *)cs;
+    int rc;
 
-    return conf_fcb_kv_save(&cf->cf_fcb, name, value);
+    rc = conf_fcb_save_internal(&cf->cf_fcb, cf, name, value);
+#if CONF_FCB_HASH_CNT > 0 && MYNEWT_VAL(CONFIG_FCB_COMPRESS_DEAD_PCT) > 0
+    if (rc == 0) {
+        conf_fcb_compress_dead(cf, MYNEWT_VAL(CONFIG_FCB_COMPRESS_DEAD_PCT));
+    }
+#endif
+    return rc;
 }
 
 void
@@ -282,9 +602,27 @@ conf_fcb_compress(struct conf_fcb *cf,
                                      void *cn_arg),
                   void *cn_arg)
 {
-    conf_fcb_compress_internal(&cf->cf_fcb, copy_or_not, cn_arg);
+    conf_fcb_compress_internal(&cf->cf_fcb, cf, 1, copy_or_not, cn_arg);
 }
 
+#if CONF_FCB_HASH_CNT > 0
+int
+conf_fcb_compress_dead(struct conf_fcb *cf, int dead_pct)
+{
+    struct flash_area *oldest;
+
+    if (!conf_fcb_need_compress(cf, dead_pct)) {
+        return OS_ENOENT;
+    }
+    oldest = cf->cf_fcb.f_oldest;
+    conf_fcb_compress_internal(&cf->cf_fcb, cf, 0, NULL, NULL);
+    if (cf->cf_fcb.f_oldest == oldest) {
+        return OS_ENOMEM;
+    }
+    return OS_OK;
+}
+#endif
+
 static int
 conf_kv_load_cb(struct fcb_entry *loc, void *arg)
 {
@@ -304,9 +642,7 @@ conf_kv_load_cb(struct fcb_entry *loc, void *arg)
     if (rc) {
         return 0;
     }
-    buf[len] = '\0';
-
-    rc = conf_line_parse(buf, &name_str, &val_str);
+    rc = conf_record_parse(buf, len, sizeof(buf), &name_str, &val_str);
     if (rc) {
         return 0;
     }
@@ -315,6 +651,11 @@ conf_kv_load_cb(struct fcb_entry *loc, void *arg)
         return 0;
     }
 
+    if (!val_str) {
+        cb_arg->value[0] = '\0';
+        return 0;
+    }
+
     strncpy(cb_arg->value, val_str, cb_arg->len);
     cb_arg->value[cb_arg->len - 1] = '\0';
 
@@ -342,18 +683,7 @@ conf_fcb_kv_load(struct fcb *fcb, const char *name, char *value, size_t len)
 int
 conf_fcb_kv_save(struct fcb *fcb, const char *name, const char *value)
 {
-    char buf[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
-    int len;
-
-    if (!name) {
-        return OS_INVALID_PARM;
-    }
-
-    len = conf_line_make(buf, sizeof(buf), name, value);
-    if (len < 0 || len + 2 > sizeof(buf)) {
-        return OS_INVALID_PARM;
-    }
-    return conf_fcb_append(fcb, buf, len);
+    return conf_fcb_save_internal(fcb, NULL, name, value);
 }
 
 #endif
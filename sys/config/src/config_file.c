@@ -89,6 +89,19 @@ conf_getnext_line(struct fs_file *file, char *buf, int blen, uint32_t *loc)
     }
     buf[len] = '\0';
 
+#if MYNEWT_VAL(CONFIG_CBOR)
+    if (CONF_RECORD_IS_CBOR(buf)) {
+        /* CBOR records are not followed by a newline. */
+        blen = conf_cbor_len(buf, len);
+        if (blen < 0) {
+            *loc = 0;
+            return -1;
+        }
+        *loc += blen;
+        return blen;
+    }
+#endif
+
     end = strchr(buf, '\n');
     if (end) {
         *end = '\0';
@@ -131,7 +144,8 @@ conf_file_load(struct conf_store *cs, conf_store_load_cb cb, void *cb_arg)
         if (rc < 0) {
             continue;
         }
-        rc = conf_line_parse(tmpbuf, &name_str, &val_str);
+        rc = conf_record_parse(tmpbuf, rc, sizeof(tmpbuf), &name_str,
+                               &val_str);
         if (rc != 0) {
             continue;
         }
@@ -194,7 +208,7 @@ conf_file_compress(struct conf_file *cf)
         if (loc1 == 0 || len < 0) {
             break;
         }
-        rc = conf_line_parse(buf1, &name1, &val1);
+        rc = conf_record_parse(buf1, len, sizeof(buf1), &name1, &val1);
         if (rc) {
             continue;
         }
@@ -204,7 +218,7 @@ conf_file_compress(struct conf_file *cf)
         loc2 = loc1;
         copy = 1;
         while ((len2 = conf_getnext_line(rf, buf2, sizeof(buf2), &loc2)) > 0) {
-            rc = conf_line_parse(buf2, &name2, &val2);
+            rc = conf_record_parse(buf2, len2, sizeof(buf2), &name2, &val2);
             if (rc) {
                 continue;
             }
@@ -218,13 +232,16 @@ conf_file_compress(struct conf_file *cf)
         }
 
         /*
-         * Can't find one. Must copy.
+         * Can't find one. Must copy. Text lines are rewritten as CBOR
+         * records if those are in use.
          */
-        len = conf_line_make(buf2, sizeof(buf2), name1, val1);
+        len = conf_record_make(buf2, sizeof(buf2), name1, val1);
         if (len < 0 || len + 2 > sizeof(buf2)) {
             continue;
         }
-        buf2[len++] = '\n';
+        if (!CONF_RECORD_IS_CBOR(buf2)) {
+            buf2[len++] = '\n';
+        }
         fs_write(wf, buf2, len);
 	lines++;
     }
@@ -261,11 +278,13 @@ conf_file_save(struct conf_store *cs, const char *name, const char *value)
          */
         conf_file_compress(cf);
     }
-    len = conf_line_make(buf, sizeof(buf), name, value);
+    len = conf_record_make(buf, sizeof(buf), name, value);
     if (len < 0 || len + 2 > sizeof(buf)) {
         return OS_INVALID_PARM;
     }
-    buf[len++] = '\n';
+    if (!CONF_RECORD_IS_CBOR(buf)) {
+        buf[len++] = '\n';
+    }
 
     /*
      * Open the file to add this one value.
@@ -20,6 +20,7 @@
 #include <ctype.h>
 #include <string.h>
 
+#include "os/mynewt.h"
 #include "config/config.h"
 #include "config_priv.h"
 
@@ -97,3 +98,62 @@ conf_line_make(char *dst, int dlen, const char *name, const char *value)
 
     return off;
 }
+
+int
+conf_record_make(char *dst, int dlen, const char *name, const char *value)
+{
+#if MYNEWT_VAL(CONFIG_CBOR)
+    return conf_cbor_make(dst, dlen, name, value);
+#else
+    return conf_line_make(dst, dlen, name, value);
+#endif
+}
+
+/*
+ * Parses a record of len bytes in a buffer of blen bytes. Name and value
+ * are returned pointing into buf.
+ */
+int
+conf_record_parse(char *buf, int len, int blen, char **namep, char **valp)
+{
+    if (len >= blen) {
+        return -1;
+    }
+#if MYNEWT_VAL(CONFIG_CBOR)
+    if (CONF_RECORD_IS_CBOR(buf)) {
+        return conf_cbor_parse(buf, len, blen, namep, valp);
+    }
+#endif
+    buf[len] = '\0';
+    return conf_line_parse(buf, namep, valp);
+}
+
+/*
+ * Checks whether the record starting with the len bytes in rec is for
+ * name.
+ */
+int
+conf_record_name_is(const char *rec, int len, const char *name, int name_len)
+{
+#if MYNEWT_VAL(CONFIG_CBOR)
+    int hdr_len;
+
+    if (len > 0 && CONF_RECORD_IS_CBOR(rec)) {
+        /* Array header, text string header, name. */
+        hdr_len = name_len < 24 ? 2 : 3;
+        if (name_len > 0xff || len < hdr_len + name_len) {
+            return 0;
+        }
+        if (name_len < 24) {
+            if ((uint8_t)rec[1] != (0x60 | name_len)) {
+                return 0;
+            }
+        } else if ((uint8_t)rec[1] != 0x78 || (uint8_t)rec[2] != name_len) {
+            return 0;
+        }
+        return !memcmp(rec + hdr_len, name, name_len);
+    }
+#endif
+    return len > name_len && !memcmp(rec, name, name_len) &&
+      rec[name_len] == '=';
+}
@@ -20,6 +20,8 @@
 #ifndef __CONFIG_PRIV_H_
 #define __CONFIG_PRIV_H_
 
+#include "os/mynewt.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -37,6 +39,25 @@ struct mgmt_cbuf;
 int conf_line_parse(char *buf, char **namep, char **valp);
 int conf_line_make(char *dst, int dlen, const char *name, const char *val);
 int conf_line_make2(char *dst, int dlen, const char *name, const char *value);
+
+/*
+ * Records as persisted by the FCB and file backends; text lines, or with
+ * CONFIG_CBOR, CBOR records. Both kinds are read.
+ */
+#if MYNEWT_VAL(CONFIG_CBOR)
+#define CONF_CBOR_RECORD        0x82    /* CBOR array of name and value */
+#define CONF_RECORD_IS_CBOR(buf) ((uint8_t)(buf)[0] == CONF_CBOR_RECORD)
+
+int conf_cbor_make(char *dst, int dlen, const char *name, const char *value);
+int conf_cbor_parse(char *buf, int len, int blen, char **namep, char **valp);
+int conf_cbor_len(const char *buf, int len);
+#else
+#define CONF_RECORD_IS_CBOR(buf) 0
+#endif
+int conf_record_make(char *dst, int dlen, const char *name, const char *value);
+int conf_record_parse(char *buf, int len, int blen, char **namep, char **valp);
+int conf_record_name_is(const char *rec, int len, const char *name,
+                        int name_len);
 struct conf_handler *conf_parse_and_lookup(char *name, int *name_argc,
                                            char *name_argv[]);
 
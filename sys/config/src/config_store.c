@@ -151,7 +151,10 @@ conf_save_one(const char *name, char *value)
     cdca.val = value;
     cdca.is_dup = 0;
     SLIST_FOREACH(cs, &conf_load_srcs, cs_next) {
-        cs->cs_itf->csi_load(cs, conf_dup_check_cb, &cdca);
+        if (!cs->cs_itf->csi_load_one ||
+            cs->cs_itf->csi_load_one(cs, name, conf_dup_check_cb, &cdca)) {
+            cs->cs_itf->csi_load(cs, conf_dup_check_cb, &cdca);
+        }
     }
     if (cdca.is_dup == 1) {
         rc = 0;
@@ -333,6 +333,9 @@ TEST_CASE_DECL(config_test_save_3_fcb)
 TEST_CASE_DECL(config_test_compress_reset)
 TEST_CASE_DECL(config_test_save_one_fcb)
 TEST_CASE_DECL(config_test_custom_compress)
+TEST_CASE_DECL(config_test_fcb_hash)
+TEST_CASE_DECL(config_test_fcb_dead_pct)
+TEST_CASE_DECL(config_test_cbor_fcb)
 
 TEST_SUITE(config_test_all)
 {
@@ -361,10 +364,15 @@ TEST_SUITE(config_test_all)
     config_test_insert3();
     config_test_save_3_fcb();
 
+#if !CONF_TEST_FCB_AUTO_COMPRESS
     config_test_compress_reset();
     config_test_custom_compress();
+#endif
 
     config_test_save_one_fcb();
+    config_test_fcb_hash();
+    config_test_fcb_dead_pct();
+    config_test_cbor_fcb();
 }
 
 #if MYNEWT_VAL(SELFTEST)
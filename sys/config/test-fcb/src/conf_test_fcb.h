@@ -44,6 +44,14 @@ extern char val_string[CONF_TEST_FCB_VAL_STR_CNT][CONF_MAX_VAL_LEN];
 
 extern struct flash_area fcb_areas[CONF_TEST_FCB_FLASH_CNT];
 
+/*
+ * Saves compress the FCB as old values pile up, so it never fills up and
+ * the tests which depend on it filling up are skipped.
+ */
+#define CONF_TEST_FCB_AUTO_COMPRESS                     \
+    (MYNEWT_VAL(CONFIG_FCB_HASH_ENTRIES) > 0 &&         \
+     MYNEWT_VAL(CONFIG_FCB_COMPRESS_DEAD_PCT) > 0)
+
 extern uint32_t val32;
 extern uint64_t val64;
 
@@ -0,0 +1,153 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "conf_test_fcb.h"
+
+#if MYNEWT_VAL(CONFIG_CBOR)
+static void
+config_test_cbor_open(struct conf_fcb *cf)
+{
+    int rc;
+
+    config_wipe_srcs();
+
+    cf->cf_fcb.f_magic = MYNEWT_VAL(CONFIG_FCB_MAGIC);
+    cf->cf_fcb.f_sectors = fcb_areas;
+    cf->cf_fcb.f_sector_cnt = sizeof(fcb_areas) / sizeof(fcb_areas[0]);
+
+    rc = conf_fcb_src(cf);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = conf_fcb_dst(cf);
+    TEST_ASSERT_FATAL(rc == 0);
+}
+
+static void
+config_test_cbor_append_text(struct fcb *fcb, const char *line)
+{
+    struct fcb_entry loc;
+    int rc;
+
+    rc = fcb_append(fcb, strlen(line), &loc);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = flash_area_write(loc.fe_area, loc.fe_data_off, line, strlen(line));
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = fcb_append_finish(fcb, &loc);
+    TEST_ASSERT_FATAL(rc == 0);
+}
+
+static int
+config_test_cbor_cnt(struct fcb_entry *loc, void *arg)
+{
+    int *cnts = arg;
+    uint8_t byte;
+    int rc;
+
+    rc = flash_area_read(loc->fe_area, loc->fe_data_off, &byte, 1);
+    TEST_ASSERT(rc == 0);
+    cnts[byte == CONF_CBOR_RECORD]++;
+    return 0;
+}
+
+static void
+config_test_cbor_load(void)
+{
+    int rc;
+
+    val8 = 0;
+    val32 = 0;
+    val64 = 0;
+    memset(val_string, 0, sizeof(val_string));
+    rc = conf_load();
+    TEST_ASSERT(rc == 0);
+}
+#endif
+
+TEST_CASE(config_test_cbor_fcb)
+{
+#if MYNEWT_VAL(CONFIG_CBOR)
+    struct conf_fcb cf;
+    int cnts[2];
+    int rc;
+    int i;
+
+    config_wipe_fcb(fcb_areas, sizeof(fcb_areas) / sizeof(fcb_areas[0]));
+    config_test_cbor_open(&cf);
+    c2_var_count = 2;
+    test_export_block = 0;
+
+    /*
+     * Text records, as written before CBOR was enabled, are read.
+     */
+    config_test_cbor_append_text(&cf.cf_fcb, "myfoo/mybar=14");
+    config_test_cbor_append_text(&cf.cf_fcb, "myfoo/mybar64=-5000000000");
+    config_test_cbor_append_text(&cf.cf_fcb, "2nd/string0=dGV4dA==");
+    config_test_cbor_append_text(&cf.cf_fcb, "3/v=7");
+    config_test_cbor_open(&cf);
+
+    config_test_cbor_load();
+    TEST_ASSERT(val8 == 14);
+    TEST_ASSERT(val64 == (uint64_t)-5000000000LL);
+    TEST_ASSERT(!strcmp(val_string[0], "dGV4dA=="));
+    TEST_ASSERT(val32 == 7);
+
+    /*
+     * New values are written as CBOR, and read back the same.
+     */
+    val8 = 15;
+    val64 = 5000000000LL;
+    strcpy(val_string[0], "Ynl0ZXM=");
+    strcpy(val_string[1], "abc+/=");
+    rc = conf_save();
+    TEST_ASSERT(rc == 0);
+
+    config_test_cbor_load();
+    TEST_ASSERT(val8 == 15);
+    TEST_ASSERT(val64 == 5000000000LL);
+    TEST_ASSERT(!strcmp(val_string[0], "Ynl0ZXM="));
+    TEST_ASSERT(!strcmp(val_string[1], "abc+/="));
+    TEST_ASSERT(val32 == 7);
+
+    memset(cnts, 0, sizeof(cnts));
+    fcb_walk(&cf.cf_fcb, NULL, config_test_cbor_cnt, cnts);
+    TEST_ASSERT(cnts[0] == 4);
+    TEST_ASSERT(cnts[1] == 4);
+
+    /*
+     * Once compressed, only CBOR records are left.
+     */
+    for (i = 0; i < cf.cf_fcb.f_sector_cnt - 1; i++) {
+        conf_fcb_compress(&cf, NULL, NULL);
+    }
+
+    memset(cnts, 0, sizeof(cnts));
+    fcb_walk(&cf.cf_fcb, NULL, config_test_cbor_cnt, cnts);
+    TEST_ASSERT(cnts[0] == 0);
+    TEST_ASSERT(cnts[1] == 5);
+
+    config_test_cbor_open(&cf);
+    config_test_cbor_load();
+    TEST_ASSERT(val8 == 15);
+    TEST_ASSERT(val64 == 5000000000LL);
+    TEST_ASSERT(!strcmp(val_string[0], "Ynl0ZXM="));
+    TEST_ASSERT(!strcmp(val_string[1], "abc+/="));
+    TEST_ASSERT(val32 == 7);
+
+    c2_var_count = 0;
+#endif
+}
@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "conf_test_fcb.h"
+
+/*
+ * Overwrites one value until the FCB has gone round all of its sectors.
+ * Every sector the value moves out of holds only old values, so each save
+ * which starts a new sector must also erase the oldest one; the FCB never
+ * spans more than two sectors.
+ */
+TEST_CASE(config_test_fcb_dead_pct)
+{
+#if CONF_TEST_FCB_AUTO_COMPRESS
+    int rc;
+    struct conf_fcb cf;
+    struct flash_area *oldest;
+    char value[16];
+    int erased;
+    int i;
+
+    config_wipe_srcs();
+    config_wipe_fcb(fcb_areas, sizeof(fcb_areas) / sizeof(fcb_areas[0]));
+    memset(&cf, 0, sizeof(cf));
+
+    cf.cf_fcb.f_magic = MYNEWT_VAL(CONFIG_FCB_MAGIC);
+    cf.cf_fcb.f_sectors = fcb_areas;
+    cf.cf_fcb.f_sector_cnt = sizeof(fcb_areas) / sizeof(fcb_areas[0]);
+
+    rc = conf_fcb_src(&cf);
+    TEST_ASSERT(rc == 0);
+
+    rc = conf_fcb_dst(&cf);
+    TEST_ASSERT(rc == 0);
+
+    oldest = cf.cf_fcb.f_oldest;
+    erased = 0;
+    for (i = 0; erased < CONF_TEST_FCB_FLASH_CNT; i++) {
+        TEST_ASSERT_FATAL(i < 16384);
+        snprintf(value, sizeof(value), "%d", i);
+        rc = conf_save_one("3/v", value);
+        TEST_ASSERT_FATAL(rc == 0);
+
+        TEST_ASSERT_FATAL(fcb_free_sector_cnt(&cf.cf_fcb) >=
+                          CONF_TEST_FCB_FLASH_CNT - 2);
+        if (cf.cf_fcb.f_oldest != oldest) {
+            oldest = cf.cf_fcb.f_oldest;
+            erased++;
+        }
+    }
+
+    /*
+     * Latest value is found after a reboot.
+     */
+    config_wipe_srcs();
+    memset(&cf, 0, sizeof(cf));
+
+    cf.cf_fcb.f_magic = MYNEWT_VAL(CONFIG_FCB_MAGIC);
+    cf.cf_fcb.f_sectors = fcb_areas;
+    cf.cf_fcb.f_sector_cnt = sizeof(fcb_areas) / sizeof(fcb_areas[0]);
+
+    rc = conf_fcb_src(&cf);
+    TEST_ASSERT(rc == 0);
+
+    rc = conf_fcb_dst(&cf);
+    TEST_ASSERT(rc == 0);
+
+    val32 = 0;
+    rc = conf_load();
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(val32 == i - 1);
+#endif
+}
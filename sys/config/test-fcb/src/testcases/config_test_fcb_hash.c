@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "conf_test_fcb.h"
+
+TEST_CASE(config_test_fcb_hash)
+{
+    int rc;
+    struct conf_fcb cf;
+    char value[16];
+    uint32_t off;
+    int i;
+
+    config_wipe_srcs();
+    config_wipe_fcb(fcb_areas, sizeof(fcb_areas) / sizeof(fcb_areas[0]));
+
+    cf.cf_fcb.f_magic = MYNEWT_VAL(CONFIG_FCB_MAGIC);
+    cf.cf_fcb.f_sectors = fcb_areas;
+    cf.cf_fcb.f_sector_cnt = sizeof(fcb_areas) / sizeof(fcb_areas[0]);
+
+    rc = conf_fcb_src(&cf);
+    TEST_ASSERT(rc == 0);
+
+    rc = conf_fcb_dst(&cf);
+    TEST_ASSERT(rc == 0);
+
+    rc = conf_save_one("3/v", "1");
+    TEST_ASSERT(rc == 0);
+
+    /*
+     * Same value again is not written.
+     */
+    off = cf.cf_fcb.f_active.fe_elem_off;
+    rc = conf_save_one("3/v", "1");
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cf.cf_fcb.f_active.fe_elem_off == off);
+
+    /*
+     * Keep overwriting the value until the second sector is started.
+     */
+    for (i = 0; cf.cf_fcb.f_active.fe_area == &fcb_areas[0]; i++) {
+        TEST_ASSERT_FATAL(i < 4096);
+        snprintf(value, sizeof(value), "%d", i);
+        rc = conf_save_one("3/v", value);
+        TEST_ASSERT(rc == 0);
+    }
+
+#if CONF_TEST_FCB_AUTO_COMPRESS
+    /*
+     * The save which started the second sector found the first one holding
+     * only old values, and erased it.
+     */
+    TEST_ASSERT(cf.cf_fcb.f_oldest == &fcb_areas[1]);
+#else
+    TEST_ASSERT(cf.cf_fcb.f_oldest == &fcb_areas[0]);
+
+#if MYNEWT_VAL(CONFIG_FCB_HASH_ENTRIES) > 0
+    /*
+     * First sector holds only old values, so it can be erased without
+     * moving on to scratch.
+     */
+    rc = conf_fcb_compress_dead(&cf, 90);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cf.cf_fcb.f_oldest == &fcb_areas[1]);
+#endif
+#endif
+
+#if MYNEWT_VAL(CONFIG_FCB_HASH_ENTRIES) > 0
+    TEST_ASSERT(cf.cf_fcb.f_active.fe_area == &fcb_areas[1]);
+    rc = conf_fcb_compress_dead(&cf, 90);
+    TEST_ASSERT(rc == OS_ENOENT);
+#endif
+
+    /*
+     * Latest value is found after a reboot.
+     */
+    config_wipe_srcs();
+    memset(&cf, 0, sizeof(cf));
+
+    cf.cf_fcb.f_magic = MYNEWT_VAL(CONFIG_FCB_MAGIC);
+    cf.cf_fcb.f_sectors = fcb_areas;
+    cf.cf_fcb.f_sector_cnt = sizeof(fcb_areas) / sizeof(fcb_areas[0]);
+
+    rc = conf_fcb_src(&cf);
+    TEST_ASSERT(rc == 0);
+
+    rc = conf_fcb_dst(&cf);
+    TEST_ASSERT(rc == 0);
+
+    val32 = 0;
+    rc = conf_load();
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(val32 == i - 1);
+
+    off = cf.cf_fcb.f_active.fe_elem_off;
+    rc = conf_save_one("3/v", value);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(cf.cf_fcb.f_active.fe_elem_off == off);
+}
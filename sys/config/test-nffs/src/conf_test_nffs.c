@@ -279,15 +279,28 @@ config_wipe_srcs(void)
     conf_save_dst = NULL;
 }
 
+/*
+ * Looks for name=value in the file, as the file backend writes it; a text
+ * line, or a CBOR record, which may contain zero bytes.
+ */
 int
-conf_test_file_strstr(const char *fname, char *string)
+conf_test_file_record(const char *fname, const char *name, const char *value)
 {
     int rc;
     uint32_t len;
     uint32_t rlen;
+    uint32_t off;
     char *buf;
+    char rec[CONF_MAX_NAME_LEN + CONF_MAX_VAL_LEN + 32];
+    int rec_len;
     struct fs_file *file;
 
+    rec_len = conf_record_make(rec, sizeof(rec) - 1, name, value);
+    TEST_ASSERT_FATAL(rec_len > 0);
+    if (!CONF_RECORD_IS_CBOR(rec)) {
+        rec[rec_len++] = '\n';
+    }
+
     rc = fs_open(fname, FS_ACCESS_READ, &file);
     if (rc) {
         return rc;
@@ -304,13 +317,16 @@ conf_test_file_strstr(const char *fname, char *string)
     rc = fsutil_read_file(fname, 0, len, buf, &rlen);
     TEST_ASSERT(rc == 0);
     TEST_ASSERT(rlen == len);
-    buf[rlen] = '\0';
 
-    if (strstr(buf, string)) {
-        return 0;
-    } else {
-        return -1;
+    rc = -1;
+    for (off = 0; off + rec_len <= rlen; off++) {
+        if (!memcmp(buf + off, rec, rec_len)) {
+            rc = 0;
+            break;
+        }
     }
+    free(buf);
+    return rc;
 }
 
 void config_test_fill_area(char test_value[64][CONF_MAX_VAL_LEN],
@@ -339,6 +355,7 @@ TEST_CASE_DECL(config_test_small_file)
 TEST_CASE_DECL(config_test_multiple_in_file)
 TEST_CASE_DECL(config_test_save_in_file)
 TEST_CASE_DECL(config_test_save_one_file)
+TEST_CASE_DECL(config_test_cbor_file)
 
 TEST_SUITE(config_test_all)
 {
@@ -365,6 +382,8 @@ TEST_SUITE(config_test_all)
     config_test_save_in_file();
 
     config_test_save_one_file();
+
+    config_test_cbor_file();
 }
 
 #if MYNEWT_VAL(SELFTEST)
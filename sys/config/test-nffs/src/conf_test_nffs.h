@@ -58,7 +58,8 @@ void ctest_clear_call_state(void);
 
 void config_wipe_srcs(void);
 
-int conf_test_file_strstr(const char *fname, char *string);
+int conf_test_file_record(const char *fname, const char *name,
+                          const char *value);
 
 char *c2_handle_get(int argc, char **argv, char *val, int val_len_max);
 int c2_handle_set(int argc, char **argv, char *val);
@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "conf_test_nffs.h"
+
+#if MYNEWT_VAL(CONFIG_CBOR)
+/*
+ * Checks that the file holds exactly the given bytes.
+ */
+static void
+config_test_cbor_file_is(const char *fname, const char *data, int len)
+{
+    char buf[128];
+    uint32_t rlen;
+    int rc;
+
+    rc = fsutil_read_file(fname, 0, sizeof(buf), buf, &rlen);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(rlen == len);
+    TEST_ASSERT(!memcmp(buf, data, len));
+}
+
+static int
+config_test_cbor_file_rec(char *dst, int dlen, int off, const char *name,
+                          const char *value)
+{
+    int len;
+
+    len = conf_cbor_make(dst + off, dlen - off, name, value);
+    TEST_ASSERT_FATAL(len > 0);
+    TEST_ASSERT(CONF_RECORD_IS_CBOR(dst + off));
+    return off + len;
+}
+#endif
+
+TEST_CASE(config_test_cbor_file)
+{
+#if MYNEWT_VAL(CONFIG_CBOR)
+    int rc;
+    struct conf_file cf;
+    struct fs_file *file;
+    char expect[128];
+    int len;
+    const char text1[] = "myfoo/mybar=1\n";
+    const char text2[] = "myfoo/mybar=3\n";
+
+    config_wipe_srcs();
+    rc = fs_mkdir("/config");
+    TEST_ASSERT(rc == 0 || rc == FS_EEXIST);
+
+    /*
+     * Text lines, as written before CBOR was enabled.
+     */
+    rc = fsutil_write_file("/config/cbor", text1, strlen(text1));
+    TEST_ASSERT(rc == 0);
+
+    memset(&cf, 0, sizeof(cf));
+    cf.cf_name = "/config/cbor";
+    rc = conf_file_src(&cf);
+    TEST_ASSERT(rc == 0);
+    rc = conf_file_dst(&cf);
+    TEST_ASSERT(rc == 0);
+
+    val8 = 0;
+    rc = conf_load();
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(val8 == 1);
+
+    /*
+     * New values are appended as CBOR records, with no newline after them.
+     */
+    rc = conf_save_one("myfoo/mybar", "2");
+    TEST_ASSERT(rc == 0);
+
+    memcpy(expect, text1, strlen(text1));
+    len = config_test_cbor_file_rec(expect, sizeof(expect), strlen(text1),
+                                    "myfoo/mybar", "2");
+    config_test_cbor_file_is(cf.cf_name, expect, len);
+
+    val8 = 0;
+    rc = conf_load();
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(val8 == 2);
+
+    /*
+     * A text line straight after a CBOR record, and a CBOR record after it.
+     */
+    rc = fs_open(cf.cf_name, FS_ACCESS_WRITE | FS_ACCESS_APPEND, &file);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = fs_write(file, text2, strlen(text2));
+    TEST_ASSERT(rc == 0);
+    fs_close(file);
+
+    val8 = 0;
+    rc = conf_load();
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(val8 == 3);
+
+    rc = conf_save_one("myfoo/mybar", "4");
+    TEST_ASSERT(rc == 0);
+
+    memcpy(expect + len, text2, strlen(text2));
+    len = config_test_cbor_file_rec(expect, sizeof(expect),
+                                    len + strlen(text2),
+                                    "myfoo/mybar", "4");
+    config_test_cbor_file_is(cf.cf_name, expect, len);
+
+    val8 = 0;
+    rc = conf_load();
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(val8 == 4);
+
+    /*
+     * Compressing drops the text lines; the latest value is kept as CBOR.
+     */
+    cf.cf_maxlines = 1;
+    rc = conf_save_one("myfoo/mybar", "5");
+    TEST_ASSERT(rc == 0);
+
+    len = config_test_cbor_file_rec(expect, sizeof(expect), 0,
+                                    "myfoo/mybar", "4");
+    len = config_test_cbor_file_rec(expect, sizeof(expect), len,
+                                    "myfoo/mybar", "5");
+    config_test_cbor_file_is(cf.cf_name, expect, len);
+
+    val8 = 0;
+    rc = conf_load();
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(val8 == 5);
+#endif
+}
@@ -38,13 +38,13 @@ TEST_CASE(config_test_save_in_file)
     rc = conf_save();
     TEST_ASSERT(rc == 0);
 
-    rc = conf_test_file_strstr(cf.cf_name, "myfoo/mybar=8\n");
+    rc = conf_test_file_record(cf.cf_name, "myfoo/mybar", "8");
     TEST_ASSERT(rc == 0);
 
     val8 = 43;
     rc = conf_save();
     TEST_ASSERT(rc == 0);
 
-    rc = conf_test_file_strstr(cf.cf_name, "myfoo/mybar=43\n");
+    rc = conf_test_file_record(cf.cf_name, "myfoo/mybar", "43");
     TEST_ASSERT(rc == 0);
 }
@@ -29,6 +29,10 @@
 #include "console/console.h"
 #include "console_priv.h"
 
+#if MYNEWT_VAL(CONSOLE_UART_RX_BUF_SIZE) > 0
+#include "spsc_ring/spsc_ring.h"
+#endif
+
 struct console_ring {
     uint8_t head;
     uint8_t tail;
@@ -43,8 +47,11 @@ typedef void (*console_write_char)(struct uart_dev*, uint8_t);
 static console_write_char write_char_cb;
 
 #if MYNEWT_VAL(CONSOLE_UART_RX_BUF_SIZE) > 0
-static struct console_ring cr_rx;
+/* Filled by the UART interrupt, drained by rx_ev; no locking needed. */
+static struct spsc_ring cr_rx;
 static uint8_t cr_rx_buf[MYNEWT_VAL(CONSOLE_UART_RX_BUF_SIZE)];
+/* Set when a byte was refused because cr_rx was full. */
+static volatile uint8_t cr_rx_stalled;
 
 struct os_event rx_ev;
 #endif
@@ -207,12 +214,11 @@ static int
 uart_console_rx_char(void *arg, uint8_t byte)
 {
 #if MYNEWT_VAL(CONSOLE_UART_RX_BUF_SIZE) > 0
-    if (uart_console_ring_is_full(&cr_rx)) {
+    if (spsc_ring_put(&cr_rx, byte)) {
+        cr_rx_stalled = 1;
         return -1;
     }
 
-    uart_console_ring_add_char(&cr_rx, byte);
-
     if (!rx_ev.ev_queued) {
         os_eventq_put(os_eventq_dflt_get(), &rx_ev);
     }
@@ -224,39 +230,43 @@ uart_console_rx_char(void *arg, uint8_t byte)
 }
 
 #if MYNEWT_VAL(CONSOLE_UART_RX_BUF_SIZE) > 0
+/*
+ * Releases consumed bytes back to the ring, and restarts RX if the UART was
+ * stopped because the ring had filled up.
+ */
 static void
-uart_console_rx_char_event(struct os_event *ev)
+uart_console_rx_consumed(uint32_t len)
 {
-    static int b = -1;
-    int sr;
-    int ret;
+    spsc_ring_read_commit(&cr_rx, len);
 
-    /* We may have unhandled character - try it first */
-    if (b >= 0) {
-        ret = console_handle_char(b);
-        if (ret < 0) {
-            return;
-        }
-
-        /*
-         * It is possible that UART RX was stalled in the meantime since we were
-         * not consuming data from ring buffer - make sure RX is started.
-         */
+    if (cr_rx_stalled) {
+        cr_rx_stalled = 0;
         uart_start_rx(uart_dev);
     }
+}
 
-    while (!uart_console_ring_is_empty(&cr_rx)) {
-        OS_ENTER_CRITICAL(sr);
-        b = uart_console_ring_pull_char(&cr_rx);
-        OS_EXIT_CRITICAL(sr);
+static void
+uart_console_rx_char_event(struct os_event *ev)
+{
+    uint8_t *data;
+    uint32_t len;
+    uint32_t i;
+    int ret;
 
-        ret = console_handle_char(b);
-        if (ret < 0) {
-            return;
+    while ((len = spsc_ring_read_reserve(&cr_rx, (void **)&data)) > 0) {
+        for (i = 0; i < len; i++) {
+            ret = console_handle_char(data[i]);
+            if (ret < 0) {
+                /*
+                 * Leave the byte in the ring; it is handled again once
+                 * console_rx_restart() is called.
+                 */
+                uart_console_rx_consumed(i);
+                return;
+            }
         }
+        uart_console_rx_consumed(len);
     }
-
-    b = -1;
 }
 #endif
 
@@ -284,8 +294,7 @@ uart_console_init(void)
     write_char_cb = uart_console_queue_char;
 
 #if MYNEWT_VAL(CONSOLE_UART_RX_BUF_SIZE) > 0
-    cr_rx.size = MYNEWT_VAL(CONSOLE_UART_RX_BUF_SIZE);
-    cr_rx.buf = cr_rx_buf;
+    spsc_ring_init(&cr_rx, cr_rx_buf, sizeof(cr_rx_buf));
 
     rx_ev.ev_cb = uart_console_rx_char_event;
 #endif
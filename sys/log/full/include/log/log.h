@@ -606,6 +606,25 @@ extern const struct log_handler log_cbmem_handler;
 #if MYNEWT_VAL(LOG_FCB)
 extern const struct log_handler log_fcb_handler;
 extern const struct log_handler log_fcb_slot1_handler;
+
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+/* Index keys filled in by log_fcb_index_key() */
+#define LOG_FCB_INDEX_KEY_INDEX     0
+#define LOG_FCB_INDEX_KEY_TS        1
+
+struct fcb;
+struct fcb_entry;
+
+/**
+ * @brief FCB index key function for logs.
+ *
+ * Set fl_fcb.f_index_key to this, and fl_fcb.f_index to an array of
+ * f_sector_cnt elements, before calling fcb_init().  Walks then skip over
+ * sectors holding only entries below the requested index or timestamp.
+ * Skipping by timestamp assumes the log timestamps do not go backwards.
+ */
+int log_fcb_index_key(struct fcb *fcb, struct fcb_entry *loc, uint64_t *keys);
+#endif
 #endif
 
 /* Private */
@@ -22,6 +22,7 @@
 #if MYNEWT_VAL(LOG_FCB)
 
 #include <string.h>
+#include <limits.h>
 
 #include "flash_map/flash_map.h"
 #include "fcb/fcb.h"
@@ -34,12 +35,54 @@ static struct flash_area sector;
 
 static int log_fcb_rtr_erase(struct log *log, void *arg);
 
+/**
+ * Frees up space after an append failed for lack of it, by erasing the
+ * oldest sector or, if the log keeps a number of last entries, by
+ * rewriting those.
+ */
 static int
-log_fcb_start_append(struct log *log, int len, struct fcb_entry *loc)
+log_fcb_make_room(struct log *log)
 {
     struct fcb *fcb;
     struct fcb_log *fcb_log;
     struct flash_area *old_fa;
+    int rc;
+
+    fcb_log = (struct fcb_log *)log->l_arg;
+    fcb = &fcb_log->fl_fcb;
+
+    if (fcb_log->fl_entries) {
+        return log_fcb_rtr_erase(log, fcb_log);
+    }
+
+    old_fa = fcb->f_oldest;
+    (void)old_fa; /* to avoid #ifdefs everywhere... */
+
+    rc = fcb_rotate(fcb);
+    if (rc) {
+        return rc;
+    }
+
+#if MYNEWT_VAL(LOG_STORAGE_WATERMARK)
+    /*
+     * FCB was rotated successfully so let's check if watermark was within
+     * oldest flash area which was erased. If yes, then move watermark to
+     * beginning of current oldest area.
+     */
+    if ((fcb_log->fl_watermark_off >= old_fa->fa_off) &&
+        (fcb_log->fl_watermark_off < old_fa->fa_off + old_fa->fa_size)) {
+        fcb_log->fl_watermark_off = fcb->f_oldest->fa_off;
+    }
+#endif
+
+    return 0;
+}
+
+static int
+log_fcb_start_append(struct log *log, int len, struct fcb_entry *loc)
+{
+    struct fcb *fcb;
+    struct fcb_log *fcb_log;
     int rc = 0;
 
     fcb_log = (struct fcb_log *)log->l_arg;
@@ -55,40 +98,137 @@ log_fcb_start_append(struct log *log, int len, struct fcb_entry *loc)
             goto err;
         }
 
-        if (fcb_log->fl_entries) {
-            rc = log_fcb_rtr_erase(log, fcb_log);
-            if (rc) {
-                goto err;
-            }
-            continue;
+        rc = log_fcb_make_room(log);
+        if (rc) {
+            goto err;
         }
+    }
 
-        old_fa = fcb->f_oldest;
-        (void)old_fa; /* to avoid #ifdefs everywhere... */
+err:
+    return (rc);
+}
 
-        rc = fcb_rotate(fcb);
+#if MYNEWT_VAL(LOG_FCB_BATCH)
+/**
+ * Writes out the entries collected in RAM.  Caller holds fl_batch_mtx.
+ */
+static int
+log_fcb_batch_commit(struct log *log)
+{
+    struct fcb *fcb;
+    struct fcb_log *fcb_log;
+    int rc;
+
+    fcb_log = (struct fcb_log *)log->l_arg;
+    fcb = &fcb_log->fl_fcb;
+
+    while (1) {
+        rc = fcb_batch_commit(fcb, &fcb_log->fl_batch);
+        if (rc != FCB_ERR_NOSPACE) {
+            break;
+        }
+
+        /* Batch does not fit even an empty FCB; give up on it. */
+        if (fcb_is_empty(fcb)) {
+            break;
+        }
+
+        rc = log_fcb_make_room(log);
         if (rc) {
-            goto err;
+            break;
         }
+    }
 
-#if MYNEWT_VAL(LOG_STORAGE_WATERMARK)
-        /*
-         * FCB was rotated successfully so let's check if watermark was within
-         * oldest flash area which was erased. If yes, then move watermark to
-         * beginning of current oldest area.
-         */
-        if ((fcb_log->fl_watermark_off >= old_fa->fa_off) &&
-            (fcb_log->fl_watermark_off < old_fa->fa_off + old_fa->fa_size)) {
-            fcb_log->fl_watermark_off = fcb->f_oldest->fa_off;
+    if (rc) {
+        fcb_batch_init(&fcb_log->fl_batch, fcb_log->fl_batch_buf,
+                       sizeof fcb_log->fl_batch_buf);
+    }
+    return rc;
+}
+
+static int
+log_fcb_batch_flush(struct log *log)
+{
+    struct fcb_log *fcb_log;
+    int rc;
+
+    fcb_log = (struct fcb_log *)log->l_arg;
+
+    os_mutex_pend(&fcb_log->fl_batch_mtx, OS_TIMEOUT_NEVER);
+    rc = log_fcb_batch_commit(log);
+    os_mutex_release(&fcb_log->fl_batch_mtx);
+
+    return rc;
+}
+
+static void
+log_fcb_batch_timer_cb(struct os_event *ev)
+{
+    log_fcb_batch_flush(ev->ev_arg);
+}
+
+/**
+ * Adds an entry to the log's batch; the entry is hdr, if not NULL,
+ * followed by body_len bytes from either body or om.  Returns SYS_ENOMEM
+ * if the entry is too big to be batched, in which case the caller writes
+ * it directly.
+ */
+static int
+log_fcb_batch_append(struct log *log, const struct log_entry_hdr *hdr,
+                     const void *body, const struct os_mbuf *om,
+                     int body_len)
+{
+    struct fcb *fcb;
+    struct fcb_log *fcb_log;
+    uint8_t *data;
+    int len;
+    int rc;
+
+    fcb_log = (struct fcb_log *)log->l_arg;
+    fcb = &fcb_log->fl_fcb;
+
+    len = body_len;
+    if (hdr != NULL) {
+        len += sizeof *hdr;
+    }
+
+    os_mutex_pend(&fcb_log->fl_batch_mtx, OS_TIMEOUT_NEVER);
+
+    data = fcb_batch_reserve(fcb, &fcb_log->fl_batch, len);
+    if (data == NULL) {
+        rc = log_fcb_batch_commit(log);
+        if (rc != 0) {
+            goto done;
         }
-#endif
+        data = fcb_batch_reserve(fcb, &fcb_log->fl_batch, len);
+        if (data == NULL) {
+            rc = SYS_ENOMEM;
+            goto done;
+        }
+    }
 
+    if (hdr != NULL) {
+        memcpy(data, hdr, sizeof *hdr);
+        data += sizeof *hdr;
+    }
+    if (om != NULL) {
+        os_mbuf_copydata(om, 0, body_len, data);
+    } else {
+        memcpy(data, body, body_len);
+    }
 
+    if (fcb_log->fl_batch.fb_entries == 1) {
+        os_callout_reset(&fcb_log->fl_batch_timer,
+                         os_time_ms_to_ticks32(
+                             MYNEWT_VAL(LOG_FCB_BATCH_DELAY_MS)));
     }
+    rc = 0;
 
-err:
-    return (rc);
+done:
+    os_mutex_release(&fcb_log->fl_batch_mtx);
+    return rc;
 }
+#endif
 
 static int
 log_fcb_append(struct log *log, void *buf, int len)
@@ -101,6 +241,13 @@ log_fcb_append(struct log *log, void *buf, int len)
     fcb_log = (struct fcb_log *)log->l_arg;
     fcb = &fcb_log->fl_fcb;
 
+#if MYNEWT_VAL(LOG_FCB_BATCH)
+    rc = log_fcb_batch_append(log, NULL, buf, NULL, len);
+    if (rc != SYS_ENOMEM) {
+        return rc;
+    }
+#endif
+
     rc = log_fcb_start_append(log, len, &loc);
     if (rc) {
         goto err;
@@ -158,6 +305,13 @@ log_fcb_append_body(struct log *log, const struct log_entry_hdr *hdr,
         return SYS_ENOTSUP;
     }
 
+#if MYNEWT_VAL(LOG_FCB_BATCH)
+    rc = log_fcb_batch_append(log, hdr, body, NULL, body_len);
+    if (rc != SYS_ENOMEM) {
+        return rc;
+    }
+#endif
+
     rc = log_fcb_start_append(log, sizeof *hdr + body_len, &loc);
     if (rc != 0) {
         return rc;
@@ -208,17 +362,23 @@ log_fcb_append_body(struct log *log, const struct log_entry_hdr *hdr,
 static int
 log_fcb_write_mbuf(struct fcb_entry *loc, const struct os_mbuf *om)
 {
+    struct os_mbuf_iovec iov;
+    struct os_mbuf_iter it;
     int rc;
 
-    while (om) {
+    rc = os_mbuf_iter_init(&it, om, 0, INT_MAX);
+    if (rc != 0) {
+        return SYS_EINVAL;
+    }
+
+    while (os_mbuf_iter_next(&it, &iov)) {
         rc = flash_area_write(loc->fe_area, loc->fe_data_off,
-                              om->om_data, om->om_len);
+                              iov.omi_base, iov.omi_len);
         if (rc != 0) {
             return SYS_EIO;
         }
 
-        loc->fe_data_off += om->om_len;
-        om = SLIST_NEXT(om, om_next);
+        loc->fe_data_off += iov.omi_len;
     }
 
     return 0;
@@ -236,6 +396,15 @@ log_fcb_append_mbuf(struct log *log, const struct os_mbuf *om)
     fcb_log = (struct fcb_log *)log->l_arg;
     fcb = &fcb_log->fl_fcb;
 
+    len = os_mbuf_len(om);
+
+#if MYNEWT_VAL(LOG_FCB_BATCH)
+    rc = log_fcb_batch_append(log, NULL, NULL, om, len);
+    if (rc != SYS_ENOMEM) {
+        return rc;
+    }
+#endif
+
     /* This function expects to be able to write each mbuf without any
      * buffering.
      */
@@ -244,7 +413,6 @@ log_fcb_append_mbuf(struct log *log, const struct os_mbuf *om)
         return SYS_ENOTSUP;
     }
 
-    len = os_mbuf_len(om);
     rc = log_fcb_start_append(log, len, &loc);
     if (rc != 0) {
         return rc;
@@ -276,6 +444,13 @@ log_fcb_append_mbuf_body(struct log *log, const struct log_entry_hdr *hdr,
     fcb_log = (struct fcb_log *)log->l_arg;
     fcb = &fcb_log->fl_fcb;
 
+#if MYNEWT_VAL(LOG_FCB_BATCH)
+    rc = log_fcb_batch_append(log, hdr, NULL, om, os_mbuf_len(om));
+    if (rc != SYS_ENOMEM) {
+        return rc;
+    }
+#endif
+
     /* This function expects to be able to write each mbuf without any
      * buffering.
      */
@@ -379,6 +554,11 @@ log_fcb_walk(struct log *log, log_walk_func_t walk_func,
     rc = 0;
     fcb = &((struct fcb_log *)log->l_arg)->fl_fcb;
 
+#if MYNEWT_VAL(LOG_FCB_BATCH)
+    /* Entries still in RAM are written out so the walk sees them. */
+    log_fcb_batch_flush(log);
+#endif
+
     memset(&loc, 0, sizeof(loc));
 
     /*
@@ -388,6 +568,24 @@ log_fcb_walk(struct log *log, log_walk_func_t walk_func,
         locp = &fcb->f_active;
         rc = walk_func(log, log_offset, (void *)locp, locp->fe_data_len);
     } else {
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+        /*
+         * Skip sectors which only hold entries older than requested.
+         */
+        if (fcb->f_index_key == log_fcb_index_key) {
+            if (log_offset->lo_ts == 0) {
+                rc = fcb_seek(fcb, LOG_FCB_INDEX_KEY_INDEX,
+                              log_offset->lo_index, &loc);
+            } else {
+                rc = fcb_seek(fcb, LOG_FCB_INDEX_KEY_TS, log_offset->lo_ts,
+                              &loc);
+            }
+            if (rc) {
+                memset(&loc, 0, sizeof(loc));
+                rc = 0;
+            }
+        }
+#endif
         while (fcb_getnext(fcb, &loc) == 0) {
             rc = walk_func(log, log_offset, (void *) &loc, loc.fe_data_len);
             if (rc) {
@@ -398,21 +596,66 @@ log_fcb_walk(struct log *log, log_walk_func_t walk_func,
     return (rc);
 }
 
+#if MYNEWT_VAL(FCB_SECTOR_INDEX)
+int
+log_fcb_index_key(struct fcb *fcb, struct fcb_entry *loc, uint64_t *keys)
+{
+    struct log_entry_hdr ueh;
+    int rc;
+
+    if (loc->fe_data_len < sizeof(ueh)) {
+        return SYS_EINVAL;
+    }
+    rc = flash_area_read(loc->fe_area, loc->fe_data_off, &ueh, sizeof(ueh));
+    if (rc) {
+        return SYS_EIO;
+    }
+    keys[LOG_FCB_INDEX_KEY_INDEX] = ueh.ue_index;
+    keys[LOG_FCB_INDEX_KEY_TS] = ueh.ue_ts;
+    return 0;
+}
+#endif
+
 static int
 log_fcb_flush(struct log *log)
 {
+#if MYNEWT_VAL(LOG_FCB_BATCH)
+    struct fcb_log *fcb_log;
+
+    fcb_log = (struct fcb_log *)log->l_arg;
+
+    os_mutex_pend(&fcb_log->fl_batch_mtx, OS_TIMEOUT_NEVER);
+    fcb_batch_init(&fcb_log->fl_batch, fcb_log->fl_batch_buf,
+                   sizeof fcb_log->fl_batch_buf);
+    os_mutex_release(&fcb_log->fl_batch_mtx);
+#endif
+
     return fcb_clear(&((struct fcb_log *)log->l_arg)->fl_fcb);
 }
 
 static int
 log_fcb_registered(struct log *log)
 {
-#if MYNEWT_VAL(LOG_STORAGE_WATERMARK)
+#if MYNEWT_VAL(LOG_FCB_BATCH) || MYNEWT_VAL(LOG_STORAGE_WATERMARK)
     struct fcb_log *fl;
+#endif
+#if MYNEWT_VAL(LOG_STORAGE_WATERMARK)
     struct fcb *fcb;
     struct fcb_entry loc;
+#endif
 
+#if MYNEWT_VAL(LOG_FCB_BATCH) || MYNEWT_VAL(LOG_STORAGE_WATERMARK)
     fl = (struct fcb_log *)log->l_arg;
+#endif
+
+#if MYNEWT_VAL(LOG_FCB_BATCH)
+    fcb_batch_init(&fl->fl_batch, fl->fl_batch_buf, sizeof fl->fl_batch_buf);
+    os_mutex_init(&fl->fl_batch_mtx);
+    os_callout_init(&fl->fl_batch_timer, os_eventq_dflt_get(),
+                    log_fcb_batch_timer_cb, log);
+#endif
+
+#if MYNEWT_VAL(LOG_STORAGE_WATERMARK)
     fcb = &fl->fl_fcb;
 
     /* Set watermark to first element */
@@ -656,8 +899,8 @@ log_fcb_rtr_erase(struct log *log, void *arg)
         goto err;
     }
 
-    /* Flush log */
-    rc = log_fcb_flush(log);
+    /* Flush log; entries waiting in RAM are kept. */
+    rc = fcb_clear(fcb);
     if (rc) {
         goto err;
     }
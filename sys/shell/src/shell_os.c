@@ -31,6 +31,75 @@
 
 #define SHELL_OS "os"
 
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+/*
+ * Prints run time and interrupt time in microseconds, and as a share of all
+ * time accounted for so far.
+ */
+static int
+shell_os_tasks_display_verbose(const char *name)
+{
+    struct os_task *prev_task;
+    struct os_task_info oti;
+    uint64_t total;
+    uint64_t isr_total;
+    int found;
+
+    total = 0;
+    isr_total = 0;
+    prev_task = NULL;
+    while (1) {
+        prev_task = os_task_info_get_next(prev_task, &oti);
+        if (prev_task == NULL) {
+            break;
+        }
+        total += oti.oti_runtime_us + oti.oti_isr_time_us;
+        isr_total += oti.oti_isr_time_us;
+    }
+    if (total == 0) {
+        total = 1;
+    }
+
+    found = 0;
+    console_printf("Tasks: \n");
+    console_printf("%8s %3s %3s %12s %5s %12s %5s %8s\n",
+      "task", "pri", "tid", "runtime_us", "cpu%", "isr_us", "isr%", "csw");
+    prev_task = NULL;
+    while (1) {
+        prev_task = os_task_info_get_next(prev_task, &oti);
+        if (prev_task == NULL) {
+            break;
+        }
+
+        if (name) {
+            if (strcmp(name, oti.oti_name)) {
+                continue;
+            } else {
+                found = 1;
+            }
+        }
+
+        console_printf("%8s %3u %3u %12llu %5u %12llu %5u %8lu\n",
+                oti.oti_name, oti.oti_prio, oti.oti_taskid,
+                (unsigned long long)oti.oti_runtime_us,
+                (unsigned int)(oti.oti_runtime_us * 100 / total),
+                (unsigned long long)oti.oti_isr_time_us,
+                (unsigned int)(oti.oti_isr_time_us * 100 / total),
+                (unsigned long)oti.oti_cswcnt);
+    }
+
+    if (name && !found) {
+        console_printf("Couldn't find task with name %s\n", name);
+    } else if (!name) {
+        console_printf("isr total %llu us (%u%%)\n",
+                       (unsigned long long)isr_total,
+                       (unsigned int)(isr_total * 100 / total));
+    }
+
+    return 0;
+}
+#endif
+
 int
 shell_os_tasks_display_cmd(int argc, char **argv)
 {
@@ -42,6 +111,15 @@ shell_os_tasks_display_cmd(int argc, char **argv)
     name = NULL;
     found = 0;
 
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    if (argc > 1 && !strcmp(argv[1], "-v")) {
+        if (argc > 2 && strcmp(argv[2], "")) {
+            name = argv[2];
+        }
+        return shell_os_tasks_display_verbose(name);
+    }
+#endif
+
     if (argc > 1 && strcmp(argv[1], "")) {
         name = argv[1];
     }
@@ -81,6 +159,48 @@ shell_os_tasks_display_cmd(int argc, char **argv)
     return 0;
 }
 
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+int
+shell_os_stacks_display_cmd(int argc, char **argv)
+{
+    struct os_task *prev_task;
+    struct os_task_info oti;
+    uint32_t spare;
+    uint16_t usage;
+    uint16_t rec;
+    int full;
+
+    full = argc > 1 && !strcmp(argv[1], "-f");
+    spare = 0;
+
+    console_printf("Stacks: \n");
+    console_printf("%8s %8s %8s %8s\n", "task", "stksz", "stkuse", "recmd");
+    prev_task = NULL;
+    while (1) {
+        prev_task = os_task_info_get_next(prev_task, &oti);
+        if (prev_task == NULL) {
+            break;
+        }
+
+        usage = oti.oti_stkusage;
+        if (full) {
+            usage = os_task_stack_usage(prev_task, 1);
+        }
+        rec = os_task_stack_recommend(usage);
+        if (rec < oti.oti_stksize) {
+            spare += oti.oti_stksize - rec;
+        }
+
+        console_printf("%8s %8u %8u %8u\n", oti.oti_name, oti.oti_stksize,
+                       usage, rec);
+    }
+    console_printf("spare %lu bytes\n",
+                   (unsigned long)(spare * sizeof(os_stack_t)));
+
+    return 0;
+}
+#endif
+
 int
 shell_os_mpool_display_cmd(int argc, char **argv)
 {
@@ -127,6 +247,203 @@ shell_os_mpool_display_cmd(int argc, char **argv)
     return 0;
 }
 
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+int
+shell_os_evq_display_cmd(int argc, char **argv)
+{
+    struct os_eventq *evq;
+    struct os_eventq_info oei;
+    char *name;
+    int clear;
+    int found;
+
+    name = NULL;
+    clear = 0;
+    found = 0;
+
+    argc--; argv++;     /* skip command name */
+    if (argc > 0 && !strcmp(argv[0], "-c")) {
+        clear = 1;
+        argc--; argv++;
+    }
+    if (argc > 0 && strcmp(argv[0], "")) {
+        name = argv[0];
+    }
+
+    console_printf("Event queues: \n");
+    console_printf("%16s %5s %5s %10s %10s\n", "name", "depth", "max",
+                   "dwell_us", "cb_us");
+    evq = NULL;
+    while (1) {
+        evq = os_eventq_info_get_next(evq, &oei);
+        if (evq == NULL) {
+            break;
+        }
+
+        if (name) {
+            if (strcmp(name, oei.oei_name)) {
+                continue;
+            } else {
+                found = 1;
+            }
+        }
+
+        console_printf("%16s %5u %5u %10lu %10lu\n", oei.oei_name,
+                       oei.oei_depth, oei.oei_max_depth,
+                       (unsigned long)oei.oei_max_dwell_us,
+                       (unsigned long)oei.oei_max_cb_us);
+        if (clear) {
+            os_eventq_stats_clear(evq);
+        }
+    }
+
+    if (name && !found) {
+        console_printf("Couldn't find an event queue with name %s\n", name);
+    }
+
+    return 0;
+}
+#endif
+
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+int
+shell_os_mutex_display_cmd(int argc, char **argv)
+{
+    struct os_mutex *mu;
+    struct os_mutex_info omi;
+    char *name;
+    int clear;
+    int found;
+
+    name = NULL;
+    clear = 0;
+    found = 0;
+
+    argc--; argv++;     /* skip command name */
+    if (argc > 0 && !strcmp(argv[0], "-c")) {
+        clear = 1;
+        argc--; argv++;
+    }
+    if (argc > 0 && strcmp(argv[0], "")) {
+        name = argv[0];
+    }
+
+    console_printf("Mutexes: \n");
+    console_printf("%16s %16s %8s %8s %12s %10s %10s\n", "name", "owner",
+                   "acq", "cont", "wait_us", "max_wait", "max_hold");
+    mu = NULL;
+    while (1) {
+        mu = os_mutex_info_get_next(mu, &omi);
+        if (mu == NULL) {
+            break;
+        }
+
+        if (name) {
+            if (strcmp(name, omi.omi_name)) {
+                continue;
+            } else {
+                found = 1;
+            }
+        }
+
+        console_printf("%16s %16s %8lu %8lu %12llu %10lu %10lu\n",
+                       omi.omi_name, omi.omi_owner ? omi.omi_owner : "-",
+                       (unsigned long)omi.omi_acquired,
+                       (unsigned long)omi.omi_contended,
+                       (unsigned long long)omi.omi_wait_total_us,
+                       (unsigned long)omi.omi_max_wait_us,
+                       (unsigned long)omi.omi_max_hold_us);
+        if (clear) {
+            os_mutex_stats_clear(mu);
+        }
+    }
+
+    if (name && !found) {
+        console_printf("Couldn't find a mutex with name %s\n", name);
+    }
+
+    return 0;
+}
+#endif
+
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+int
+shell_os_evqprof_display_cmd(int argc, char **argv)
+{
+    struct os_eventq_prof_info oepi;
+    int idx;
+
+    console_printf("Event callbacks: \n");
+    console_printf("%10s %8s %12s %8s %12s %8s\n", "cb", "cnt", "run_us",
+                   "max_us", "wait_us", "max_us");
+    idx = -1;
+    while (1) {
+        idx = os_eventq_prof_info_get_next(idx, &oepi);
+        if (idx < 0) {
+            break;
+        }
+
+        console_printf("0x%08lx %8lu %12llu %8lu %12llu %8lu\n",
+                       (unsigned long)(uintptr_t)oepi.oepi_cb,
+                       (unsigned long)oepi.oepi_count,
+                       (unsigned long long)oepi.oepi_run_total_us,
+                       (unsigned long)oepi.oepi_run_max_us,
+                       (unsigned long long)oepi.oepi_wait_total_us,
+                       (unsigned long)oepi.oepi_wait_max_us);
+    }
+    console_printf("overflow %lu\n", (unsigned long)os_eventq_prof_overflow());
+
+    if (argc > 1 && !strcmp(argv[1], "-c")) {
+        os_eventq_prof_clear();
+    }
+
+    return 0;
+}
+#endif
+
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+static int
+shell_os_alloctrace_site(const struct os_alloc_trace_site *oats, void *arg)
+{
+    const char *type;
+
+    switch (oats->oats_type) {
+    case OS_ALLOC_TRACE_MALLOC:
+        type = "malloc";
+        break;
+    case OS_ALLOC_TRACE_MEMBLOCK_GET:
+        type = "memblock";
+        break;
+    default:
+        type = "mbuf";
+        break;
+    }
+
+    console_printf("%8s 0x%08lx %6lu %8lu %10lu\n", type,
+                   (unsigned long)oats->oats_caller,
+                   (unsigned long)oats->oats_count,
+                   (unsigned long)oats->oats_bytes,
+                   (unsigned long)(os_time_get() - oats->oats_oldest));
+    return 0;
+}
+
+int
+shell_os_alloctrace_display_cmd(int argc, char **argv)
+{
+    console_printf("Outstanding allocations: \n");
+    console_printf("%8s %10s %6s %8s %10s\n", "type", "caller", "cnt",
+                   "bytes", "age");
+    os_alloc_trace_sites(shell_os_alloctrace_site, NULL);
+    console_printf("dropped %lu\n", (unsigned long)os_alloc_trace_dropped());
+
+    if (argc > 1 && !strcmp(argv[1], "-c")) {
+        os_alloc_trace_clear();
+    }
+
+    return 0;
+}
+#endif
+
 int
 shell_os_date_cmd(int argc, char **argv)
 {
@@ -175,6 +492,9 @@ shell_os_reset_cmd(int argc, char **argv)
 
 #if MYNEWT_VAL(SHELL_CMD_HELP)
 static const struct shell_param tasks_params[] = {
+#if MYNEWT_VAL(OS_TASK_RUN_TIME_CPUTIME)
+    {"-v", "show run and interrupt time in microseconds"},
+#endif
     {"", "task name"},
     {NULL, NULL}
 };
@@ -196,6 +516,73 @@ static const struct shell_cmd_help mpool_help = {
     .params = mpool_params,
 };
 
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+static const struct shell_param stacks_params[] = {
+    {"-f", "full scan of every stack instead of an incremental one"},
+    {NULL, NULL}
+};
+
+static const struct shell_cmd_help stacks_help = {
+    .summary = "show stack use and recommended stack sizes",
+    .usage = NULL,
+    .params = stacks_params,
+};
+#endif
+
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+static const struct shell_param evq_params[] = {
+    {"-c", "clear maximums after displaying them"},
+    {"", "event queue name"},
+    {NULL, NULL}
+};
+
+static const struct shell_cmd_help evq_help = {
+    .summary = "show event queue depth and latency",
+    .usage = NULL,
+    .params = evq_params,
+};
+#endif
+
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+static const struct shell_param mutex_params[] = {
+    {"-c", "clear statistics after displaying them"},
+    {"", "mutex name"},
+    {NULL, NULL}
+};
+
+static const struct shell_cmd_help mutex_help = {
+    .summary = "show mutex contention",
+    .usage = NULL,
+    .params = mutex_params,
+};
+#endif
+
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+static const struct shell_param evqprof_params[] = {
+    {"-c", "clear the profile after displaying it"},
+    {NULL, NULL}
+};
+
+static const struct shell_cmd_help evqprof_help = {
+    .summary = "show event callback run and queue wait times",
+    .usage = NULL,
+    .params = evqprof_params,
+};
+#endif
+
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+static const struct shell_param alloctrace_params[] = {
+    {"-c", "clear the trace after displaying it"},
+    {NULL, NULL}
+};
+
+static const struct shell_cmd_help alloctrace_help = {
+    .summary = "show allocations not yet freed, by call site",
+    .usage = NULL,
+    .params = alloctrace_params,
+};
+#endif
+
 static const struct shell_param date_params[] = {
     {"", "datetime to set"},
     {NULL, NULL}
@@ -236,6 +623,51 @@ static const struct shell_cmd os_commands[] = {
         .help = &mpool_help,
 #endif
     },
+#if MYNEWT_VAL(OS_TASK_STACK_WATERMARK)
+    {
+        .sc_cmd = "stacks",
+        .sc_cmd_func = shell_os_stacks_display_cmd,
+#if MYNEWT_VAL(SHELL_CMD_HELP)
+        .help = &stacks_help,
+#endif
+    },
+#endif
+#if MYNEWT_VAL(OS_EVENTQ_STATS)
+    {
+        .sc_cmd = "evq",
+        .sc_cmd_func = shell_os_evq_display_cmd,
+#if MYNEWT_VAL(SHELL_CMD_HELP)
+        .help = &evq_help,
+#endif
+    },
+#endif
+#if MYNEWT_VAL(OS_MUTEX_STATS)
+    {
+        .sc_cmd = "mutex",
+        .sc_cmd_func = shell_os_mutex_display_cmd,
+#if MYNEWT_VAL(SHELL_CMD_HELP)
+        .help = &mutex_help,
+#endif
+    },
+#endif
+#if MYNEWT_VAL(OS_EVENTQ_PROF)
+    {
+        .sc_cmd = "evqprof",
+        .sc_cmd_func = shell_os_evqprof_display_cmd,
+#if MYNEWT_VAL(SHELL_CMD_HELP)
+        .help = &evqprof_help,
+#endif
+    },
+#endif
+#if MYNEWT_VAL(OS_ALLOC_TRACE)
+    {
+        .sc_cmd = "alloctrace",
+        .sc_cmd_func = shell_os_alloctrace_display_cmd,
+#if MYNEWT_VAL(SHELL_CMD_HELP)
+        .help = &alloctrace_help,
+#endif
+    },
+#endif
     {
         .sc_cmd = "date",
         .sc_cmd_func = shell_os_date_cmd,
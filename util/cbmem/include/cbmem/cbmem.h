@@ -81,6 +81,38 @@ int cbmem_init(struct cbmem *cbmem, void *buf, uint32_t buf_len);
 int cbmem_append(struct cbmem *cbmem, void *data, uint16_t len);
 int cbmem_append_mbuf(struct cbmem *cbmem, const struct os_mbuf *om);
 
+/**
+ * @brief Appends an entry without taking the cbmem lock.
+ *
+ * The caller serializes access to the cbmem instead, e.g. by appending from
+ * within a critical section; this makes the call usable from interrupt
+ * context.
+ *
+ * @param cbmem                 The cbmem to write to.
+ * @param data                  The entry to append.
+ * @param len                   The length of the entry.
+ *
+ * @return                      0 on success; nonzero on failure.
+ */
+int cbmem_append_nolock(struct cbmem *cbmem, const void *data, uint16_t len);
+
+/**
+ * @brief Overwrites the start of the newest entry without taking the cbmem
+ * lock.
+ *
+ * The entry keeps its length; only its first len bytes are replaced.  As
+ * with cbmem_append_nolock(), the caller serializes access to the cbmem.
+ *
+ * @param cbmem                 The cbmem to write to.
+ * @param data                  The new contents.
+ * @param len                   The number of bytes to write.
+ *
+ * @return                      0 on success; -1 if the cbmem is empty or
+ *                                  the newest entry is shorter than len.
+ */
+int cbmem_update_last_nolock(struct cbmem *cbmem, const void *data,
+                             uint16_t len);
+
 /**
  * @brief Performs a scatter-gather write to the provided cbmem.
  *
@@ -74,19 +74,13 @@ err:
 }
 
 
-static int
-cbmem_append_internal(struct cbmem *cbmem, const void *data, uint16_t len,
+static void
+cbmem_append_unlocked(struct cbmem *cbmem, const void *data, uint16_t len,
                       copy_data_func_t *copy_func)
 {
     struct cbmem_entry_hdr *dst;
     uint8_t *start;
     uint8_t *end;
-    int rc;
-
-    rc = cbmem_lock_acquire(cbmem);
-    if (rc != 0) {
-        goto err;
-    }
 
     if (cbmem->c_entry_end) {
         dst = CBMEM_ENTRY_NEXT(cbmem->c_entry_end);
@@ -133,6 +127,20 @@ cbmem_append_internal(struct cbmem *cbmem, const void *data, uint16_t len,
     if (!cbmem->c_entry_start) {
         cbmem->c_entry_start = dst;
     }
+}
+
+static int
+cbmem_append_internal(struct cbmem *cbmem, const void *data, uint16_t len,
+                      copy_data_func_t *copy_func)
+{
+    int rc;
+
+    rc = cbmem_lock_acquire(cbmem);
+    if (rc != 0) {
+        goto err;
+    }
+
+    cbmem_append_unlocked(cbmem, data, len, copy_func);
 
     rc = cbmem_lock_release(cbmem);
     if (rc != 0) {
@@ -200,6 +208,28 @@ cbmem_append(struct cbmem *cbmem, void *data, uint16_t len)
     return cbmem_append_internal(cbmem, data, len, copy_data_from_flat);
 }
 
+int
+cbmem_append_nolock(struct cbmem *cbmem, const void *data, uint16_t len)
+{
+    cbmem_append_unlocked(cbmem, data, len, copy_data_from_flat);
+    return (0);
+}
+
+int
+cbmem_update_last_nolock(struct cbmem *cbmem, const void *data, uint16_t len)
+{
+    struct cbmem_entry_hdr *hdr;
+
+    hdr = cbmem->c_entry_end;
+    if (hdr == NULL || len > hdr->ceh_len) {
+        return (-1);
+    }
+
+    memcpy((uint8_t *) hdr + sizeof(*hdr), data, len);
+
+    return (0);
+}
+
 int
 cbmem_append_mbuf(struct cbmem *cbmem, const struct os_mbuf *om)
 {
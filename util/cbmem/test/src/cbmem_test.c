@@ -84,12 +84,14 @@ cbmem_test_case_1_walk(struct cbmem *cbmem, struct cbmem_entry_hdr *hdr,
 TEST_CASE_DECL(cbmem_test_case_1)
 TEST_CASE_DECL(cbmem_test_case_2)
 TEST_CASE_DECL(cbmem_test_case_3)
+TEST_CASE_DECL(cbmem_test_case_update_last)
 
 TEST_SUITE(cbmem_test_suite)
 {
     cbmem_test_case_1();
     cbmem_test_case_2();
     cbmem_test_case_3();
+    cbmem_test_case_update_last();
 }
 
 #if MYNEWT_VAL(SELFTEST)
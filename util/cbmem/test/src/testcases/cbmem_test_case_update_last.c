@@ -0,0 +1,57 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "cbmem_test.h"
+
+TEST_CASE(cbmem_test_case_update_last)
+{
+    struct cbmem_entry_hdr *hdr;
+    struct cbmem_entry_hdr *last;
+    struct cbmem_iter iter;
+    struct cbmem empty;
+    uint8_t buf[4];
+    uint8_t val;
+    int rc;
+
+    /* An empty cbmem has no entry to update. */
+    rc = cbmem_init(&empty, buf, sizeof(buf));
+    TEST_ASSERT_FATAL(rc == 0);
+    val = 0;
+    TEST_ASSERT(cbmem_update_last_nolock(&empty, &val, 1) == -1);
+
+    /* The newest entry can be overwritten, but not grown. */
+    val = 0xa5;
+    rc = cbmem_update_last_nolock(&cbmem1, &val, sizeof(val));
+    TEST_ASSERT(rc == 0);
+    rc = cbmem_update_last_nolock(&cbmem1, cbmem1_entry,
+                                  CBMEM1_ENTRY_SIZE + 1);
+    TEST_ASSERT(rc == -1);
+
+    last = NULL;
+    cbmem_iter_start(&cbmem1, &iter);
+    while ((hdr = cbmem_iter_next(&cbmem1, &iter)) != NULL) {
+        last = hdr;
+    }
+    TEST_ASSERT_FATAL(last != NULL);
+    TEST_ASSERT(last->ceh_len == CBMEM1_ENTRY_SIZE);
+
+    rc = cbmem_read(&cbmem1, last, buf, 0, 2);
+    TEST_ASSERT_FATAL(rc == 2);
+    TEST_ASSERT(buf[0] == 0xa5);
+    TEST_ASSERT(buf[1] == 0xff);
+}
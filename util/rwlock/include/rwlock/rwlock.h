@@ -34,11 +34,17 @@
  *       is acquired by a pending writer if there is one.  If there are no
  *       pending writers, the lock is acquired by all pending readers.
  *
- * All struct fields should be considered private.
+ * A reader or writer which gives up waiting (see the timeout and try
+ * variants) leaves the queue without affecting the others.
+ *
+ * All struct fields should be considered private.  A zero-filled rwlock is
+ * unlocked and ready for use.
  */
 struct rwlock {
+#if !MYNEWT_VAL(RWLOCK_READ_MOSTLY)
     /** Protects access to rwlock's internal state. */
     struct os_mutex mtx;
+#endif
 
     /** Blocks and wakes up pending readers. */
     struct os_sem rsem;
@@ -72,6 +78,31 @@ struct rwlock {
  */
 void rwlock_acquire_read(struct rwlock *lock);
 
+/**
+ * @brief Acquires the lock for use by a reader, giving up after the
+ * specified timeout.
+ *
+ * @param lock                  The lock to acquire.
+ * @param timeout               The number of ticks to wait for the lock;
+ *                                  0 to not wait, OS_TIMEOUT_NEVER to wait
+ *                                  indefinitely.
+ *
+ * @return                      0 if the lock was acquired;
+ *                              OS_TIMEOUT if it was not.
+ */
+int rwlock_acquire_read_timeout(struct rwlock *lock, os_time_t timeout);
+
+/**
+ * @brief Acquires the lock for use by a reader if that is possible without
+ * waiting.
+ *
+ * @param lock                  The lock to acquire.
+ *
+ * @return                      0 if the lock was acquired;
+ *                              OS_TIMEOUT if it was not.
+ */
+int rwlock_try_acquire_read(struct rwlock *lock);
+
 /**
  * Releases the lock from a reader.
  *
@@ -86,6 +117,31 @@ void rwlock_release_read(struct rwlock *lock);
  */
 void rwlock_acquire_write(struct rwlock *lock);
 
+/**
+ * @brief Acquires the lock for use by a writer, giving up after the
+ * specified timeout.
+ *
+ * @param lock                  The lock to acquire.
+ * @param timeout               The number of ticks to wait for the lock;
+ *                                  0 to not wait, OS_TIMEOUT_NEVER to wait
+ *                                  indefinitely.
+ *
+ * @return                      0 if the lock was acquired;
+ *                              OS_TIMEOUT if it was not.
+ */
+int rwlock_acquire_write_timeout(struct rwlock *lock, os_time_t timeout);
+
+/**
+ * @brief Acquires the lock for use by a writer if that is possible without
+ * waiting.
+ *
+ * @param lock                  The lock to acquire.
+ *
+ * @return                      0 if the lock was acquired;
+ *                              OS_TIMEOUT if it was not.
+ */
+int rwlock_try_acquire_write(struct rwlock *lock);
+
 /**
  * Releases the lock from a writer.
  *
@@ -26,14 +26,49 @@
 #define RWLOCK_DBG_ASSERT(expr)
 #endif
 
+#if MYNEWT_VAL(RWLOCK_READ_MOSTLY)
+#define RWLOCK_DBG_ASSERT_GUARDED(lock) RWLOCK_DBG_ASSERT(os_arch_in_critical())
+#else
+#define RWLOCK_DBG_ASSERT_GUARDED(lock) \
+    RWLOCK_DBG_ASSERT((lock)->mtx.mu_owner == g_current_task)
+#endif
+
+/**
+ * Starts exclusive access to the lock's internal state.  Nothing done while
+ * guarded may block.
+ */
+static os_sr_t
+rwlock_guard(struct rwlock *lock)
+{
+#if MYNEWT_VAL(RWLOCK_READ_MOSTLY)
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    return sr;
+#else
+    os_mutex_pend(&lock->mtx, OS_TIMEOUT_NEVER);
+    return 0;
+#endif
+}
+
+static void
+rwlock_unguard(struct rwlock *lock, os_sr_t sr)
+{
+#if MYNEWT_VAL(RWLOCK_READ_MOSTLY)
+    OS_EXIT_CRITICAL(sr);
+#else
+    os_mutex_release(&lock->mtx);
+#endif
+}
+
 /**
- * Unblocks the next pending user.  The caller must lock the mutex prior to
+ * Unblocks the next pending user.  The caller must guard the lock prior to
  * calling this.
  */
 static void
 rwlock_unblock(struct rwlock *lock)
 {
-    RWLOCK_DBG_ASSERT(lock->mtx.mu_owner == g_current_task);
+    RWLOCK_DBG_ASSERT_GUARDED(lock);
     RWLOCK_DBG_ASSERT(lock->handoffs == 0);
 
     /* Give priority to pending writers. */
@@ -59,11 +94,38 @@ rwlock_unblock(struct rwlock *lock)
 static void
 rwlock_complete_handoff(struct rwlock *lock)
 {
-    RWLOCK_DBG_ASSERT(lock->mtx.mu_owner == g_current_task);
+    RWLOCK_DBG_ASSERT_GUARDED(lock);
     RWLOCK_DBG_ASSERT(lock->handoffs > 0);
     lock->handoffs--;
 }
 
+/**
+ * Called by a user whose wait timed out.  The lock may have been handed to
+ * it after the timeout expired but before it got here; in that case the
+ * handoff left a token in the semaphore and the user takes the lock after
+ * all.  Tokens are not tied to a particular waiter, but each one stands for
+ * a handoff which a pending user is entitled to, so the counts stay
+ * balanced whichever user takes it.  The caller must guard the lock prior
+ * to calling this.
+ *
+ * @return                      0 if the lock was handed over;
+ *                              OS_TIMEOUT if the user is no longer pending.
+ */
+static int
+rwlock_abandon_wait(struct rwlock *lock, struct os_sem *sem, uint8_t *pending)
+{
+    RWLOCK_DBG_ASSERT_GUARDED(lock);
+
+    if (os_sem_get_count(sem) > 0) {
+        os_sem_pend(sem, 0);
+        return 0;
+    }
+
+    RWLOCK_DBG_ASSERT(*pending > 0);
+    (*pending)--;
+    return OS_TIMEOUT;
+}
+
 /**
  * Indicates whether a prospective reader must wait for the lock to become
  * available.
@@ -71,7 +133,7 @@ rwlock_complete_handoff(struct rwlock *lock)
 static bool
 rwlock_read_must_block(const struct rwlock *lock)
 {
-    RWLOCK_DBG_ASSERT(lock->mtx.mu_owner == g_current_task);
+    RWLOCK_DBG_ASSERT_GUARDED(lock);
 
     return lock->active_writer ||
            lock->pending_writers > 0 ||
@@ -85,49 +147,75 @@ rwlock_read_must_block(const struct rwlock *lock)
 static bool
 rwlock_write_must_block(const struct rwlock *lock)
 {
-    RWLOCK_DBG_ASSERT(lock->mtx.mu_owner == g_current_task);
+    RWLOCK_DBG_ASSERT_GUARDED(lock);
 
     return lock->active_writer ||
            lock->num_readers > 0 ||
            lock->handoffs > 0;
 }
 
-void
-rwlock_acquire_read(struct rwlock *lock)
+int
+rwlock_acquire_read_timeout(struct rwlock *lock, os_time_t timeout)
 {
-    bool acquired;
+    os_sr_t sr;
+    int rc;
 
-    os_mutex_pend(&lock->mtx, OS_TIMEOUT_NEVER);
+    sr = rwlock_guard(lock);
 
-    if (rwlock_read_must_block(lock)) {
-        lock->pending_readers++;
-        acquired = false;
-    } else {
+    if (!rwlock_read_must_block(lock)) {
+        /* No contention; lock acquired. */
         lock->num_readers++;
-        acquired = true;
+        rwlock_unguard(lock, sr);
+        return 0;
     }
 
-    os_mutex_release(&lock->mtx);
-
-    if (acquired) {
-        /* No contention; lock acquired. */
-        return;
+    if (timeout == 0) {
+        rwlock_unguard(lock, sr);
+        return OS_TIMEOUT;
     }
 
+    lock->pending_readers++;
+    rwlock_unguard(lock, sr);
+
     /* Wait for the lock to become available. */
-    os_sem_pend(&lock->rsem, OS_TIMEOUT_NEVER);
+    rc = os_sem_pend(&lock->rsem, timeout);
 
-    /* Record reader ownership. */
-    os_mutex_pend(&lock->mtx, OS_TIMEOUT_NEVER);
-    lock->num_readers++;
-    rwlock_complete_handoff(lock);
-    os_mutex_release(&lock->mtx);
+    sr = rwlock_guard(lock);
+    if (rc != 0) {
+        rc = rwlock_abandon_wait(lock, &lock->rsem, &lock->pending_readers);
+    }
+    if (rc == 0) {
+        /* Record reader ownership. */
+        lock->num_readers++;
+        rwlock_complete_handoff(lock);
+    }
+    rwlock_unguard(lock, sr);
+
+    return rc;
+}
+
+int
+rwlock_try_acquire_read(struct rwlock *lock)
+{
+    return rwlock_acquire_read_timeout(lock, 0);
+}
+
+void
+rwlock_acquire_read(struct rwlock *lock)
+{
+    int rc;
+
+    rc = rwlock_acquire_read_timeout(lock, OS_TIMEOUT_NEVER);
+    RWLOCK_DBG_ASSERT(rc == 0);
+    (void)rc;
 }
 
 void
 rwlock_release_read(struct rwlock *lock)
 {
-    os_mutex_pend(&lock->mtx, OS_TIMEOUT_NEVER);
+    os_sr_t sr;
+
+    sr = rwlock_guard(lock);
 
     RWLOCK_DBG_ASSERT(lock->num_readers > 0);
     lock->num_readers--;
@@ -139,52 +227,82 @@ rwlock_release_read(struct rwlock *lock)
         rwlock_unblock(lock);
     }
 
-    os_mutex_release(&lock->mtx);
+    rwlock_unguard(lock, sr);
 }
 
-void
-rwlock_acquire_write(struct rwlock *lock)
+int
+rwlock_acquire_write_timeout(struct rwlock *lock, os_time_t timeout)
 {
-    bool acquired;
+    os_sr_t sr;
+    int rc;
 
-    os_mutex_pend(&lock->mtx, OS_TIMEOUT_NEVER);
+    sr = rwlock_guard(lock);
 
-    if (rwlock_write_must_block(lock)) {
-        lock->pending_writers++;
-        acquired = false;
-    } else {
+    if (!rwlock_write_must_block(lock)) {
+        /* No contention; lock acquired. */
         lock->active_writer = true;
-        acquired = true;
+        rwlock_unguard(lock, sr);
+        return 0;
     }
 
-    os_mutex_release(&lock->mtx);
-
-    if (acquired) {
-        /* No contention; lock acquired. */
-        return;
+    if (timeout == 0) {
+        rwlock_unguard(lock, sr);
+        return OS_TIMEOUT;
     }
 
+    lock->pending_writers++;
+    rwlock_unguard(lock, sr);
+
     /* Wait for the lock to become available. */
-    os_sem_pend(&lock->wsem, OS_TIMEOUT_NEVER);
+    rc = os_sem_pend(&lock->wsem, timeout);
 
-    /* Record writer ownership. */
-    os_mutex_pend(&lock->mtx, OS_TIMEOUT_NEVER);
-    lock->active_writer = true;
-    rwlock_complete_handoff(lock);
-    os_mutex_release(&lock->mtx);
+    sr = rwlock_guard(lock);
+    if (rc != 0) {
+        rc = rwlock_abandon_wait(lock, &lock->wsem, &lock->pending_writers);
+    }
+    if (rc == 0) {
+        /* Record writer ownership. */
+        lock->active_writer = true;
+        rwlock_complete_handoff(lock);
+    } else if (!lock->active_writer && lock->pending_writers == 0 &&
+               lock->handoffs == 0) {
+        /* This writer was all that kept pending readers out. */
+        rwlock_unblock(lock);
+    }
+    rwlock_unguard(lock, sr);
+
+    return rc;
+}
+
+int
+rwlock_try_acquire_write(struct rwlock *lock)
+{
+    return rwlock_acquire_write_timeout(lock, 0);
+}
+
+void
+rwlock_acquire_write(struct rwlock *lock)
+{
+    int rc;
+
+    rc = rwlock_acquire_write_timeout(lock, OS_TIMEOUT_NEVER);
+    RWLOCK_DBG_ASSERT(rc == 0);
+    (void)rc;
 }
 
 void
 rwlock_release_write(struct rwlock *lock)
 {
-    os_mutex_pend(&lock->mtx, OS_TIMEOUT_NEVER);
+    os_sr_t sr;
+
+    sr = rwlock_guard(lock);
 
     RWLOCK_DBG_ASSERT(lock->active_writer);
     lock->active_writer = false;
 
     rwlock_unblock(lock);
 
-    os_mutex_release(&lock->mtx);
+    rwlock_unguard(lock, sr);
 }
 
 int
@@ -194,10 +312,12 @@ rwlock_init(struct rwlock *lock)
 
     *lock = (struct rwlock) { 0 };
 
+#if !MYNEWT_VAL(RWLOCK_READ_MOSTLY)
     rc = os_mutex_init(&lock->mtx);
     if (rc != 0) {
         return rc;
     }
+#endif
 
     rc = os_sem_init(&lock->rsem, 0);
     if (rc != 0) {
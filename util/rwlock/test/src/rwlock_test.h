@@ -6,5 +6,6 @@
 
 TEST_SUITE_DECL(rwlock_test_suite_basic);
 TEST_CASE_DECL(rwlock_test_case_basic);
+TEST_CASE_DECL(rwlock_test_case_timeout);
 
 #endif
@@ -0,0 +1,147 @@
+#include "rwlock/rwlock.h"
+#include "rwlock_test.h"
+
+#define RTCT_READ_TASK_PRIO     10
+#define RTCT_WRITE_TASK_PRIO    11
+
+#define RTCT_STACK_SIZE         1024
+
+static void rtct_evcb_read(struct os_event *ev);
+static void rtct_evcb_write(struct os_event *ev);
+
+static os_time_t rtct_read_timeout;
+static os_time_t rtct_write_timeout;
+static int rtct_read_rc;
+static int rtct_write_rc;
+static int rtct_reads_done;
+static int rtct_writes_done;
+
+static struct os_eventq rtct_evq_read;
+static struct os_eventq rtct_evq_write;
+
+static struct os_task rtct_task_read;
+static struct os_task rtct_task_write;
+
+static os_stack_t rtct_stack_read[RTCT_STACK_SIZE];
+static os_stack_t rtct_stack_write[RTCT_STACK_SIZE];
+
+static struct rwlock rtct_rwlock;
+
+static struct os_event rtct_ev_read = {
+    .ev_cb = rtct_evcb_read,
+};
+
+static struct os_event rtct_ev_write = {
+    .ev_cb = rtct_evcb_write,
+};
+
+static void
+rtct_evcb_read(struct os_event *ev)
+{
+    rtct_read_rc = rwlock_acquire_read_timeout(&rtct_rwlock,
+                                               rtct_read_timeout);
+    rtct_reads_done++;
+}
+
+static void
+rtct_evcb_write(struct os_event *ev)
+{
+    rtct_write_rc = rwlock_acquire_write_timeout(&rtct_rwlock,
+                                                 rtct_write_timeout);
+    rtct_writes_done++;
+}
+
+static void
+rtct_read_task_handler(void *arg)
+{
+    while (1) {
+        os_eventq_run(&rtct_evq_read);
+    }
+}
+
+static void
+rtct_write_task_handler(void *arg)
+{
+    while (1) {
+        os_eventq_run(&rtct_evq_write);
+    }
+}
+
+TEST_CASE_TASK(rwlock_test_case_timeout)
+{
+    os_time_t start;
+    int rc;
+
+    os_eventq_init(&rtct_evq_read);
+    os_eventq_init(&rtct_evq_write);
+
+    rc = os_task_init(&rtct_task_read, "read", rtct_read_task_handler, NULL,
+                      RTCT_READ_TASK_PRIO, OS_WAIT_FOREVER, rtct_stack_read,
+                      RTCT_STACK_SIZE);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = os_task_init(&rtct_task_write, "write", rtct_write_task_handler, NULL,
+                      RTCT_WRITE_TASK_PRIO, OS_WAIT_FOREVER, rtct_stack_write,
+                      RTCT_STACK_SIZE);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rwlock_init(&rtct_rwlock);
+
+    /* Readers share the lock; a writer can't get in. */
+    TEST_ASSERT_FATAL(rwlock_try_acquire_read(&rtct_rwlock) == 0);
+    TEST_ASSERT_FATAL(rwlock_try_acquire_read(&rtct_rwlock) == 0);
+    TEST_ASSERT_FATAL(rwlock_try_acquire_write(&rtct_rwlock) == OS_TIMEOUT);
+
+    /* A writer which times out no longer keeps readers out. */
+    start = os_time_get();
+    rc = rwlock_acquire_write_timeout(&rtct_rwlock, 2);
+    TEST_ASSERT_FATAL(rc == OS_TIMEOUT);
+    TEST_ASSERT(OS_TIME_TICK_GEQ(os_time_get(), start + 2));
+    TEST_ASSERT_FATAL(rwlock_try_acquire_read(&rtct_rwlock) == 0);
+
+    rwlock_release_read(&rtct_rwlock);
+    rwlock_release_read(&rtct_rwlock);
+    rwlock_release_read(&rtct_rwlock);
+
+    /*
+     * Hold a read lock while a writer waits with a timeout and a reader
+     * queues behind it.  When the writer gives up, the reader must get the
+     * lock.
+     */
+    TEST_ASSERT_FATAL(rwlock_try_acquire_read(&rtct_rwlock) == 0);
+
+    rtct_write_timeout = 5;
+    os_eventq_put(&rtct_evq_write, &rtct_ev_write);
+    TEST_ASSERT_FATAL(rtct_writes_done == 0);
+
+    rtct_read_timeout = OS_TIMEOUT_NEVER;
+    os_eventq_put(&rtct_evq_read, &rtct_ev_read);
+    TEST_ASSERT_FATAL(rtct_reads_done == 0);
+    TEST_ASSERT_FATAL(rwlock_try_acquire_read(&rtct_rwlock) == OS_TIMEOUT);
+
+    os_time_delay(10);
+    TEST_ASSERT_FATAL(rtct_writes_done == 1);
+    TEST_ASSERT(rtct_write_rc == OS_TIMEOUT);
+    TEST_ASSERT_FATAL(rtct_reads_done == 1);
+    TEST_ASSERT(rtct_read_rc == 0);
+
+    rwlock_release_read(&rtct_rwlock);
+    rwlock_release_read(&rtct_rwlock);
+    TEST_ASSERT_FATAL(rwlock_try_acquire_write(&rtct_rwlock) == 0);
+
+    /* A reader which times out leaves the writer's lock untouched. */
+    rtct_read_timeout = 3;
+    os_eventq_put(&rtct_evq_read, &rtct_ev_read);
+    TEST_ASSERT_FATAL(rtct_reads_done == 1);
+
+    os_time_delay(5);
+    TEST_ASSERT_FATAL(rtct_reads_done == 2);
+    TEST_ASSERT(rtct_read_rc == OS_TIMEOUT);
+    TEST_ASSERT(rwlock_try_acquire_read(&rtct_rwlock) == OS_TIMEOUT);
+
+    rwlock_release_write(&rtct_rwlock);
+    TEST_ASSERT_FATAL(rwlock_try_acquire_read(&rtct_rwlock) == 0);
+    rwlock_release_read(&rtct_rwlock);
+    TEST_ASSERT(rwlock_try_acquire_write(&rtct_rwlock) == 0);
+    rwlock_release_write(&rtct_rwlock);
+}
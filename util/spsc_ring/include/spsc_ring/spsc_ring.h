@@ -0,0 +1,239 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_SPSC_RING_
+#define H_SPSC_RING_
+
+#include <stdint.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPSC_RING_ALIGN     MYNEWT_VAL(SPSC_RING_ALIGN)
+
+/**
+ * @brief Lock-free single-producer single-consumer byte ring.
+ *
+ * Exactly one context writes to the ring and exactly one context reads from
+ * it, typically an interrupt handler and a task.  Neither side disables
+ * interrupts: the producer only ever advances the head and the consumer only
+ * ever advances the tail.  Both are free running counters and the buffer size
+ * is a power of 2, so the number of bytes in the ring is always head - tail.
+ *
+ * Both sides have a zero-copy interface.  spsc_ring_write_reserve() and
+ * spsc_ring_read_reserve() return the longest contiguous region that can be
+ * filled or consumed in place; spsc_ring_write_commit() and
+ * spsc_ring_read_commit() then publish or release a prefix of it.
+ *
+ * All struct fields should be considered private.
+ */
+struct spsc_ring {
+    uint8_t *buf;
+
+    /** Buffer size - 1. */
+    uint32_t mask;
+
+    /** Number of bytes ever written; only modified by the producer. */
+    uint32_t head __attribute__((aligned(SPSC_RING_ALIGN)));
+
+    /** Number of bytes ever read; only modified by the consumer. */
+    uint32_t tail __attribute__((aligned(SPSC_RING_ALIGN)));
+};
+
+static inline uint32_t
+spsc_ring_load(const uint32_t *counter)
+{
+    return __atomic_load_n(counter, __ATOMIC_ACQUIRE);
+}
+
+static inline void
+spsc_ring_store(uint32_t *counter, uint32_t val)
+{
+    __atomic_store_n(counter, val, __ATOMIC_RELEASE);
+}
+
+/**
+ * Initializes a ring.  Must not be called while the ring is in use.
+ *
+ * @param ring                  The ring to initialize.
+ * @param buf                   Storage for the ring data.
+ * @param size                  Size of buf; must be a power of 2.
+ *
+ * @return                      0 on success; SYS_EINVAL if size is not a
+ *                                  power of 2.
+ */
+int spsc_ring_init(struct spsc_ring *ring, void *buf, uint32_t size);
+
+/**
+ * @return                      The number of bytes the ring holds.
+ */
+static inline uint32_t
+spsc_ring_size(const struct spsc_ring *ring)
+{
+    return ring->mask + 1;
+}
+
+/**
+ * Returns the number of bytes available to the consumer.  When called by the
+ * producer the result is an upper bound.
+ *
+ * @param ring                  The ring to query.
+ *
+ * @return                      The number of bytes in the ring.
+ */
+static inline uint32_t
+spsc_ring_len(const struct spsc_ring *ring)
+{
+    return spsc_ring_load(&ring->head) - spsc_ring_load(&ring->tail);
+}
+
+/**
+ * Returns the number of bytes available to the producer.  When called by the
+ * consumer the result is an upper bound.
+ *
+ * @param ring                  The ring to query.
+ *
+ * @return                      The number of free bytes in the ring.
+ */
+static inline uint32_t
+spsc_ring_space(const struct spsc_ring *ring)
+{
+    return spsc_ring_size(ring) - spsc_ring_len(ring);
+}
+
+/**
+ * Producer: returns the contiguous free region following the head.  The
+ * region may be shorter than spsc_ring_space() when it wraps.
+ *
+ * @param ring                  The ring to write to.
+ * @param data                  On success, points to the free region.
+ *
+ * @return                      The length of the free region; 0 if the ring
+ *                                  is full.
+ */
+uint32_t spsc_ring_write_reserve(struct spsc_ring *ring, void **data);
+
+/**
+ * Producer: publishes the first len bytes of the region returned by the last
+ * spsc_ring_write_reserve() call.
+ *
+ * @param ring                  The ring to write to.
+ * @param len                   The number of bytes filled in.
+ */
+void spsc_ring_write_commit(struct spsc_ring *ring, uint32_t len);
+
+/**
+ * Consumer: returns the contiguous region of data following the tail.  The
+ * region may be shorter than spsc_ring_len() when it wraps.
+ *
+ * @param ring                  The ring to read from.
+ * @param data                  On success, points to the data.
+ *
+ * @return                      The length of the data region; 0 if the ring
+ *                                  is empty.
+ */
+uint32_t spsc_ring_read_reserve(struct spsc_ring *ring, void **data);
+
+/**
+ * Consumer: releases the first len bytes of the region returned by the last
+ * spsc_ring_read_reserve() call back to the producer.
+ *
+ * @param ring                  The ring to read from.
+ * @param len                   The number of bytes consumed.
+ */
+void spsc_ring_read_commit(struct spsc_ring *ring, uint32_t len);
+
+/**
+ * Producer: copies as much of the given data into the ring as fits.
+ *
+ * @param ring                  The ring to write to.
+ * @param data                  The data to copy.
+ * @param len                   The number of bytes to copy.
+ *
+ * @return                      The number of bytes copied.
+ */
+uint32_t spsc_ring_write(struct spsc_ring *ring, const void *data,
+                         uint32_t len);
+
+/**
+ * Consumer: copies up to len bytes out of the ring.
+ *
+ * @param ring                  The ring to read from.
+ * @param data                  The buffer to copy into.
+ * @param len                   The size of the buffer.
+ *
+ * @return                      The number of bytes copied.
+ */
+uint32_t spsc_ring_read(struct spsc_ring *ring, void *data, uint32_t len);
+
+/**
+ * Producer: appends a single byte.
+ *
+ * @param ring                  The ring to write to.
+ * @param byte                  The byte to append.
+ *
+ * @return                      0 on success; -1 if the ring is full.
+ */
+static inline int
+spsc_ring_put(struct spsc_ring *ring, uint8_t byte)
+{
+    uint32_t head;
+
+    head = ring->head;
+    if (head - spsc_ring_load(&ring->tail) > ring->mask) {
+        return -1;
+    }
+
+    ring->buf[head & ring->mask] = byte;
+    spsc_ring_store(&ring->head, head + 1);
+
+    return 0;
+}
+
+/**
+ * Consumer: removes a single byte.
+ *
+ * @param ring                  The ring to read from.
+ *
+ * @return                      The byte on success; -1 if the ring is empty.
+ */
+static inline int
+spsc_ring_get(struct spsc_ring *ring)
+{
+    uint32_t tail;
+    uint8_t byte;
+
+    tail = ring->tail;
+    if (spsc_ring_load(&ring->head) == tail) {
+        return -1;
+    }
+
+    byte = ring->buf[tail & ring->mask];
+    spsc_ring_store(&ring->tail, tail + 1);
+
+    return byte;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
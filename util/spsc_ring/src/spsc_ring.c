@@ -0,0 +1,147 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "spsc_ring/spsc_ring.h"
+
+int
+spsc_ring_init(struct spsc_ring *ring, void *buf, uint32_t size)
+{
+    if (size == 0 || (size & (size - 1)) != 0 || size > 0x80000000) {
+        return SYS_EINVAL;
+    }
+
+    ring->buf = buf;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+
+    return 0;
+}
+
+uint32_t
+spsc_ring_write_reserve(struct spsc_ring *ring, void **data)
+{
+    uint32_t head;
+    uint32_t free;
+    uint32_t off;
+
+    head = ring->head;
+    free = spsc_ring_size(ring) - (head - spsc_ring_load(&ring->tail));
+    off = head & ring->mask;
+    if (free > spsc_ring_size(ring) - off) {
+        free = spsc_ring_size(ring) - off;
+    }
+
+    *data = ring->buf + off;
+    return free;
+}
+
+void
+spsc_ring_write_commit(struct spsc_ring *ring, uint32_t len)
+{
+    assert(len <= spsc_ring_space(ring));
+
+    spsc_ring_store(&ring->head, ring->head + len);
+}
+
+uint32_t
+spsc_ring_read_reserve(struct spsc_ring *ring, void **data)
+{
+    uint32_t tail;
+    uint32_t used;
+    uint32_t off;
+
+    tail = ring->tail;
+    used = spsc_ring_load(&ring->head) - tail;
+    off = tail & ring->mask;
+    if (used > spsc_ring_size(ring) - off) {
+        used = spsc_ring_size(ring) - off;
+    }
+
+    *data = ring->buf + off;
+    return used;
+}
+
+void
+spsc_ring_read_commit(struct spsc_ring *ring, uint32_t len)
+{
+    assert(len <= spsc_ring_len(ring));
+
+    spsc_ring_store(&ring->tail, ring->tail + len);
+}
+
+uint32_t
+spsc_ring_write(struct spsc_ring *ring, const void *data, uint32_t len)
+{
+    const uint8_t *src;
+    uint32_t total;
+    uint32_t chunk;
+    void *dst;
+
+    src = data;
+    total = 0;
+
+    /* Fill up to the end of the buffer, then wrap to its start. */
+    while (total < len) {
+        chunk = spsc_ring_write_reserve(ring, &dst);
+        if (chunk == 0) {
+            break;
+        }
+        if (chunk > len - total) {
+            chunk = len - total;
+        }
+
+        memcpy(dst, src + total, chunk);
+        spsc_ring_write_commit(ring, chunk);
+        total += chunk;
+    }
+
+    return total;
+}
+
+uint32_t
+spsc_ring_read(struct spsc_ring *ring, void *data, uint32_t len)
+{
+    uint8_t *dst;
+    uint32_t total;
+    uint32_t chunk;
+    void *src;
+
+    dst = data;
+    total = 0;
+
+    while (total < len) {
+        chunk = spsc_ring_read_reserve(ring, &src);
+        if (chunk == 0) {
+            break;
+        }
+        if (chunk > len - total) {
+            chunk = len - total;
+        }
+
+        memcpy(dst + total, src, chunk);
+        spsc_ring_read_commit(ring, chunk);
+        total += chunk;
+    }
+
+    return total;
+}
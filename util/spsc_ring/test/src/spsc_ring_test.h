@@ -0,0 +1,40 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#ifndef H_SPSC_RING_TEST_
+#define H_SPSC_RING_TEST_
+
+#include <stdio.h>
+#include <string.h>
+#include "os/mynewt.h"
+#include "testutil/testutil.h"
+#include "spsc_ring/spsc_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPSC_RING_TEST_BUF_SIZE     64
+/* Enough bytes to wrap the ring and its uint8_t sequence many times */
+#define SPSC_RING_TEST_STREAM_BYTES (64 * 1024)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
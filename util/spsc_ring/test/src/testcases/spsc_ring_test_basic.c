@@ -0,0 +1,77 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "spsc_ring_test.h"
+
+TEST_CASE(spsc_ring_test_basic)
+{
+    struct spsc_ring ring;
+    uint8_t buf[SPSC_RING_TEST_BUF_SIZE];
+    uint8_t data[SPSC_RING_TEST_BUF_SIZE * 2];
+    uint8_t out[SPSC_RING_TEST_BUF_SIZE * 2];
+    uint32_t wr;
+    uint32_t rd;
+    uint32_t n;
+    int rc;
+    int i;
+
+    /*** Size must be a power of 2. */
+    TEST_ASSERT(spsc_ring_init(&ring, buf, 0) == SYS_EINVAL);
+    TEST_ASSERT(spsc_ring_init(&ring, buf, 48) == SYS_EINVAL);
+    rc = spsc_ring_init(&ring, buf, sizeof buf);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(spsc_ring_size(&ring) == sizeof buf);
+    TEST_ASSERT(spsc_ring_len(&ring) == 0);
+    TEST_ASSERT(spsc_ring_space(&ring) == sizeof buf);
+
+    /*** Single bytes; the whole buffer is usable. */
+    TEST_ASSERT(spsc_ring_get(&ring) == -1);
+    for (i = 0; i < (int)sizeof buf; i++) {
+        TEST_ASSERT(spsc_ring_put(&ring, i) == 0);
+    }
+    TEST_ASSERT(spsc_ring_put(&ring, 0xff) == -1);
+    TEST_ASSERT(spsc_ring_len(&ring) == sizeof buf);
+    TEST_ASSERT(spsc_ring_space(&ring) == 0);
+    for (i = 0; i < (int)sizeof buf; i++) {
+        TEST_ASSERT(spsc_ring_get(&ring) == i);
+    }
+    TEST_ASSERT(spsc_ring_get(&ring) == -1);
+
+    /*** Copies that wrap, with the writer ahead of the reader. */
+    for (i = 0; i < (int)sizeof data; i++) {
+        data[i] = (i % (sizeof data / 2)) * 7;
+    }
+    wr = 0;
+    rd = 0;
+    for (i = 0; i < 200; i++) {
+        n = (i * 13) % (sizeof data / 2) + 1;
+        wr += spsc_ring_write(&ring, data + wr % (sizeof data / 2), n);
+        TEST_ASSERT(spsc_ring_len(&ring) == wr - rd);
+
+        n = spsc_ring_read(&ring, out, (i * 5) % sizeof buf + 1);
+        TEST_ASSERT_FATAL(n <= wr - rd);
+        TEST_ASSERT(memcmp(out, data + rd % (sizeof data / 2), n) == 0);
+        rd += n;
+    }
+
+    /*** A write larger than the free space is truncated. */
+    n = spsc_ring_write(&ring, data, sizeof data);
+    TEST_ASSERT(n == sizeof buf - (wr - rd));
+    TEST_ASSERT(spsc_ring_space(&ring) == 0);
+    TEST_ASSERT(spsc_ring_write(&ring, data, 1) == 0);
+}
@@ -0,0 +1,88 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "spsc_ring_test.h"
+
+/*
+ * Streams a counting byte sequence through a small ring many times over,
+ * mixing single byte and zero-copy calls on both sides.  The consumer must
+ * see every byte, in order, however the calls split the wrap point.
+ */
+TEST_CASE(spsc_ring_test_stream)
+{
+    struct spsc_ring ring;
+    uint8_t buf[SPSC_RING_TEST_BUF_SIZE];
+    uint8_t *data;
+    uint32_t wr;
+    uint32_t rd;
+    uint32_t len;
+    uint32_t n;
+    uint32_t j;
+    int b;
+    int rc;
+    int i;
+
+    rc = spsc_ring_init(&ring, buf, sizeof buf);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    wr = 0;
+    rd = 0;
+    for (i = 0; rd < SPSC_RING_TEST_STREAM_BYTES; i++) {
+        /*** Producer: a few single bytes, then part of the free region. */
+        for (n = i % 5; n > 0; n--) {
+            if (spsc_ring_put(&ring, wr) != 0) {
+                break;
+            }
+            wr++;
+        }
+        len = spsc_ring_write_reserve(&ring, (void **)&data);
+        n = len == 0 ? 0 : (i * 11) % len + 1;
+        for (j = 0; j < n; j++) {
+            data[j] = wr + j;
+        }
+        spsc_ring_write_commit(&ring, n);
+        wr += n;
+        TEST_ASSERT_FATAL(spsc_ring_len(&ring) == wr - rd);
+
+        /*** Consumer: part of the data region, then a few single bytes. */
+        len = spsc_ring_read_reserve(&ring, (void **)&data);
+        n = len == 0 ? 0 : (i * 7) % len + 1;
+        for (j = 0; j < n; j++) {
+            TEST_ASSERT_FATAL(data[j] == (uint8_t)(rd + j));
+        }
+        spsc_ring_read_commit(&ring, n);
+        rd += n;
+        for (n = i % 3; n > 0; n--) {
+            b = spsc_ring_get(&ring);
+            if (b < 0) {
+                break;
+            }
+            TEST_ASSERT_FATAL(b == (uint8_t)rd);
+            rd++;
+        }
+        TEST_ASSERT_FATAL(spsc_ring_len(&ring) == wr - rd);
+    }
+
+    /*** Drain what is left. */
+    while ((b = spsc_ring_get(&ring)) >= 0) {
+        TEST_ASSERT_FATAL(b == (uint8_t)rd);
+        rd++;
+    }
+    TEST_ASSERT(rd == wr);
+    TEST_ASSERT(spsc_ring_space(&ring) == sizeof buf);
+}
@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+#include "spsc_ring_test.h"
+
+TEST_CASE(spsc_ring_test_zero_copy)
+{
+    struct spsc_ring ring;
+    uint8_t buf[SPSC_RING_TEST_BUF_SIZE];
+    uint8_t *data;
+    uint32_t len;
+    int rc;
+    int i;
+
+    rc = spsc_ring_init(&ring, buf, sizeof buf);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /*** An empty ring offers the whole buffer to the producer. */
+    len = spsc_ring_write_reserve(&ring, (void **)&data);
+    TEST_ASSERT(len == sizeof buf);
+    TEST_ASSERT(data == buf);
+    TEST_ASSERT(spsc_ring_read_reserve(&ring, (void **)&data) == 0);
+
+    /*** Nothing is visible to the consumer until it is committed. */
+    memset(buf, 0xaa, 40);
+    TEST_ASSERT(spsc_ring_len(&ring) == 0);
+    spsc_ring_write_commit(&ring, 40);
+    len = spsc_ring_read_reserve(&ring, (void **)&data);
+    TEST_ASSERT(len == 40);
+    TEST_ASSERT(data == buf);
+
+    /*** Partial consumption. */
+    spsc_ring_read_commit(&ring, 30);
+    len = spsc_ring_read_reserve(&ring, (void **)&data);
+    TEST_ASSERT(len == 10);
+    TEST_ASSERT(data == buf + 30);
+
+    /*** The free region stops at the end of the buffer... */
+    len = spsc_ring_write_reserve(&ring, (void **)&data);
+    TEST_ASSERT(len == sizeof buf - 40);
+    TEST_ASSERT(data == buf + 40);
+    for (i = 0; i < (int)len; i++) {
+        data[i] = i;
+    }
+    spsc_ring_write_commit(&ring, len);
+
+    /*** ...and continues at its start, up to the tail. */
+    len = spsc_ring_write_reserve(&ring, (void **)&data);
+    TEST_ASSERT(len == 30);
+    TEST_ASSERT(data == buf);
+    spsc_ring_write_commit(&ring, 5);
+    TEST_ASSERT(spsc_ring_space(&ring) == 25);
+
+    /*** The consumer sees the same split. */
+    len = spsc_ring_read_reserve(&ring, (void **)&data);
+    TEST_ASSERT(len == sizeof buf - 30);
+    TEST_ASSERT(data == buf + 30);
+    spsc_ring_read_commit(&ring, len);
+    len = spsc_ring_read_reserve(&ring, (void **)&data);
+    TEST_ASSERT(len == 5);
+    TEST_ASSERT(data == buf);
+    spsc_ring_read_commit(&ring, len);
+    TEST_ASSERT(spsc_ring_len(&ring) == 0);
+}